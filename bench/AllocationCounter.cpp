@@ -0,0 +1,94 @@
+// Replaces the global allocation functions in the benchmark executable so
+// suites can report how many heap allocations a query performs.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Benchmark.h"
+
+namespace
+{
+
+    // Shared by all threads; only the total matters, so no ordering needed
+    std::atomic<unsigned long> allocations(0);
+
+
+    void*
+    countedAlloc(std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        void* p = std::malloc(size ? size : 1);
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+}
+
+
+void*
+operator new(std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+
+void*
+operator new[](std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void
+operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+
+#ifdef __cpp_sized_deallocation
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#endif
+
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+unsigned long
+allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,220 @@
+#include "Benchmark.h"
+
+#include <cmath>
+
+#include "Rectangle.h"
+#include "Triangle.h"
+#include "Ellipse.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+Random::Random(unsigned long seed)
+:   state_(seed * 2685821657736338717ULL + 0x9E3779B97F4A7C15ULL)
+{
+    if (state_ == 0)
+    {
+        state_ = 0x9E3779B97F4A7C15ULL;
+    }
+}
+
+
+unsigned long
+Random::next()
+{
+    // xorshift64*
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return (unsigned long)((state_ * 2685821657736338717ULL) >> 32);
+}
+
+
+float
+Random::uniform(float lo, float hi)
+{
+    double u = (next() & 0xFFFFFF) / double(0x1000000);
+    return lo + (float)(u * (hi - lo));
+}
+
+
+Timer::Timer()
+{
+    restart();
+}
+
+
+void
+Timer::restart()
+{
+    clock_gettime(CLOCK_MONOTONIC, &start_);
+}
+
+
+double
+Timer::elapsedNs() const
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start_.tv_sec) * 1e9 + (now.tv_nsec - start_.tv_nsec);
+}
+
+
+const char*
+layoutName(SceneLayout layout)
+{
+    switch (layout)
+    {
+    case RandomField:
+        return "random";
+    case DenseCluster:
+        return "dense";
+    case SparseDisjoint:
+        return "sparse";
+    default:
+        return "?";
+    }
+}
+
+
+const char*
+shapeTypeName(Shape::ShapeType type)
+{
+    switch (type)
+    {
+    case Shape::TRectangle:
+        return "Rectangle";
+    case Shape::TTriangle:
+        return "Triangle";
+    case Shape::TEllipse:
+        return "Ellipse";
+    default:
+        return "?";
+    }
+}
+
+
+Shape*
+makeShape(Shape::ShapeType type, const Point2D& center, float size, Random& rnd)
+{
+    float h = size / 2;
+
+    switch (type)
+    {
+    case Shape::TRectangle:
+        {
+            Point2D half(rnd.uniform(0.3f * h, h), rnd.uniform(0.3f * h, h));
+            return new Rectangle(center - half, center + half);
+        }
+    case Shape::TTriangle:
+        return new Triangle(
+            center + Point2D(rnd.uniform(-h, h), rnd.uniform(-h, -0.2f * h)),
+            center + Point2D(rnd.uniform(0.2f * h, h), rnd.uniform(-h, h)),
+            center + Point2D(rnd.uniform(-h, 0.f), rnd.uniform(0.2f * h, h)));
+    case Shape::TEllipse:
+    default:
+        return new Ellipse(
+            center,
+            Point2D(rnd.uniform(0.3f * h, h), rnd.uniform(0.3f * h, h)));
+    }
+}
+
+
+Scene::Scene()
+{}
+
+
+Scene::~Scene()
+{
+    clear();
+}
+
+
+void
+Scene::generate(
+    Shape::ShapeType type,
+    int n,
+    SceneLayout layout,
+    float meanSize,
+    Random& rnd)
+{
+    // Side length of the square the shapes are scattered over
+    float side = 0.f;
+    switch (layout)
+    {
+    case RandomField:
+        side = meanSize * 2.f * std::sqrt((float)n);
+        break;
+    case DenseCluster:
+        side = meanSize;
+        break;
+    case SparseDisjoint:
+        break;
+    }
+
+    // Sparse scenes put every shape into its own grid cell; the cell pitch
+    // leaves a gap even for the largest shape
+    const int cols = 64;
+    const float pitch = 2.f * meanSize;
+
+    for (int i = 0; i != n; ++i)
+    {
+        float size = rnd.uniform(0.5f * meanSize, 1.5f * meanSize);
+        Point2D center;
+
+        if (layout == SparseDisjoint)
+        {
+            int cell = (int)shapes_.size();
+            center = Point2D((cell % cols) * pitch, (cell / cols) * pitch);
+        }
+        else
+        {
+            center = Point2D(rnd.uniform(0.f, side), rnd.uniform(0.f, side));
+        }
+
+        shapes_.push_back(makeShape(type, center, size, rnd));
+    }
+}
+
+
+void
+Scene::generateMixed(int n, SceneLayout layout, float meanSize, Random& rnd)
+{
+    generate(Shape::TRectangle, n / 3, layout, meanSize, rnd);
+    generate(Shape::TTriangle, n / 3, layout, meanSize, rnd);
+    generate(Shape::TEllipse, n - 2 * (n / 3), layout, meanSize, rnd);
+}
+
+
+void
+Scene::clear()
+{
+    for (size_t i = 0; i != shapes_.size(); ++i)
+    {
+        delete shapes_[i];
+    }
+    shapes_.clear();
+}
+
+
+const std::vector<Shape*>&
+Scene::shapes() const
+{
+    return shapes_;
+}
+
+
+Options::Options()
+:   seed(42),
+    repetitions(3),
+    quick(false)
+{}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,158 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <vector>
+#include <string>
+#include <ctime>
+
+#include <Point2D.h>
+#include "Shape.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+/** Number of calls to the global operator new since program start. Counted by
+ *  the replacement operators in AllocationCounter.cpp. */
+unsigned long allocationCount();
+
+
+/** Small xorshift generator so scenes are identical for a given seed on every
+ *  platform (unlike rand()). */
+class Random
+{
+
+public:
+
+    Random(unsigned long seed);
+
+    unsigned long next();
+
+    /// Uniformly distributed in [lo, hi)
+    float uniform(float lo, float hi);
+
+private:
+
+    unsigned long long state_;
+
+};
+
+
+/** Monotonic wall clock stopwatch. */
+class Timer
+{
+
+public:
+
+    Timer();
+
+    void restart();
+
+    /// Nanoseconds elapsed since construction or last restart()
+    double elapsedNs() const;
+
+private:
+
+    timespec start_;
+
+};
+
+
+enum SceneLayout { RandomField, DenseCluster, SparseDisjoint };
+
+
+const char* layoutName(SceneLayout layout);
+
+const char* shapeTypeName(Shape::ShapeType type);
+
+
+/** Owns a set of shapes generated from a seed. */
+class Scene
+{
+
+public:
+
+    Scene();
+
+    ~Scene();
+
+    /// Adds n shapes of the given type; sizes are around meanSize
+    void generate(Shape::ShapeType type,
+                  int n,
+                  SceneLayout layout,
+                  float meanSize,
+                  Random& rnd);
+
+    /// Adds n shapes, about a third of each type
+    void generateMixed(int n, SceneLayout layout, float meanSize, Random& rnd);
+
+    void clear();
+
+    const std::vector<Shape*>& shapes() const;
+
+private:
+
+    Scene(const Scene&);
+
+    Scene& operator=(const Scene&);
+
+private:
+
+    std::vector<Shape*> shapes_;
+
+};
+
+
+Shape* makeShape(Shape::ShapeType type,
+                 const Point2D& center,
+                 float size,
+                 Random& rnd);
+
+
+struct Options
+{
+    Options();
+
+    unsigned long seed;
+
+    int repetitions;
+
+    bool quick;
+};
+
+
+/** A benchmark suite entry point; returns 0 on success. */
+typedef int (*SuiteFunc)(const Options& opts);
+
+
+int runIntersectionSuite(const Options& opts);
+
+int runQueryModeSuite(const Options& opts);
+
+int runBroadPhaseSuite(const Options& opts);
+
+int runParallelSuite(const Options& opts);
+
+int runPointBufferSuite(const Options& opts);
+
+int runSegmentBufferSuite(const Options& opts);
+
+int runSegmentSweepSuite(const Options& opts);
+
+int runSegmentedShapeSuite(const Options& opts);
+
+int runShapeClipperSuite(const Options& opts);
+
+int runShapeDispatchSuite(const Options& opts);
+
+int runPrecisionSuite(const Options& opts);
+
+
+} // namespace bench
+
+} // namespace geom
+
+#endif // BENCHMARK_H_
@@ -0,0 +1,282 @@
+// Broad-phase structures against brute-force pairwise intersection on mixed
+// scenes of many shapes.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "AABBTree.h"
+#include "ShapeGrid.h"
+#include "SweepAndPrune.h"
+#include "SegmentPointVector.h"
+#include "GeometryExceptions.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    /// Moves every stride-th shape by a small random step, as a simulation
+    /// frame would
+    void
+    jitter(const std::vector<Shape*>& shapes, float step, Random& rnd,
+           size_t stride = 1)
+    {
+        for (size_t i = 0; i < shapes.size(); i += stride)
+        {
+            shapes[i]->moveBy(
+                Point2D(rnd.uniform(-step, step), rnd.uniform(-step, step)));
+        }
+    }
+
+
+    /// Shape::isIntersectedBy() which counts a numerical failure of the
+    /// narrow phase as "not intersecting" instead of aborting the whole run
+    bool
+    narrowPhase(const Shape* a, const Shape* b, SegmentPointVector& isecPoints)
+    {
+        int count = 0;
+        try
+        {
+            return a->isIntersectedBy(b, isecPoints, count);
+        }
+        catch (const error::GeometryError&)
+        {
+            return false;
+        }
+    }
+
+
+    /// Returns the number of intersecting pairs
+    int
+    narrowPhase(const std::vector<ShapePair>& candidates,
+                SegmentPointVector& isecPoints)
+    {
+        int numIntersecting = 0;
+
+        for (size_t i = 0; i != candidates.size(); ++i)
+        {
+            if (narrowPhase(candidates[i].first, candidates[i].second, isecPoints))
+            {
+                ++numIntersecting;
+            }
+        }
+
+        return numIntersecting;
+    }
+
+
+    /// Returns the number of intersecting pairs
+    int
+    bruteForce(const std::vector<Shape*>& shapes, SegmentPointVector& isecPoints)
+    {
+        int numIntersecting = 0;
+
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            for (size_t j = i + 1; j != shapes.size(); ++j)
+            {
+                if (narrowPhase(shapes[i], shapes[j], isecPoints))
+                {
+                    ++numIntersecting;
+                }
+            }
+        }
+
+        return numIntersecting;
+    }
+
+
+    void
+    printRow(const char* method, int n, double ms, size_t candidates,
+             int intersecting, double updateMs)
+    {
+        std::printf("%-10s %7d %12.2f %12lu %12d %12.2f\n",
+                    method, n, ms, (unsigned long)candidates, intersecting,
+                    updateMs);
+    }
+
+
+    /// Times pair search plus narrow phase on a freshly generated scene, then
+    /// the refit after moving every shape. Returns the number of intersecting
+    /// pairs found.
+    template <class BroadPhase>
+    int
+    runBroadPhase(const char* name, int n, const Options& opts)
+    {
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generateMixed(n, RandomField, 10.f, rnd);
+        const std::vector<Shape*>& shapes = scene.shapes();
+
+        BroadPhase broadPhase;
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            broadPhase.insert(shapes[i]);
+        }
+
+        std::vector<ShapePair> candidates;
+        SegmentPointVector isecPoints;
+
+        Timer timer;
+        broadPhase.findPairs(candidates);
+        int found = narrowPhase(candidates, isecPoints);
+        double ms = timer.elapsedNs() * 1e-6;
+
+        Random moveRnd(opts.seed + 1);
+        jitter(shapes, 0.5f, moveRnd);
+        timer.restart();
+        broadPhase.update();
+        double updateMs = timer.elapsedNs() * 1e-6;
+
+        printRow(name, n, ms, candidates.size(), found, updateMs);
+
+        return found;
+    }
+
+
+    /// Times update() and findPairs() per frame over several frames of
+    /// small motion of every stride-th shape, where the pair set changes
+    /// only a little between frames. Returns the number of candidate pairs
+    /// in the last frame.
+    template <class BroadPhase>
+    size_t
+    runFrames(const char* name, int n, int numFrames, size_t stride,
+              const Options& opts)
+    {
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generateMixed(n, RandomField, 10.f, rnd);
+        const std::vector<Shape*>& shapes = scene.shapes();
+
+        BroadPhase broadPhase;
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            broadPhase.insert(shapes[i]);
+        }
+
+        std::vector<ShapePair> candidates;
+        broadPhase.findPairs(candidates);
+
+        Random moveRnd(opts.seed + 1);
+        double updateNs = 0.;
+        double searchNs = 0.;
+        for (int f = 0; f != numFrames; ++f)
+        {
+            jitter(shapes, 0.05f, moveRnd, stride);
+            candidates.clear();
+
+            Timer timer;
+            broadPhase.update();
+            updateNs += timer.elapsedNs();
+
+            timer.restart();
+            broadPhase.findPairs(candidates);
+            searchNs += timer.elapsedNs();
+        }
+
+        std::printf("%-10s %7d %8.1f%% %12.3f %12.3f %12lu\n", name, n,
+                    100. / stride, updateNs * 1e-6 / numFrames,
+                    searchNs * 1e-6 / numFrames, (unsigned long)candidates.size());
+
+        return candidates.size();
+    }
+
+}
+
+
+int
+runBroadPhaseSuite(const Options& opts)
+{
+    const int sizes[] = { 1000, 4000, 16000, 64000 };
+    const int numSizes = opts.quick ? 2 : 4;
+    const int maxBruteForce = 8000;
+    int ret = 0;
+
+    std::printf("# All intersecting pairs in a random field of mixed shapes, "
+                "seed %lu\n", opts.seed);
+    std::printf("# total = pair search + narrow phase, update = refit after "
+                "moving every shape\n");
+    std::printf("%-10s %7s %12s %12s %12s %12s\n",
+                "method", "n", "total ms", "candidates", "intersecting",
+                "update ms");
+
+    for (int s = 0; s != numSizes; ++s)
+    {
+        const int n = sizes[s];
+        int expected = -1;
+
+        if (n <= maxBruteForce)
+        {
+            Random rnd(opts.seed);
+            Scene scene;
+            scene.generateMixed(n, RandomField, 10.f, rnd);
+            SegmentPointVector isecPoints;
+
+            Timer timer;
+            expected = bruteForce(scene.shapes(), isecPoints);
+            printRow("brute", n, timer.elapsedNs() * 1e-6,
+                     (size_t)n * (n - 1) / 2, expected, 0.);
+        }
+
+        int found[3];
+        found[0] = runBroadPhase<AABBTree>("aabbtree", n, opts);
+        found[1] = runBroadPhase<ShapeGrid>("grid", n, opts);
+        found[2] = runBroadPhase<SweepAndPrune>("sap", n, opts);
+
+        for (int m = 0; m != 3; ++m)
+        {
+            if ((expected >= 0 && found[m] != expected) || found[m] != found[0])
+            {
+                std::printf("! broad-phase results differ\n");
+                ret = 1;
+            }
+        }
+    }
+
+    const int numFrames = opts.quick ? 5 : 20;
+
+    // All shapes moving, and one in twenty (where the unchanged shapes are
+    // skipped by their generation)
+    const size_t strides[] = { 1, 20 };
+
+    std::printf("\n# Frame to frame: update and pair search after moving a "
+                "share of the shapes a little, mean of %d frames\n", numFrames);
+    std::printf("%-10s %7s %9s %12s %12s %12s\n",
+                "method", "n", "moving", "update ms", "search ms", "candidates");
+
+    for (int m = 0; m != 2; ++m)
+    {
+        for (int s = 0; s != numSizes; ++s)
+        {
+            const int n = sizes[s];
+            const size_t stride = strides[m];
+
+            // The tree pads its boxes, so only grid and sweep-and-prune
+            // report the same candidates
+            runFrames<AABBTree>("aabbtree", n, numFrames, stride, opts);
+            size_t gridPairs =
+                runFrames<ShapeGrid>("grid", n, numFrames, stride, opts);
+            size_t sapPairs =
+                runFrames<SweepAndPrune>("sap", n, numFrames, stride, opts);
+
+            if (gridPairs != sapPairs)
+            {
+                std::printf("! broad-phase results differ\n");
+                ret = 1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
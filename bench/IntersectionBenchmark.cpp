@@ -0,0 +1,304 @@
+// Pairwise Shape::isIntersectedBy() throughput for all (A, B) type
+// combinations on seeded scenes of growing size, and a comparison with the
+// point-less Shape::countIntersections() and Shape::intersects() queries.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "SegmentPointVector.h"
+#include "GeometryExceptions.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    struct Result
+    {
+        double ns;
+        unsigned long queries;
+        unsigned long isecPoints;
+        unsigned long allocations;
+        unsigned long errors;
+    };
+
+
+    /// Runs every a->isIntersectedBy(b) query once
+    void
+    runAllPairs(
+        const std::vector<Shape*>& shapes,
+        int n,
+        SegmentPointVector& isecPoints,
+        Result& res)
+    {
+        res.queries = 0;
+        res.isecPoints = 0;
+        res.errors = 0;
+
+        for (int i = 0; i != n; ++i)
+        {
+            const Shape* a = shapes[i];
+            for (int j = n; j != 2 * n; ++j)
+            {
+                int count = 0;
+                try
+                {
+                    a->isIntersectedBy(shapes[j], isecPoints, count);
+                }
+                catch (const error::GeometryError&)
+                {
+                    ++res.errors;
+                }
+                res.isecPoints += isecPoints.size();
+                isecPoints.clear();
+                ++res.queries;
+            }
+        }
+    }
+
+
+    void
+    benchmarkPair(
+        Shape::ShapeType typeA,
+        Shape::ShapeType typeB,
+        SceneLayout layout,
+        int n,
+        const Options& opts)
+    {
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generate(typeA, n, layout, 10.f, rnd);
+        scene.generate(typeB, n, layout, 10.f, rnd);
+
+        const std::vector<Shape*>& shapes = scene.shapes();
+        SegmentPointVector isecPoints;
+
+        // Warm-up pass: cleans all lazily computed shape data and lets the
+        // result vector reach its steady state capacity
+        Result res;
+        runAllPairs(shapes, n, isecPoints, res);
+
+        double best = 0.;
+        unsigned long allocs = 0;
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            unsigned long allocsBefore = allocationCount();
+            Timer timer;
+            runAllPairs(shapes, n, isecPoints, res);
+            double ns = timer.elapsedNs();
+            allocs = allocationCount() - allocsBefore;
+            if (r == 0 || ns < best)
+            {
+                best = ns;
+            }
+        }
+
+        std::printf("%-7s %-9s %-9s %6d %9lu %10.1f %12.0f %10.3f %6lu\n",
+                    layoutName(layout),
+                    shapeTypeName(typeA),
+                    shapeTypeName(typeB),
+                    n,
+                    res.queries,
+                    best / res.queries,
+                    res.isecPoints / (best * 1e-9),
+                    (double)allocs / res.queries,
+                    res.errors);
+    }
+
+
+    enum QueryMode { Points, Count, Bool };
+
+
+    /// Time per a->X(b) query over all A x B pairs for the given query mode
+    double
+    timeQueryMode(const std::vector<Shape*>& shapes, int n, QueryMode mode)
+    {
+        SegmentPointVector isecPoints;
+        unsigned long hits = 0;
+
+        Timer timer;
+        for (int i = 0; i != n; ++i)
+        {
+            const Shape* a = shapes[i];
+            for (int j = n; j != 2 * n; ++j)
+            {
+                int count = 0;
+                try
+                {
+                    switch (mode)
+                    {
+                    case Points:
+                        a->isIntersectedBy(shapes[j], isecPoints, count);
+                        isecPoints.clear();
+                        break;
+                    case Count:
+                        count = a->countIntersections(shapes[j]);
+                        break;
+                    case Bool:
+                        count = a->intersects(shapes[j]);
+                        break;
+                    }
+                }
+                catch (const error::GeometryError&)
+                {
+                }
+                hits += count;
+            }
+        }
+        double ns = timer.elapsedNs();
+
+        // Keep the compiler from dropping the queries
+        if (hits == (unsigned long)-1)
+        {
+            std::printf("!");
+        }
+
+        return ns / ((double)n * n);
+    }
+
+
+    /// Runs all three query modes on every A x B pair; counts the pairs where
+    /// the count differs from the number of points, or the boolean from
+    /// count > 0, and the pairs whose points query fails
+    void
+    checkQueryModes(const std::vector<Shape*>& shapes, int n,
+                    unsigned long& mismatches, unsigned long& errors)
+    {
+        SegmentPointVector isecPoints;
+        mismatches = 0;
+        errors = 0;
+
+        for (int i = 0; i != n; ++i)
+        {
+            const Shape* a = shapes[i];
+            for (int j = n; j != 2 * n; ++j)
+            {
+                int count = 0;
+                isecPoints.clear();
+                try
+                {
+                    a->isIntersectedBy(shapes[j], isecPoints, count);
+                }
+                catch (const error::GeometryError&)
+                {
+                    ++errors;
+                    continue;
+                }
+
+                int counted = a->countIntersections(shapes[j]);
+                bool touching = a->intersects(shapes[j]);
+                if (counted != (int)isecPoints.size()
+                    || touching != (counted > 0))
+                {
+                    ++mismatches;
+                }
+            }
+        }
+    }
+
+}
+
+
+int
+runQueryModeSuite(const Options& opts)
+{
+    const Shape::ShapeType types[] =
+        { Shape::TRectangle, Shape::TTriangle, Shape::TEllipse };
+    const SceneLayout layouts[] = { RandomField, DenseCluster };
+    const int n = opts.quick ? 64 : 256;
+
+    std::printf("# ns/query: isIntersectedBy vs countIntersections vs "
+                "intersects, n = %d, seed %lu\n", n, opts.seed);
+    std::printf("%-7s %-9s %-9s %10s %10s %10s %6s %5s\n",
+                "scene", "A", "B", "points", "count", "bool", "errors",
+                "same");
+    int ret = 0;
+
+    for (int l = 0; l != 2; ++l)
+    {
+        for (int a = 0; a != 3; ++a)
+        {
+            for (int b = 0; b != 3; ++b)
+            {
+                Random rnd(opts.seed);
+                Scene scene;
+                scene.generate(types[a], n, layouts[l], 10.f, rnd);
+                scene.generate(types[b], n, layouts[l], 10.f, rnd);
+
+                double best[3] = { 0., 0., 0. };
+                for (int r = 0; r != opts.repetitions; ++r)
+                {
+                    for (int m = 0; m != 3; ++m)
+                    {
+                        double ns = timeQueryMode(
+                            scene.shapes(), n, (QueryMode)m);
+                        if (r == 0 || ns < best[m])
+                        {
+                            best[m] = ns;
+                        }
+                    }
+                }
+
+                unsigned long mismatches, errors;
+                checkQueryModes(scene.shapes(), n, mismatches, errors);
+
+                std::printf("%-7s %-9s %-9s %10.1f %10.1f %10.1f %6lu %5s\n",
+                            layoutName(layouts[l]),
+                            shapeTypeName(types[a]),
+                            shapeTypeName(types[b]),
+                            best[0], best[1], best[2], errors,
+                            mismatches ? "NO" : "yes");
+                if (mismatches)
+                {
+                    ret = 1;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+int
+runIntersectionSuite(const Options& opts)
+{
+    const Shape::ShapeType types[] =
+        { Shape::TRectangle, Shape::TTriangle, Shape::TEllipse };
+    const SceneLayout layouts[] = { RandomField, DenseCluster, SparseDisjoint };
+    const int sizes[] = { 32, 64, 128, 256 };
+    const int numSizes = opts.quick ? 2 : 4;
+
+    std::printf("# Shape::isIntersectedBy, all A x B pairs, seed %lu\n",
+                opts.seed);
+    std::printf("%-7s %-9s %-9s %6s %9s %10s %12s %10s %6s\n",
+                "scene", "A", "B", "n", "queries", "ns/query", "isec/s",
+                "allocs/q", "errors");
+
+    for (int l = 0; l != 3; ++l)
+    {
+        for (int a = 0; a != 3; ++a)
+        {
+            for (int b = 0; b != 3; ++b)
+            {
+                for (int s = 0; s != numSizes; ++s)
+                {
+                    benchmarkPair(types[a], types[b], layouts[l], sizes[s], opts);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+} // namespace bench
+
+} // namespace geom
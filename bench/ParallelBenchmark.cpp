@@ -0,0 +1,189 @@
+// IntersectionEngine scaling over the number of threads, on a broad-phase
+// fed field of many shapes and on all pairs of a dense cluster. Every run is
+// checked against the single-threaded result, which it must match exactly.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <thread>
+
+#include "IntersectionEngine.h"
+#include "ShapeGrid.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    struct Result
+    {
+        std::vector<ShapePair> pairs;
+
+        SegmentPointVector points;
+
+        int failed;
+
+        double ms;
+    };
+
+
+    bool
+    sameResult(const Result& a, const Result& b)
+    {
+        if (a.pairs.size() != b.pairs.size() || a.points.size() != b.points.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i != a.pairs.size(); ++i)
+        {
+            if (a.pairs[i].first != b.pairs[i].first
+                || a.pairs[i].second != b.pairs[i].second)
+            {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i != a.points.size(); ++i)
+        {
+            if (a.points[i].p.x != b.points[i].p.x || a.points[i].p.y != b.points[i].p.y
+                || a.points[i].parent != b.points[i].parent)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    /// Best of opts.repetitions runs after an untimed one, which absorbs the
+    /// lazy cleaning of shapes and grid; source 0 means all pairs
+    void
+    run(int numThreads, const std::vector<const Shape*>& shapes,
+        const CandidatePairSource* source, const Options& opts, Result& result)
+    {
+        IntersectionEngine engine(numThreads);
+        engine.skipFailedPairs(true);
+        result.ms = 0.;
+
+        for (int r = -1; r != opts.repetitions; ++r)
+        {
+            result.pairs.clear();
+            result.points.clear();
+
+            Timer timer;
+            if (source)
+            {
+                engine.findIntersections(shapes, *source, result.pairs, result.points);
+            }
+            else
+            {
+                engine.findIntersections(shapes, result.pairs, result.points);
+            }
+            double ms = timer.elapsedNs() * 1e-6;
+
+            if (r == 0 || (r > 0 && ms < result.ms))
+            {
+                result.ms = ms;
+            }
+        }
+
+        result.failed = engine.numFailedPairs();
+    }
+
+
+    int
+    runScene(const char* name, const std::vector<const Shape*>& shapes,
+             const CandidatePairSource* source, int maxThreads,
+             const Options& opts)
+    {
+        int ret = 0;
+        Result base;
+        run(1, shapes, source, opts, base);
+
+        for (int t = 1; t <= maxThreads; t *= 2)
+        {
+            Result result;
+            if (t == 1)
+            {
+                result = base;
+            }
+            else
+            {
+                run(t, shapes, source, opts, result);
+            }
+
+            bool same = sameResult(base, result) && base.failed == result.failed;
+            std::printf("%-12s %7d %8d %12.2f %8.2f %12lu %8d %5s\n",
+                        name, (int)shapes.size(), t, result.ms,
+                        base.ms / result.ms, (unsigned long)result.pairs.size(),
+                        result.failed, same ? "yes" : "NO");
+
+            if (!same)
+            {
+                ret = 1;
+            }
+        }
+
+        return ret;
+    }
+
+}
+
+
+int
+runParallelSuite(const Options& opts)
+{
+    const int hardwareThreads = (int)std::thread::hardware_concurrency();
+    // Always check a few thread counts for determinism, even on small machines
+    const int maxThreads = hardwareThreads > 4 ? hardwareThreads : 4;
+    int ret = 0;
+
+    std::printf("# IntersectionEngine, %d hardware threads, seed %lu, best of "
+                "%d\n", hardwareThreads, opts.seed, opts.repetitions);
+    std::printf("%-12s %7s %8s %12s %8s %12s %8s %5s\n",
+                "scene", "n", "threads", "ms", "speedup", "intersecting",
+                "failed", "same");
+
+    {
+        const int n = opts.quick ? 16000 : 64000;
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generateMixed(n, RandomField, 10.f, rnd);
+        std::vector<const Shape*> shapes(
+            scene.shapes().begin(), scene.shapes().end());
+
+        ShapeGrid grid;
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            grid.insert(shapes[i]);
+        }
+
+        ret |= runScene("field+grid", shapes, &grid, maxThreads, opts);
+    }
+
+    {
+        const int n = opts.quick ? 500 : 2000;
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generateMixed(n, DenseCluster, 10.f, rnd);
+        std::vector<const Shape*> shapes(
+            scene.shapes().begin(), scene.shapes().end());
+
+        ret |= runScene("dense/all", shapes, 0, maxThreads, opts);
+    }
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
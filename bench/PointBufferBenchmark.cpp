@@ -0,0 +1,233 @@
+// Bulk point operations on a std::vector<Point2D> through the Point2D
+// operators (array of structures) against PointBuffer (structure of arrays)
+// with each SIMD kernel the CPU supports. Every kernel must reproduce the
+// results of the Point2D path exactly.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "AABox.h"
+#include "PointBuffer.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    const Point2D delta(0.5f, -0.25f);
+
+    const Point2D ellipseCenter(10.f, -20.f);
+
+    const Point2D ellipseRadius(300.f, 200.f);
+
+
+    struct Results
+    {
+        std::vector<Point2D> moved;
+
+        AABox bounds;
+
+        std::vector<float> distances;
+
+        size_t inEllipse;
+
+        // Best times in ns per point
+        double translateNs, boundsNs, distancesNs, ellipseNs;
+    };
+
+
+    bool
+    sameResults(const Results& a, const Results& b)
+    {
+        return a.moved.size() == b.moved.size()
+            && !std::memcmp(&a.moved[0], &b.moved[0],
+                            a.moved.size() * sizeof(Point2D))
+            && !std::memcmp(&a.bounds, &b.bounds, sizeof(AABox))
+            && !std::memcmp(&a.distances[0], &b.distances[0],
+                            a.distances.size() * sizeof(float))
+            && a.inEllipse == b.inEllipse;
+    }
+
+
+    /// Keeps the best time of reps runs of f, in ns per point
+    template <class Func>
+    void
+    bestOf(int reps, size_t n, double& best, Func f)
+    {
+        for (int r = 0; r != reps; ++r)
+        {
+            Timer timer;
+            f();
+            double ns = timer.elapsedNs() / n;
+            if (r == 0 || ns < best)
+            {
+                best = ns;
+            }
+        }
+    }
+
+
+    void
+    runPoint2D(const std::vector<Point2D>& points, int reps, Results& res)
+    {
+        const size_t n = points.size();
+        std::vector<Point2D> p(points);
+
+        bestOf(reps, n, res.translateNs, [&]()
+        {
+            for (size_t i = 0; i != n; ++i)
+            {
+                p[i] += delta;
+            }
+        });
+        res.moved = p;
+
+        bestOf(reps, n, res.boundsNs, [&]()
+        {
+            Point2D lo = p[0];
+            Point2D hi = p[0];
+            for (size_t i = 1; i != n; ++i)
+            {
+                lo = min(lo, p[i]);
+                hi = max(hi, p[i]);
+            }
+            res.bounds = AABox::fromCorners(lo, hi);
+        });
+
+        res.distances.resize(n);
+        bestOf(reps, n, res.distancesNs, [&]()
+        {
+            for (size_t i = 0; i != n; ++i)
+            {
+                res.distances[i] = dist(p[i], ellipseCenter);
+            }
+        });
+
+        bestOf(reps, n, res.ellipseNs, [&]()
+        {
+            // As in Ellipse::containsPoint()
+            size_t count = 0;
+            for (size_t i = 0; i != n; ++i)
+            {
+                Point2D p0 = p[i] - ellipseCenter;
+                p0 = (p0 * p0) / (ellipseRadius * ellipseRadius);
+                if ((p0.x + p0.y) <= 1.f)
+                {
+                    ++count;
+                }
+            }
+            res.inEllipse = count;
+        });
+    }
+
+
+    void
+    runPointBuffer(const std::vector<Point2D>& points, int reps, Results& res)
+    {
+        const size_t n = points.size();
+        PointBuffer buf(&points[0], n);
+
+        bestOf(reps, n, res.translateNs, [&]() { buf.translate(delta); });
+        res.moved.resize(n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            res.moved[i] = buf[i];
+        }
+
+        bestOf(reps, n, res.boundsNs, [&]() { res.bounds = buf.bounds(); });
+
+        res.distances.resize(n);
+        bestOf(reps, n, res.distancesNs, [&]()
+        {
+            buf.distances(ellipseCenter, &res.distances[0]);
+        });
+
+        bestOf(reps, n, res.ellipseNs, [&]()
+        {
+            res.inEllipse = buf.countInEllipse(ellipseCenter, ellipseRadius);
+        });
+    }
+
+
+    void
+    printRow(const char* method, const Results& res, const Results& base,
+             bool same)
+    {
+        std::printf("%-10s %10.3f %10.3f %10.3f %10.3f %8.2f %5s\n", method,
+                    res.translateNs, res.boundsNs, res.distancesNs,
+                    res.ellipseNs,
+                    (base.translateNs + base.boundsNs + base.distancesNs
+                     + base.ellipseNs)
+                    / (res.translateNs + res.boundsNs + res.distancesNs
+                       + res.ellipseNs),
+                    same ? "yes" : "NO");
+    }
+
+}
+
+
+int
+runPointBufferSuite(const Options& opts)
+{
+    const size_t n = opts.quick ? 100000 : 1000000;
+    int ret = 0;
+
+    Random rnd(opts.seed);
+    std::vector<Point2D> points(n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        points[i] = Point2D(rnd.uniform(-500.f, 500.f),
+                            rnd.uniform(-500.f, 500.f));
+    }
+
+    std::printf("# Bulk operations on %lu random points, seed %lu, best of "
+                "%d, ns per point\n", (unsigned long)n, opts.seed,
+                opts.repetitions);
+    std::printf("%-10s %10s %10s %10s %10s %8s %5s\n", "method", "translate",
+                "bounds", "distance", "ellipse", "speedup", "same");
+
+    Results base;
+    runPoint2D(points, opts.repetitions, base);
+    printRow("Point2D", base, base, true);
+
+    const PointBuffer::Kernel defaultKernel = PointBuffer::kernel();
+    const PointBuffer::Kernel kernels[] = {
+        PointBuffer::ScalarKernel, PointBuffer::SSE2Kernel,
+        PointBuffer::AVX2Kernel };
+
+    for (int k = 0; k != 3; ++k)
+    {
+        if (!PointBuffer::setKernel(kernels[k]))
+        {
+            std::printf("%-10s (not supported)\n",
+                        PointBuffer::kernelName(kernels[k]));
+            continue;
+        }
+
+        Results res;
+        runPointBuffer(points, opts.repetitions, res);
+        bool same = sameResults(base, res);
+        printRow(PointBuffer::kernelName(kernels[k]), res, base, same);
+
+        if (!same)
+        {
+            ret = 1;
+        }
+    }
+
+    PointBuffer::setKernel(defaultKernel);
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
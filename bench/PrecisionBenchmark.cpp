@@ -0,0 +1,529 @@
+// Intersections far from the origin, with the float and the double
+// instantiation of the primitives: lines through an ellipse, and circles
+// through each other, both at two points known in advance. The same for the
+// shapes: a rectangle across an ellipse through Shape::isIntersectedBy(), the
+// circles all at once through IntersectionEngine over an AABBTree, and the
+// area the circles have in common by ShapeClipper. The scenes are the same at
+// every offset but moved away from the origin by it; the cases of the engine
+// are spread over some 1e4 around it, so float loses some there from the
+// start. Float is expected to lose the points at some offset; double must
+// find all of them at every offset, to within a fraction of the tolerance of
+// float.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "AABBTree.h"
+#include "Ellipse.h"
+#include "GenericEllipse.h"
+#include "GenericLine.h"
+#include "GeometryExceptions.h"
+#include "IntersectionEngine.h"
+#include "Rectangle.h"
+#include "ShapeClipper.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    const double pi = std::atan(1.) * 4.;
+
+    /// Largest error of a point found, relative to the radius of the
+    /// ellipse, to count as correct; for Clip, of the common area, relative
+    /// to that of the smaller circle
+    const double maxRelativeError = 1e-5;
+
+    /// Distance of the cases of Engine from each other, along both axes;
+    /// further than any two of their shapes reach
+    const double caseSpacing = 250.;
+
+
+    /// Engine and Clip take the circles of CircleCircle
+    enum Query { LineEllipse, CircleCircle, RectEllipse, Engine, Clip };
+
+
+    /// An ellipse and, for LineEllipse, a line crossing it at p1 and p2, for
+    /// RectEllipse, the rectangle from low to high with its lower edge
+    /// crossing it there, or, for the others, a second circle through them;
+    /// in double, relative to the offset
+    struct Case
+    {
+        BasicPoint2D<double> center, radius, p1, p2, other, low, high;
+
+        double otherRadius;
+    };
+
+
+    /// Points p1 and p2 on the ellipse at least a sixth of a turn apart, or
+    /// at the same height for RectEllipse
+    void
+    makeCase(Query query, Random& rnd, Case& c)
+    {
+        c.center = BasicPoint2D<double>(rnd.uniform(-100.f, 100.f),
+                                        rnd.uniform(-100.f, 100.f));
+        double r = rnd.uniform(1.f, 10.f);
+        c.radius = query == LineEllipse || query == RectEllipse
+            ? BasicPoint2D<double>(r, rnd.uniform(1.f, 10.f))
+            : BasicPoint2D<double>(r, r);
+
+        if (query == RectEllipse)
+        {
+            // The other edges are well outside the ellipse
+            double h = c.radius.y * rnd.uniform(-0.8f, 0.8f);
+            double w = c.radius.x * std::sqrt(1. - h * h
+                                              / (c.radius.y * c.radius.y));
+            c.p1 = c.center + BasicPoint2D<double>(-w, h);
+            c.p2 = c.center + BasicPoint2D<double>(w, h);
+            c.low = c.center + BasicPoint2D<double>(-2. * c.radius.x, h);
+            c.high = c.center + c.radius * 2.;
+            return;
+        }
+
+        double a1 = rnd.uniform(0.f, 2.f * pi);
+        double a2 = a1 + rnd.uniform(pi / 3., 5. * pi / 3.);
+        c.p1 = c.center + BasicPoint2D<double>(c.radius.x * std::cos(a1),
+                                               c.radius.y * std::sin(a1));
+        c.p2 = c.center + BasicPoint2D<double>(c.radius.x * std::cos(a2),
+                                               c.radius.y * std::sin(a2));
+
+        // The second circle has its center on the bisector of p1 and p2
+        BasicPoint2D<double> mid = (c.p1 + c.p2) * 0.5;
+        BasicPoint2D<double> normal(c.p1.y - c.p2.y, c.p2.x - c.p1.x);
+        c.other = mid + normal * (double)rnd.uniform(-1.f, 1.f);
+        BasicPoint2D<double> toP1 = c.p1 - c.other;
+        c.otherRadius = std::sqrt(toP1.x * toP1.x + toP1.y * toP1.y);
+    }
+
+
+    /// Moves case i of n to its place in a square grid around the origin,
+    /// caseSpacing apart
+    void
+    placeCase(size_t i, size_t n, Case& c)
+    {
+        const int columns = (int)std::ceil(std::sqrt((double)n));
+        BasicPoint2D<double> d((int)(i % columns) - columns / 2,
+                               (int)(i / columns) - columns / 2);
+        d = d * caseSpacing;
+        c.center = c.center + d;
+        c.p1 = c.p1 + d;
+        c.p2 = c.p2 + d;
+        c.other = c.other + d;
+    }
+
+
+    /// The case placeCase() has put where p is, relative to the offset; n if
+    /// none
+    size_t
+    caseAt(double x, double y, size_t n)
+    {
+        const int columns = (int)std::ceil(std::sqrt((double)n));
+        double column = std::floor(x / caseSpacing + 0.5) + columns / 2;
+        double row = std::floor(y / caseSpacing + 0.5) + columns / 2;
+        if (!(column >= 0. && column < columns && row >= 0. && row < columns))
+        {
+            return n;
+        }
+        return std::min((size_t)(row * columns + column), n);
+    }
+
+
+    /// The area the two circles of c have in common
+    double
+    lensArea(const Case& c)
+    {
+        double r = c.radius.x;
+        double s = c.otherRadius;
+        BasicPoint2D<double> v = c.other - c.center;
+        double d = std::sqrt(v.x * v.x + v.y * v.y);
+        double kite = std::sqrt((-d + r + s) * (d + r - s) * (d - r + s)
+                                * (d + r + s));
+        return r * r * std::acos((d * d + r * r - s * s) / (2. * d * r))
+            + s * s * std::acos((d * d + s * s - r * r) / (2. * d * s))
+            - 0.5 * kite;
+    }
+
+
+    template <typename T>
+    BasicPoint2D<T>
+    at(const BasicPoint2D<double>& p, double offset)
+    {
+        return BasicPoint2D<T>(T(p.x + offset), T(p.y + offset));
+    }
+
+
+    struct Result
+    {
+        int correct;
+
+        int failed;
+
+        double maxError;
+
+        double ns;
+    };
+
+
+    /// Distance of p, given relative to offset, to the nearest point found
+    template <typename T>
+    double
+    distanceToFound(const BasicPoint2D<double>& p,
+                    double offset,
+                    const BasicSegmentPointVector<T>& found)
+    {
+        double best = HUGE_VAL;
+        for (size_t i = 0; i != found.size(); ++i)
+        {
+            double dx = (double)found[i].p.x - offset - p.x;
+            double dy = (double)found[i].p.y - offset - p.y;
+            best = std::min(best, std::sqrt(dx * dx + dy * dy));
+        }
+        return best;
+    }
+
+
+    /// Builds the primitives in T, then queries each case once per
+    /// repetition; errors are those of the first repetition
+    template <typename T>
+    void
+    run(Query query,
+        const std::vector<Case>& cases,
+        double offset,
+        const Options& opts,
+        Result& result)
+    {
+        typedef BasicGenericEllipse<T> Ellipse;
+        typedef BasicGenericLine<T> Line;
+
+        // Set up in place: the quadrants of an ellipse point back to it, so
+        // ellipses must not be copied
+        std::vector<Ellipse> ellipses(cases.size()), others(cases.size());
+        std::vector<Line> lines;
+        for (size_t i = 0; i != cases.size(); ++i)
+        {
+            const Case& c = cases[i];
+            ellipses[i].center(at<T>(c.center, offset));
+            ellipses[i].radius(BasicPoint2D<T>(c.radius.x, c.radius.y));
+            others[i].center(at<T>(c.other, offset));
+            others[i].radius(BasicPoint2D<T>(c.otherRadius, c.otherRadius));
+            // Reaching a quarter of the chord beyond the ellipse at both ends
+            BasicPoint2D<double> v = (c.p2 - c.p1) * 0.25;
+            lines.push_back(Line(at<T>(c.p1 - v, offset),
+                                 at<T>(c.p2 + v, offset)));
+        }
+
+        result.correct = result.failed = 0;
+        result.maxError = result.ns = 0.;
+
+        BasicSegmentPointVector<T> points;
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            Timer timer;
+            for (size_t i = 0; i != cases.size(); ++i)
+            {
+                points.clear();
+                int count = 0;
+                bool ok = true;
+                try
+                {
+                    if (query == LineEllipse)
+                    {
+                        ellipses[i].isIntersectedBy(&lines[i], 1, points,
+                                                    count);
+                    }
+                    else
+                    {
+                        ellipses[i].isIntersectedBy(&others[i], points,
+                                                    count);
+                    }
+                }
+                catch (const error::GeometryError&)
+                {
+                    ok = false;
+                }
+
+                if (r != 0)
+                {
+                    continue;
+                }
+                if (!ok)
+                {
+                    ++result.failed;
+                    continue;
+                }
+
+                double error = pointError(cases[i], offset, points);
+                result.maxError = std::max(result.maxError, error);
+                if (error <= maxRelativeError)
+                {
+                    ++result.correct;
+                }
+            }
+            double ns = timer.elapsedNs() / cases.size();
+
+            if (r == 0 || ns < result.ns)
+            {
+                result.ns = ns;
+            }
+        }
+    }
+
+
+    /// The largest error of the points found for case c, relative to the
+    /// radius of its ellipse; infinite unless there are two of them
+    template <typename T>
+    double
+    pointError(const Case& c, double offset,
+               const BasicSegmentPointVector<T>& points)
+    {
+        return points.size() == 2
+            ? std::max(distanceToFound(c.p1, offset, points),
+                       distanceToFound(c.p2, offset, points))
+              / std::max(c.radius.x, c.radius.y)
+            : HUGE_VAL;
+    }
+
+
+    /// Builds the shapes in T, then runs the query on all cases once per
+    /// repetition; errors are those of the first repetition
+    template <typename T>
+    void
+    runShapes(Query query,
+              const std::vector<Case>& cases,
+              double offset,
+              const Options& opts,
+              Result& result)
+    {
+        typedef BasicPoint2D<T> Point;
+        const size_t n = cases.size();
+
+        // As the ellipses, the rectangles must not be copied: their edges are
+        // used by the shape in place
+        std::vector<BasicEllipse<T> > ellipses(n);
+        std::vector<BasicEllipse<T> > others(query == RectEllipse ? 0 : n);
+        std::vector<BasicRectangle<T> > rects(query == RectEllipse ? n : 0);
+        std::vector<const BasicShape<T>*> shapes;
+        for (size_t i = 0; i != n; ++i)
+        {
+            const Case& c = cases[i];
+            ellipses[i].center(at<T>(c.center, offset));
+            ellipses[i].radius(Point(c.radius.x, c.radius.y));
+            if (query == RectEllipse)
+            {
+                rects[i].p1p2(at<T>(c.low, offset), at<T>(c.high, offset));
+                continue;
+            }
+            others[i].center(at<T>(c.other, offset));
+            others[i].radius(Point(c.otherRadius, c.otherRadius));
+            shapes.push_back(&ellipses[i]);
+            shapes.push_back(&others[i]);
+        }
+
+        BasicAABBTree<T> tree;
+        BasicIntersectionEngine<T> engine;
+        engine.skipFailedPairs(true);
+        if (query == Engine)
+        {
+            for (size_t i = 0; i != shapes.size(); ++i)
+            {
+                tree.insert(shapes[i]);
+            }
+        }
+
+        BasicShapeClipper<T> clipper;
+        BasicClipResult<T> clipped;
+        std::vector<BasicShapePair<T> > pairs;
+        BasicSegmentPointVector<T> points;
+        std::vector<BasicSegmentPointVector<T> > pointsOfCase(n);
+
+        result.correct = result.failed = 0;
+        result.maxError = result.ns = 0.;
+
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            Timer timer;
+            if (query == Engine)
+            {
+                pairs.clear();
+                points.clear();
+                engine.findIntersections(shapes, tree, pairs, points);
+            }
+            else
+            {
+                for (size_t i = 0; i != n; ++i)
+                {
+                    int count = 0;
+                    bool ok = true;
+                    try
+                    {
+                        if (query == RectEllipse)
+                        {
+                            points.clear();
+                            rects[i].isIntersectedBy(&ellipses[i], points,
+                                                     count);
+                        }
+                        else
+                        {
+                            clipper.clip(&ellipses[i], &others[i],
+                                         BasicShapeClipper<T>::Intersection,
+                                         clipped);
+                        }
+                    }
+                    catch (const error::GeometryError&)
+                    {
+                        ok = false;
+                    }
+
+                    if (r != 0)
+                    {
+                        continue;
+                    }
+                    if (!ok)
+                    {
+                        ++result.failed;
+                        continue;
+                    }
+
+                    const Case& c = cases[i];
+                    double error;
+                    if (query == RectEllipse)
+                    {
+                        error = pointError(c, offset, points);
+                    }
+                    else
+                    {
+                        double smaller = std::min(c.radius.x, c.otherRadius);
+                        error = std::abs(clipped.area() - lensArea(c))
+                            / (pi * smaller * smaller);
+                    }
+                    result.maxError = std::max(result.maxError, error);
+                    if (error <= maxRelativeError)
+                    {
+                        ++result.correct;
+                    }
+                }
+            }
+            double ns = timer.elapsedNs() / n;
+
+            if (r == 0 || ns < result.ns)
+            {
+                result.ns = ns;
+            }
+        }
+
+        if (query != Engine)
+        {
+            return;
+        }
+
+        // The points of the last run, sorted out to the cases by where they
+        // are
+        result.failed = engine.numFailedPairs();
+        for (size_t i = 0; i != points.size(); ++i)
+        {
+            size_t c = caseAt(points[i].p.x - offset, points[i].p.y - offset,
+                              n);
+            if (c != n)
+            {
+                pointsOfCase[c].push_back(points[i]);
+            }
+        }
+        for (size_t i = 0; i != n; ++i)
+        {
+            double error = pointError(cases[i], offset, pointsOfCase[i]);
+            result.maxError = std::max(result.maxError, error);
+            if (error <= maxRelativeError)
+            {
+                ++result.correct;
+            }
+        }
+    }
+
+
+    void
+    print(const char* query, const char* type, double offset, int n,
+          const Result& result, const char* pass)
+    {
+        std::printf("%-13s %-6s %8.0e %6d %9.1f %7d %6d %10.2e %5s\n",
+                    query, type, offset, n, result.ns, result.correct,
+                    result.failed, result.maxError, pass);
+    }
+
+}
+
+
+int
+runPrecisionSuite(const Options& opts)
+{
+    const double offsets[] = { 0., 1e3, 1e4, 1e5, 1e6 };
+    const int n = opts.quick ? 500 : 5000;
+    int ret = 0;
+
+    std::printf("# Intersections at an offset from the origin, float vs "
+                "double, seed %lu, best of %d\n", opts.seed, opts.repetitions);
+    std::printf("# correct: both points within %.0e of the radius (Clip: "
+                "the area within %.0e of the smaller circle); double must "
+                "get all\n", maxRelativeError, maxRelativeError);
+    std::printf("%-13s %-6s %8s %6s %9s %7s %6s %10s %5s\n", "query", "type",
+                "offset", "n", "ns/query", "correct", "failed", "max error",
+                "pass");
+
+    const Query queries[] = {
+        LineEllipse, CircleCircle, RectEllipse, Engine, Clip };
+    const char* queryNames[] = {
+        "Line-Ellipse", "Circle-Circle", "Rect-Ellipse", "Engine", "Clip" };
+    for (int q = 0; q != 5; ++q)
+    {
+        Random rnd(opts.seed);
+        std::vector<Case> cases(n);
+        for (int i = 0; i != n; ++i)
+        {
+            makeCase(queries[q], rnd, cases[i]);
+            if (queries[q] == Engine)
+            {
+                placeCase(i, n, cases[i]);
+            }
+        }
+
+        for (int o = 0; o != 5; ++o)
+        {
+            Result single, precise;
+            if (q < 2)
+            {
+                run<float>(queries[q], cases, offsets[o], opts, single);
+                run<double>(queries[q], cases, offsets[o], opts, precise);
+            }
+            else
+            {
+                runShapes<float>(queries[q], cases, offsets[o], opts, single);
+                runShapes<double>(queries[q], cases, offsets[o], opts,
+                                  precise);
+            }
+
+            bool pass = precise.correct == n;
+            print(queryNames[q], "float", offsets[o], n, single, "-");
+            print(queryNames[q], "double", offsets[o], n, precise,
+                  pass ? "yes" : "NO");
+            if (!pass)
+            {
+                ret = 1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
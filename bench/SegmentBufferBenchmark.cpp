@@ -0,0 +1,165 @@
+// Long polylines against each other: the pairwise GenericLine loop
+// (GenericLine::areIntersectedBy) against the batch kernels of SegmentBuffer.
+// All kernels must report identical hits, and as many as GenericLine.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "GenericLine.h"
+#include "PointBuffer.h"
+#include "SegmentBuffer.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    /// A random walk of n + 1 points with steps of about stepSize, kept
+    /// within [-extent, extent]^2 so that it crosses itself and others often
+    void
+    randomWalk(size_t n, float stepSize, float extent, Random& rnd,
+               std::vector<Point2D>& points)
+    {
+        points.clear();
+        Point2D p(rnd.uniform(-extent, extent), rnd.uniform(-extent, extent));
+        points.push_back(p);
+        for (size_t i = 0; i != n; ++i)
+        {
+            p += Point2D(rnd.uniform(-stepSize, stepSize),
+                         rnd.uniform(-stepSize, stepSize));
+            p.x = p.x < -extent ? -extent : (p.x > extent ? extent : p.x);
+            p.y = p.y < -extent ? -extent : (p.y > extent ? extent : p.y);
+            points.push_back(p);
+        }
+    }
+
+
+    bool
+    sameHits(const std::vector<SegmentHit>& a, const std::vector<SegmentHit>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t k = 0; k != a.size(); ++k)
+        {
+            if (a[k].i != b[k].i || a[k].j != b[k].j || a[k].t != b[k].t
+                || a[k].t2 != b[k].t2)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+
+int
+runSegmentBufferSuite(const Options& opts)
+{
+    const size_t sizes[] = { 1000, 4000, 16000 };
+    const int numSizes = opts.quick ? 2 : 3;
+    int ret = 0;
+
+    std::printf("# Polyline against polyline, n segments each, seed %lu, "
+                "best of %d\n", opts.seed, opts.repetitions);
+    std::printf("%-12s %7s %12s %12s %10s %8s %5s\n", "method", "n", "ms",
+                "ns/pair", "hits", "speedup", "same");
+
+    const PointBuffer::Kernel defaultKernel = PointBuffer::kernel();
+    const PointBuffer::Kernel kernels[] = {
+        PointBuffer::ScalarKernel, PointBuffer::SSE2Kernel,
+        PointBuffer::AVX2Kernel };
+
+    for (int s = 0; s != numSizes; ++s)
+    {
+        const size_t n = sizes[s];
+        const double pairs = (double)n * n;
+
+        Random rnd(opts.seed);
+        std::vector<Point2D> walkA, walkB;
+        randomWalk(n, 4.f, 100.f, rnd, walkA);
+        randomWalk(n, 4.f, 100.f, rnd, walkB);
+
+        std::vector<GenericLine> linesA(n), linesB(n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            linesA[i].p1p2(walkA[i], walkA[i + 1]);
+            linesB[i].p1p2(walkB[i], walkB[i + 1]);
+        }
+
+        SegmentPointVector isecPoints;
+        double lineMs = 0.;
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            isecPoints.clear();
+            int count = 0;
+            Timer timer;
+            GenericLine::areIntersectedBy(&linesA[0], (int)n, &linesB[0],
+                                          (int)n, isecPoints, count);
+            double ms = timer.elapsedNs() * 1e-6;
+            lineMs = (r == 0 || ms < lineMs) ? ms : lineMs;
+        }
+        std::printf("%-12s %7lu %12.2f %12.3f %10lu %8.2f %5s\n",
+                    "GenericLine", (unsigned long)n, lineMs,
+                    lineMs * 1e6 / pairs, (unsigned long)isecPoints.size(),
+                    1., "yes");
+
+        SegmentBuffer a, b;
+        a.appendPolyline(&walkA[0], walkA.size());
+        b.appendPolyline(&walkB[0], walkB.size());
+
+        std::vector<SegmentHit> first;
+        for (int k = 0; k != 3; ++k)
+        {
+            if (!PointBuffer::setKernel(kernels[k]))
+            {
+                continue;
+            }
+
+            std::vector<SegmentHit> hits;
+            double ms = 0.;
+            for (int r = 0; r != opts.repetitions; ++r)
+            {
+                hits.clear();
+                Timer timer;
+                a.intersect(b, hits);
+                double t = timer.elapsedNs() * 1e-6;
+                ms = (r == 0 || t < ms) ? t : ms;
+            }
+
+            if (first.empty())
+            {
+                first = hits;
+            }
+            bool same = hits.size() == isecPoints.size()
+                && sameHits(first, hits);
+            std::printf("%-12s %7lu %12.2f %12.3f %10lu %8.2f %5s\n",
+                        PointBuffer::kernelName(kernels[k]), (unsigned long)n,
+                        ms, ms * 1e6 / pairs, (unsigned long)hits.size(),
+                        lineMs / ms, same ? "yes" : "NO");
+
+            if (!same)
+            {
+                ret = 1;
+            }
+        }
+    }
+
+    PointBuffer::setKernel(defaultKernel);
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,219 @@
+// All intersections within one large set of segments: the brute-force pair
+// loop over GenericLine::isIntersectedBy() against the Bentley-Ottmann sweep
+// of SegmentSweep. Both must report the same points for the same pairs,
+// also on grids whose spacing is not exactly representable in float, where
+// crossings through end points are rounded off them.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "GenericLine.h"
+#include "SegmentSweep.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    enum SegmentLayout { ShortSegments, SnappedSegments };
+
+
+    /// Short segments scattered over a square, like a road network or a
+    /// polygon soup; or segments snapped to a coarse grid of the given
+    /// spacing, so that many of them share end points, are vertical or
+    /// overlap collinearly
+    void
+    generateSegments(int n, SegmentLayout layout, float spacing, Random& rnd,
+                     std::vector<GenericLine>& lines)
+    {
+        lines.resize(n);
+
+        // About 4 crossings per segment on average for short ones
+        float extent = layout == ShortSegments ? 10.f * std::sqrt((float)n)
+                                               : std::sqrt((float)n);
+        for (int i = 0; i != n; ++i)
+        {
+            Point2D p(rnd.uniform(0.f, extent), rnd.uniform(0.f, extent));
+            Point2D d(rnd.uniform(-10.f, 10.f), rnd.uniform(-10.f, 10.f));
+            if (layout == SnappedSegments)
+            {
+                p = Point2D(std::floor(p.x), std::floor(p.y));
+                d = Point2D(std::floor(d.x * 0.2f), std::floor(d.y * 0.2f));
+                p *= spacing;
+                d *= spacing;
+            }
+            lines[i].p1p2(p, p + d);
+        }
+    }
+
+
+    struct Record
+    {
+        const GenericShapeElement* parent;
+
+        const GenericShapeElement* parent2;
+
+        float t, t2;
+
+        bool operator<(const Record& other) const
+        {
+            if (parent != other.parent)
+            {
+                return parent < other.parent;
+            }
+            if (parent2 != other.parent2)
+            {
+                return parent2 < other.parent2;
+            }
+            if (t != other.t)
+            {
+                return t < other.t;
+            }
+            return t2 < other.t2;
+        }
+
+        bool operator==(const Record& other) const
+        {
+            return parent == other.parent && parent2 == other.parent2
+                && t == other.t && t2 == other.t2;
+        }
+    };
+
+
+    void
+    sortedRecords(const SegmentPointVector& points, std::vector<Record>& out)
+    {
+        out.resize(points.size());
+        for (size_t i = 0; i != points.size(); ++i)
+        {
+            Record r = { points[i].parent, points[i].parent2, points[i].t,
+                         points[i].t2 };
+            out[i] = r;
+        }
+        std::sort(out.begin(), out.end());
+    }
+
+
+    int
+    bruteForce(const std::vector<GenericLine>& lines,
+               SegmentPointVector& isecPoints)
+    {
+        int count = 0;
+        for (size_t i = 0; i != lines.size(); ++i)
+        {
+            for (size_t j = i + 1; j != lines.size(); ++j)
+            {
+                int n = 0;
+                lines[i].isIntersectedBy(lines[j], isecPoints, n);
+                count += n;
+            }
+        }
+        return count;
+    }
+
+}
+
+
+int
+runSegmentSweepSuite(const Options& opts)
+{
+    struct Case
+    {
+        SegmentLayout layout;
+
+        const char* name;
+
+        int n;
+
+        // Of the grid of snapped segments
+        float spacing;
+
+        // Brute force takes too long beyond some size
+        bool bruteForce;
+    };
+
+    const Case cases[] = {
+        { ShortSegments, "short", 1000, 1.f, true },
+        { ShortSegments, "short", 4000, 1.f, true },
+        { SnappedSegments, "snapped", 4000, 1.f, true },
+        { SnappedSegments, "snap0.1", 4000, 0.1f, true },
+        { SnappedSegments, "snap1000.3", 4000, 1000.3f, true },
+        { ShortSegments, "short", 16000, 1.f, true },
+        { ShortSegments, "short", 100000, 1.f, false },
+        { SnappedSegments, "snapped", 100000, 1.f, false } };
+    const int numCases = opts.quick ? 5 : 8;
+    int ret = 0;
+
+    std::printf("# All intersections among n segments, seed %lu, best of "
+                "%d\n", opts.seed, opts.repetitions);
+    std::printf("%-10s %7s %12s %12s %10s %8s %5s\n", "layout", "n",
+                "brute ms", "sweep ms", "points", "speedup", "same");
+
+    for (int c = 0; c != numCases; ++c)
+    {
+        const Case& cs = cases[c];
+
+        Random rnd(opts.seed);
+        std::vector<GenericLine> lines;
+        generateSegments(cs.n, cs.layout, cs.spacing, rnd, lines);
+
+        SegmentPointVector brutePoints, sweepPoints;
+        double bruteMs = 0., sweepMs = 0.;
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            if (cs.bruteForce)
+            {
+                brutePoints.clear();
+                Timer timer;
+                bruteForce(lines, brutePoints);
+                double ms = timer.elapsedNs() * 1e-6;
+                bruteMs = (r == 0 || ms < bruteMs) ? ms : bruteMs;
+            }
+
+            sweepPoints.clear();
+            Timer timer;
+            SegmentSweep::findIntersections(&lines[0], cs.n, sweepPoints);
+            double ms = timer.elapsedNs() * 1e-6;
+            sweepMs = (r == 0 || ms < sweepMs) ? ms : sweepMs;
+        }
+
+        if (!cs.bruteForce)
+        {
+            std::printf("%-10s %7d %12s %12.2f %10lu %8s %5s\n", cs.name,
+                        cs.n, "-", sweepMs,
+                        (unsigned long)sweepPoints.size(), "-", "-");
+            continue;
+        }
+
+        std::vector<Record> bruteRecords, sweepRecords;
+        sortedRecords(brutePoints, bruteRecords);
+        sortedRecords(sweepPoints, sweepRecords);
+        bool same = bruteRecords == sweepRecords;
+
+        std::printf("%-10s %7d %12.2f %12.2f %10lu %8.2f %5s\n", cs.name,
+                    cs.n, bruteMs, sweepMs,
+                    (unsigned long)sweepPoints.size(), bruteMs / sweepMs,
+                    same ? "yes" : "NO");
+
+        if (!same)
+        {
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,275 @@
+// Splitting the outline of a large polygon at many crossing points: the
+// former scheme, a linked ring with one node allocated per segment and a
+// RangeIterator lookup per segment, against the merge of
+// SegmentedShape::addIntersections() into its contiguous ring. Both must
+// produce the same ring.
+
+#include "Benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "Arena.h"
+#include "GenericLine.h"
+#include "SegmentedShape.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    /// A star-shaped polygon of n edges around the origin
+    void
+    generatePolygon(size_t n, Random& rnd, std::vector<GenericLine>& edges)
+    {
+        std::vector<Point2D> vertices(n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            float angle = 6.2831853f * (float)i / (float)n;
+            float radius = rnd.uniform(80.f, 120.f);
+            vertices[i] = Point2D(radius * std::cos(angle),
+                                  radius * std::sin(angle));
+        }
+
+        edges.resize(n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            edges[i].p1p2(vertices[i], vertices[(i + 1) % n]);
+        }
+    }
+
+
+    /// k points on random edges, in random order, as an intersection query
+    /// would report them
+    void
+    generateCrossings(const std::vector<GenericLine>& edges, size_t k,
+                      Random& rnd, SegmentPointVector& points)
+    {
+        points.clear();
+        for (size_t i = 0; i != k; ++i)
+        {
+            const GenericLine& edge = edges[rnd.next() % edges.size()];
+            float t = rnd.uniform(0.f, 1.f);
+            points.push_back(SegmentPoint(
+                edge.p1() + (edge.p2() - edge.p1()) * t, t, &edge));
+        }
+    }
+
+
+    struct Node
+    {
+        Node(const SegmentPoint& start, Node* next)
+        :   start(start),
+            next(next)
+        {}
+
+        SegmentPoint start;
+
+        Node* next;
+    };
+
+
+    /// The former SegmentedShape, with a node per segment
+    class LinkedRing
+    {
+
+    public:
+
+        LinkedRing(const std::vector<GenericLine>& edges)
+        :   start_(0)
+        {
+            Node* last = 0;
+            for (size_t i = 0; i != edges.size(); ++i)
+            {
+                Node* node = new Node(
+                    SegmentPoint(edges[i].p1(), 0.f, &edges[i]), 0);
+                (last ? last->next : start_) = node;
+                last = node;
+            }
+            last->next = start_;
+        }
+
+        ~LinkedRing()
+        {
+            Node* node = start_;
+            do
+            {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+            while (node != start_);
+        }
+
+        void
+        addIntersections(SegmentPointVector& pv)
+        {
+            pv.sort();
+
+            Node* node = start_;
+            do
+            {
+                SegmentPointVector::RangeIterator pointIt(pv,
+                                                          node->start.parent);
+                while (!pointIt.endReached())
+                {
+                    if ((*pointIt).parent == node->next->start.parent
+                        && node->next != start_
+                        && (*pointIt).t >= node->next->start.t)
+                    {
+                        node = node->next;
+                        continue;
+                    }
+
+                    Node* split = new Node(*pointIt, node->next);
+                    node->next = split;
+                    node = split;
+                    ++pointIt;
+                }
+                node = node->next;
+            }
+            while (node != start_);
+        }
+
+        const Node* start() const
+        {
+            return start_;
+        }
+
+    private:
+
+        LinkedRing(const LinkedRing&);
+
+        LinkedRing& operator=(const LinkedRing&);
+
+    private:
+
+        Node* start_;
+
+    };
+
+
+    SegmentedShape*
+    makeShape(const std::vector<GenericLine>& edges, Arena& arena)
+    {
+        SegmentedShape* shape = new SegmentedShape(0, &arena);
+        for (size_t i = 0; i != edges.size(); ++i)
+        {
+            shape->addSegment(SegmentPoint(edges[i].p1(), 0.f, &edges[i]),
+                              Segment::LineElement);
+        }
+        return shape;
+    }
+
+
+    bool
+    sameRing(const LinkedRing& linked, const SegmentedShape& shape)
+    {
+        const Node* node = linked.start();
+        int s = 0;
+        do
+        {
+            const Segment& segm = shape.segment(s);
+            if (node->start.parent != segm.start.parent
+                || node->start.t != segm.start.t)
+            {
+                return false;
+            }
+            node = node->next;
+            s = segm.next;
+        }
+        while (node != linked.start() && s != 0);
+        return node == linked.start() && s == 0;
+    }
+
+}
+
+
+int
+runSegmentedShapeSuite(const Options& opts)
+{
+    struct Case
+    {
+        size_t edges;
+
+        size_t points;
+    };
+
+    const Case cases[] = { { 1000, 5000 }, { 10000, 50000 },
+                           { 100000, 500000 } };
+    const int numCases = opts.quick ? 2 : 3;
+    int ret = 0;
+
+    std::printf("# Splitting a polygon of n edges at k points, seed %lu, "
+                "best of %d\n", opts.seed, opts.repetitions);
+    std::printf("%8s %8s %10s %12s %12s %10s %8s %5s\n", "n", "k",
+                "sort ms", "linked ms", "ring ms", "ns/point", "speedup",
+                "same");
+
+    Arena arena;
+    for (int c = 0; c != numCases; ++c)
+    {
+        const Case& cs = cases[c];
+
+        Random rnd(opts.seed);
+        std::vector<GenericLine> edges;
+        generatePolygon(cs.edges, rnd, edges);
+        SegmentPointVector crossings;
+        generateCrossings(edges, cs.points, rnd, crossings);
+
+        double sortMs = 0., linkedMs = 0., ringMs = 0.;
+        bool same = true;
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            // Both sort their own copy, as part of the work; the sort alone
+            // takes this long
+            SegmentPointVector sortPoints(crossings);
+            Timer timer;
+            sortPoints.sort();
+            double ms = timer.elapsedNs() * 1e-6;
+            sortMs = (r == 0 || ms < sortMs) ? ms : sortMs;
+
+            SegmentPointVector linkedPoints(crossings);
+            timer.restart();
+            LinkedRing* linked = new LinkedRing(edges);
+            linked->addIntersections(linkedPoints);
+            ms = timer.elapsedNs() * 1e-6;
+            linkedMs = (r == 0 || ms < linkedMs) ? ms : linkedMs;
+
+            SegmentPointVector ringPoints(crossings);
+            timer.restart();
+            SegmentedShape* shape = makeShape(edges, arena);
+            shape->addIntersections(ringPoints);
+            ms = timer.elapsedNs() * 1e-6;
+            ringMs = (r == 0 || ms < ringMs) ? ms : ringMs;
+
+            same = same && sameRing(*linked, *shape)
+                && shape->numSegments() == cs.edges + cs.points;
+            delete linked;
+            delete shape;
+            arena.reset();
+        }
+
+        std::printf("%8lu %8lu %10.2f %12.2f %12.2f %10.1f %8.2f %5s\n",
+                    (unsigned long)cs.edges, (unsigned long)cs.points, sortMs,
+                    linkedMs, ringMs, ringMs * 1e6 / cs.points,
+                    linkedMs / ringMs, same ? "yes" : "NO");
+        if (!same)
+        {
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,332 @@
+// Clipping many shapes against a rectangular window with ShapeClipper, by
+// each of the four operations. The areas must add up: per shape, the
+// intersection and the union together cover both shapes, the difference is
+// the shape less the intersection and the xor is the union less it.
+//
+// Then pairs of ellipses with their centers at the same y, a special case
+// of the ellipse intersection: the same identities hold, the intersection of
+// two equal circles must be the lens of known area, and ellipses containing
+// each other's centers must overlap.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Ellipse.h"
+#include "GeometryExceptions.h"
+#include "Rectangle.h"
+#include "SegmentedShape.h"
+#include "ShapeClipper.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    const double pi = std::atan(1.) * 4.;
+
+
+    /// Area of a shape of the scene, independent of the clipper
+    double
+    shapeArea(const Shape* s)
+    {
+        if (s->type() == Shape::TEllipse)
+        {
+            const Point2D& r = static_cast<const Ellipse*>(s)->radius();
+            return pi * r.x * r.y;
+        }
+
+        SegmentedShape* outline = s->toSegmentedShape();
+        double area = 0.;
+        for (size_t i = 0; i != outline->numSegments(); ++i)
+        {
+            const Point2D& p = outline->segment(i).start.p;
+            const Point2D& q =
+                outline->segment(outline->segment(i).next).start.p;
+            area += (double)p.x * q.y - (double)p.y * q.x;
+        }
+        delete outline;
+        return std::abs(0.5 * area);
+    }
+
+
+    const char*
+    operationName(ShapeClipper::Operation op)
+    {
+        switch (op)
+        {
+        case ShapeClipper::Intersection:
+            return "and";
+        case ShapeClipper::Union:
+            return "or";
+        case ShapeClipper::Difference:
+            return "minus";
+        case ShapeClipper::Xor:
+            return "xor";
+        }
+        return "?";
+    }
+
+
+    /// Area of the lens where two circles of radius r, d apart, overlap
+    double
+    lensArea(double r, double d)
+    {
+        return 2. * r * r * std::acos(d / (2. * r))
+            - 0.5 * d * std::sqrt(4. * r * r - d * d);
+    }
+
+
+    /// Clips n pairs of ellipses side by side, every other one a pair of
+    /// equal circles; returns 0 if all areas come out right
+    int
+    runEqualYPairs(int n, const Options& opts)
+    {
+        const ShapeClipper::Operation ops[] = { ShapeClipper::Intersection,
+                                                ShapeClipper::Union,
+                                                ShapeClipper::Difference,
+                                                ShapeClipper::Xor };
+        Random rnd(opts.seed);
+        ShapeClipper clipper;
+        ClipResult result;
+        double ms[4] = { 0., 0., 0., 0. };
+        double area[4] = { 0., 0., 0., 0. };
+        unsigned long rings[4] = { 0, 0, 0, 0 };
+        unsigned long segments[4] = { 0, 0, 0, 0 };
+        bool ok[4] = { true, true, true, true };
+
+        for (int i = 0; i != n; ++i)
+        {
+            Point2D center(rnd.uniform(0.f, 100.f), rnd.uniform(0.f, 100.f));
+            Point2D radius, otherRadius;
+            float dx;
+            bool circles = i % 2 == 0;
+            if (circles)
+            {
+                float r = rnd.uniform(1.f, 10.f);
+                radius = otherRadius = Point2D(r, r);
+                dx = rnd.uniform(0.05f, 1.95f) * r;
+            }
+            else
+            {
+                radius = Point2D(rnd.uniform(1.f, 10.f),
+                                 rnd.uniform(1.f, 10.f));
+                otherRadius = Point2D(rnd.uniform(1.f, 10.f),
+                                      rnd.uniform(1.f, 10.f));
+                dx = rnd.uniform(0.05f, 0.95f)
+                    * std::min(radius.x, otherRadius.x);
+            }
+            Ellipse a(center, radius);
+            Ellipse b(center + Point2D(dx, 0.f), otherRadius);
+            a.makeAllClean();
+            b.makeAllClean();
+
+            double areaA = pi * radius.x * radius.y;
+            double areaB = pi * otherRadius.x * otherRadius.y;
+            double results[4];
+            for (int o = 0; o != 4; ++o)
+            {
+                Timer timer;
+                try
+                {
+                    clipper.clip(&a, &b, ops[o], result);
+                }
+                catch (const error::GeometryError&)
+                {
+                    ok[o] = false;
+                    result.clear();
+                }
+                ms[o] += timer.elapsedNs() * 1e-6;
+                results[o] = result.area();
+                area[o] += results[o];
+                rings[o] += result.numRings();
+                segments[o] += result.numSegments();
+            }
+
+            double tolerance = 1e-4 * (areaA + areaB);
+            double isec = results[0];
+            // Without a known area, the ellipses overlap at least around the
+            // centers, which both contain
+            double expected = circles ? lensArea(radius.x, dx) : -1.;
+            ok[0] = ok[0] && (circles ? std::abs(isec - expected) <= tolerance
+                                      : isec > tolerance);
+            ok[1] = ok[1]
+                && std::abs(isec + results[1] - areaA - areaB) <= tolerance;
+            ok[2] = ok[2] && std::abs(results[2] - (areaA - isec)) <= tolerance;
+            ok[3] = ok[3]
+                && std::abs(results[3] - (results[1] - isec)) <= tolerance;
+        }
+
+        int ret = 0;
+        for (int o = 0; o != 4; ++o)
+        {
+            std::printf("%-10s %6d %-6s %10.2f %10.1f %8lu %9lu %12.1f %7s "
+                        "%5s\n", "Ellipse=y", n, operationName(ops[o]), ms[o],
+                        ms[o] * 1e6 / n, rings[o], segments[o], area[o], "-",
+                        ok[o] ? "yes" : "NO");
+            if (!ok[o])
+            {
+                ret = 1;
+            }
+        }
+        return ret;
+    }
+
+
+    struct Totals
+    {
+        double ms;
+
+        unsigned long rings;
+
+        unsigned long segments;
+
+        unsigned long allocs;
+
+        /// Of the result for each shape
+        std::vector<double> areas;
+    };
+
+}
+
+
+int
+runShapeClipperSuite(const Options& opts)
+{
+    struct Case
+    {
+        Shape::ShapeType type;
+
+        int n;
+    };
+
+    const Case cases[] = { { Shape::TTriangle, 1000 },
+                           { Shape::TTriangle, 10000 },
+                           { Shape::TEllipse, 1000 } };
+    const int numCases = opts.quick ? 1 : 3;
+    const ShapeClipper::Operation ops[] = { ShapeClipper::Intersection,
+                                            ShapeClipper::Union,
+                                            ShapeClipper::Difference,
+                                            ShapeClipper::Xor };
+    int ret = 0;
+
+    std::printf("# Clipping n shapes against a window over the middle of "
+                "the field, seed %lu, best of %d\n", opts.seed,
+                opts.repetitions);
+    std::printf("%-10s %6s %-6s %10s %10s %8s %9s %12s %7s %5s\n", "shapes",
+                "n", "op", "ms", "ns/shape", "rings", "segments", "area",
+                "allocs", "ok");
+
+    for (int c = 0; c != numCases; ++c)
+    {
+        const Case& cs = cases[c];
+
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generate(cs.type, cs.n, RandomField, 10.f, rnd);
+        const std::vector<Shape*>& shapes = scene.shapes();
+
+        // The field is about side x side; the window covers its middle
+        // quarter, so that shapes lie inside, outside and across its edges
+        float side = 10.f * 2.f * std::sqrt((float)cs.n);
+        Rectangle window(Point2D(0.25f * side, 0.25f * side),
+                         Point2D(0.75f * side, 0.75f * side));
+        double windowArea = 0.25 * side * side;
+
+        std::vector<double> shapeAreas(shapes.size());
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            shapes[i]->makeAllClean();
+            shapeAreas[i] = shapeArea(shapes[i]);
+        }
+        window.makeAllClean();
+
+        ShapeClipper clipper;
+        ClipResult result;
+        Totals totals[4];
+        for (int o = 0; o != 4; ++o)
+        {
+            Totals& t = totals[o];
+            t.areas.resize(shapes.size());
+            for (int r = 0; r != opts.repetitions; ++r)
+            {
+                unsigned long rings = 0, segments = 0;
+                unsigned long allocsBefore = allocationCount();
+                Timer timer;
+                for (size_t i = 0; i != shapes.size(); ++i)
+                {
+                    clipper.clip(shapes[i], &window, ops[o], result);
+                    rings += result.numRings();
+                    segments += result.numSegments();
+                    t.areas[i] = result.area();
+                }
+                double ms = timer.elapsedNs() * 1e-6;
+                unsigned long allocs = allocationCount() - allocsBefore;
+                if (r == 0 || ms < t.ms)
+                {
+                    t.ms = ms;
+                }
+                t.rings = rings;
+                t.segments = segments;
+                t.allocs = allocs;
+            }
+        }
+
+        // The intersection points are rounded to floats, by up to about
+        // 1e-7 of the coordinates, along edges of about the shape size
+        double rounding = 1e-6 * side * 10.f;
+        bool ok[4] = { true, true, true, true };
+        double area[4] = { 0., 0., 0., 0. };
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            double shapeTolerance = 1e-5 * shapeAreas[i] + rounding;
+            double tolerance = 1e-5 * (shapeAreas[i] + windowArea);
+            double isec = totals[0].areas[i];
+            double unite = totals[1].areas[i];
+            ok[0] = ok[0] && isec >= -shapeTolerance
+                && isec <= shapeAreas[i] + shapeTolerance;
+            ok[1] = ok[1] && std::abs(isec + unite - shapeAreas[i]
+                                      - windowArea) <= tolerance;
+            ok[2] = ok[2] && std::abs(totals[2].areas[i]
+                                      - (shapeAreas[i] - isec))
+                <= shapeTolerance;
+            ok[3] = ok[3] && std::abs(totals[3].areas[i]
+                                      - (unite - isec)) <= tolerance;
+            for (int o = 0; o != 4; ++o)
+            {
+                area[o] += totals[o].areas[i];
+            }
+        }
+
+        for (int o = 0; o != 4; ++o)
+        {
+            const Totals& t = totals[o];
+            std::printf("%-10s %6d %-6s %10.2f %10.1f %8lu %9lu %12.1f %7lu "
+                        "%5s\n", shapeTypeName(cs.type), cs.n,
+                        operationName(ops[o]), t.ms, t.ms * 1e6 / cs.n,
+                        t.rings, t.segments, area[o], t.allocs,
+                        ok[o] ? "yes" : "NO");
+            if (!ok[o])
+            {
+                ret = 1;
+            }
+        }
+    }
+
+    ret |= runEqualYPairs(opts.quick ? 200 : 1000, opts);
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,251 @@
+// The narrow phase over the broad-phase pairs of a field of mixed shapes,
+// in the order the grid reports them, where the type combination changes
+// from one pair to the next, against the same pairs grouped by combination
+// with ShapeDispatch. All methods must find the same pairs and points.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+#include "GeometryExceptions.h"
+#include "SegmentPointVector.h"
+#include "ShapeDispatch.h"
+#include "ShapeGrid.h"
+
+namespace geom
+{
+
+namespace bench
+{
+
+
+namespace
+{
+
+    enum Method { Pairwise, Grouped, Batched };
+
+
+    const char*
+    methodName(Method method)
+    {
+        switch (method)
+        {
+        case Pairwise:
+            return "pairwise";
+        case Grouped:
+            return "grouped";
+        case Batched:
+            return "batched";
+        }
+        return "?";
+    }
+
+
+    struct Result
+    {
+        std::vector<ShapePair> pairs;
+
+        SegmentPointVector points;
+
+        int failed;
+
+        double ms;
+    };
+
+
+    /// Shape::isIntersectedBy() on every pair in the order given, skipping
+    /// failing pairs as ShapeDispatch::findIntersections() does
+    void
+    testPairs(const std::vector<ShapePair>& pairs, Result& result)
+    {
+        for (size_t i = 0; i != pairs.size(); ++i)
+        {
+            const size_t numPoints = result.points.size();
+            int count = 0;
+            try
+            {
+                if (pairs[i].first->isIntersectedBy(pairs[i].second,
+                                                    result.points, count))
+                {
+                    result.pairs.push_back(pairs[i]);
+                }
+            }
+            catch (const error::GeometryError&)
+            {
+                result.points.erase(result.points.begin() + numPoints,
+                                    result.points.end());
+                ++result.failed;
+            }
+        }
+    }
+
+
+    /// Best of opts.repetitions runs; the grouping is part of the time
+    void
+    run(Method method, const std::vector<ShapePair>& candidates,
+        const Options& opts, Result& result)
+    {
+        std::vector<ShapePair> pairs;
+        for (int r = 0; r != opts.repetitions; ++r)
+        {
+            pairs = candidates;
+            result.pairs.clear();
+            result.points.clear();
+            result.failed = 0;
+
+            Timer timer;
+            switch (method)
+            {
+            case Pairwise:
+                testPairs(pairs, result);
+                break;
+            case Grouped:
+                ShapeDispatch::groupByTypes(&pairs[0], pairs.size());
+                testPairs(pairs, result);
+                break;
+            case Batched:
+                ShapeDispatch::findIntersections(&pairs[0], pairs.size(),
+                                                 result.pairs, result.points,
+                                                 &result.failed);
+                break;
+            }
+            double ms = timer.elapsedNs() * 1e-6;
+
+            if (r == 0 || ms < result.ms)
+            {
+                result.ms = ms;
+            }
+        }
+    }
+
+
+    bool
+    pairLess(const ShapePair& a, const ShapePair& b)
+    {
+        std::less<const Shape*> less;
+        return less(a.first, b.first)
+            || (a.first == b.first && less(a.second, b.second));
+    }
+
+
+    bool
+    pointLess(const SegmentPoint& a, const SegmentPoint& b)
+    {
+        std::less<const GenericShapeElement*> less;
+        if (a.parent != b.parent)
+        {
+            return less(a.parent, b.parent);
+        }
+        if (a.p.x != b.p.x)
+        {
+            return a.p.x < b.p.x;
+        }
+        return a.p.y < b.p.y;
+    }
+
+
+    /// Whether a and b hold the same pairs and points, in any order
+    bool
+    sameResult(const Result& a, const Result& b)
+    {
+        if (a.pairs.size() != b.pairs.size()
+            || a.points.size() != b.points.size() || a.failed != b.failed)
+        {
+            return false;
+        }
+
+        std::vector<ShapePair> pairsA(a.pairs), pairsB(b.pairs);
+        std::sort(pairsA.begin(), pairsA.end(), pairLess);
+        std::sort(pairsB.begin(), pairsB.end(), pairLess);
+        for (size_t i = 0; i != pairsA.size(); ++i)
+        {
+            if (pairsA[i].first != pairsB[i].first
+                || pairsA[i].second != pairsB[i].second)
+            {
+                return false;
+            }
+        }
+
+        std::vector<SegmentPoint> pointsA(a.points.begin(), a.points.end());
+        std::vector<SegmentPoint> pointsB(b.points.begin(), b.points.end());
+        std::sort(pointsA.begin(), pointsA.end(), pointLess);
+        std::sort(pointsB.begin(), pointsB.end(), pointLess);
+        for (size_t i = 0; i != pointsA.size(); ++i)
+        {
+            if (pointsA[i].parent != pointsB[i].parent
+                || pointsA[i].p.x != pointsB[i].p.x
+                || pointsA[i].p.y != pointsB[i].p.y)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}
+
+
+int
+runShapeDispatchSuite(const Options& opts)
+{
+    const int sizes[] = { 4000, 16000, 64000 };
+    const int numSizes = opts.quick ? 1 : 3;
+    const Method methods[] = { Pairwise, Grouped, Batched };
+    int ret = 0;
+
+    std::printf("# Narrow phase over grid pairs of mixed shapes, seed %lu, "
+                "best of %d\n", opts.seed, opts.repetitions);
+    std::printf("%-10s %7s %9s %10s %9s %12s %9s %5s\n", "method", "n",
+                "pairs", "ms", "ns/pair", "intersecting", "points", "same");
+
+    for (int s = 0; s != numSizes; ++s)
+    {
+        Random rnd(opts.seed);
+        Scene scene;
+        scene.generateMixed(sizes[s], RandomField, 10.f, rnd);
+        const std::vector<Shape*>& shapes = scene.shapes();
+
+        ShapeGrid grid;
+        for (size_t i = 0; i != shapes.size(); ++i)
+        {
+            shapes[i]->makeAllClean();
+            grid.insert(shapes[i]);
+        }
+        std::vector<ShapePair> candidates;
+        grid.findPairs(candidates);
+
+        Result base;
+        for (int m = 0; m != 3; ++m)
+        {
+            Result result;
+            run(methods[m], candidates, opts, result);
+            if (m == 0)
+            {
+                base = result;
+            }
+
+            bool same = sameResult(base, result);
+            std::printf("%-10s %7d %9lu %10.3f %9.1f %12lu %9lu %5s\n",
+                        methodName(methods[m]), sizes[s],
+                        (unsigned long)candidates.size(), result.ms,
+                        result.ms * 1e6 / candidates.size(),
+                        (unsigned long)result.pairs.size(),
+                        (unsigned long)result.points.size(),
+                        same ? "yes" : "NO");
+            if (!same)
+            {
+                ret = 1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+} // namespace bench
+
+} // namespace geom
@@ -0,0 +1,106 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace geom::bench;
+
+namespace
+{
+
+    struct Suite
+    {
+        const char* name;
+        SuiteFunc func;
+    };
+
+
+    const Suite suites[] =
+    {
+        { "intersection", runIntersectionSuite },
+        { "modes", runQueryModeSuite },
+        { "broadphase", runBroadPhaseSuite },
+        { "parallel", runParallelSuite },
+        { "points", runPointBufferSuite },
+        { "segments", runSegmentBufferSuite },
+        { "sweep", runSegmentSweepSuite },
+        { "outline", runSegmentedShapeSuite },
+        { "clip", runShapeClipperSuite },
+        { "dispatch", runShapeDispatchSuite },
+        { "precision", runPrecisionSuite }
+    };
+
+    const int numSuites = sizeof(suites) / sizeof(suites[0]);
+
+
+    void
+    usage(const char* prog)
+    {
+        std::printf("usage: %s [--seed N] [--reps N] [--quick] [suite...]\n"
+                    "suites:", prog);
+        for (int i = 0; i != numSuites; ++i)
+        {
+            std::printf(" %s", suites[i].name);
+        }
+        std::printf("\n");
+    }
+
+}
+
+
+int
+main(int argc, char* argv[])
+{
+    Options opts;
+    bool selected[numSuites] = { false };
+    bool anySelected = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+        {
+            opts.seed = std::strtoul(argv[++i], 0, 10);
+        }
+        else if (!std::strcmp(argv[i], "--reps") && i + 1 < argc)
+        {
+            opts.repetitions = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--quick"))
+        {
+            opts.quick = true;
+        }
+        else
+        {
+            int s = 0;
+            while (s != numSuites && std::strcmp(argv[i], suites[s].name))
+            {
+                ++s;
+            }
+            if (s == numSuites)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            selected[s] = true;
+            anySelected = true;
+        }
+    }
+
+    if (opts.repetitions < 1)
+    {
+        opts.repetitions = 1;
+    }
+
+    int ret = 0;
+    for (int s = 0; s != numSuites; ++s)
+    {
+        if (!anySelected || selected[s])
+        {
+            ret |= suites[s].func(opts);
+            std::printf("\n");
+        }
+    }
+
+    return ret;
+}
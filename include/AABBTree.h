@@ -0,0 +1,146 @@
+#ifndef AABBTREE_H_
+#define AABBTREE_H_
+
+#include <vector>
+
+#include "AABox.h"
+#include "Shape.h"
+#include "ShapePair.h"
+#include "CandidatePairSource.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+
+/** A dynamic bounding volume hierarchy over the bounding boxes of shapes.
+ *
+ *  Each shape is kept in a leaf whose box is the shape's bounding box grown
+ *  by a margin on every side. As long as a shape moves within that fattened
+ *  box, update() leaves the tree untouched; otherwise only the affected leaf
+ *  is removed and reinserted. Inner nodes are kept balanced by rotations, so
+ *  queries stay logarithmic in the number of shapes.
+ *
+ *  The tree does not own the shapes.
+ */
+template <typename T>
+class BasicAABBTree : public BasicCandidatePairSource<T>
+{
+
+public:
+
+    typedef BasicShape<T> Shape;
+
+    typedef BasicShapePair<T> ShapePair;
+
+    typedef BasicAABox<T> AABox;
+
+    typedef BasicSegmentPointVector<T> SegmentPointVector;
+
+    BasicAABBTree(T margin = 1);
+
+    ~BasicAABBTree();
+
+public:
+
+    /// Returns a proxy id that identifies the shape within this tree
+    int insert(const Shape* shape);
+
+    void remove(int proxyId);
+
+    /// Refits the proxy if its shape has left the fattened box (e.g., after
+    /// Shape::moveBy()); returns whether the tree was changed. Shapes whose
+    /// generation has not changed are skipped right away.
+    bool update(int proxyId);
+
+    /// Calls update() for every proxy; returns the number of refitted proxies
+    int update();
+
+    const Shape* shape(int proxyId) const;
+
+    int size() const;
+
+    /// Height of the tree, 0 for a single leaf and -1 if empty
+    int height() const;
+
+    /// Appends every pair of shapes whose fattened boxes overlap
+    void findPairs(std::vector<ShapePair>& pairs) const;
+
+    /// Appends every shape whose fattened box overlaps box
+    void query(const AABox& box, std::vector<const Shape*>& shapes) const;
+
+    /// Runs Shape::isIntersectedBy() on all pairs found by findPairs(); the
+    /// pairs that actually intersect are appended to pairs, their points to
+    /// isecPoints. Returns the number of intersecting pairs. Errors of the
+    /// narrow phase are passed on to the caller.
+    int findIntersections(std::vector<ShapePair>& pairs,
+                          SegmentPointVector& isecPoints) const;
+
+private:
+
+    struct Node
+    {
+        AABox box;
+
+        // Parent index for nodes in use, next free node for free ones
+        int parent;
+
+        int child1;
+
+        int child2;
+
+        // Leaf = 0, free node = -1
+        int height;
+
+        const Shape* shape;
+
+        // Of the shape when the leaf box was last fitted
+        unsigned long generation;
+
+        bool isLeaf() const;
+    };
+
+    int allocateNode();
+
+    void freeNode(int node);
+
+    void insertLeaf(int leaf);
+
+    void removeLeaf(int leaf);
+
+    void refitUpwards(int node);
+
+    int balance(int node);
+
+    /// Pairs leaf with every overlapping leaf of a higher index
+    void collectPairs(int leaf,
+                      std::vector<int>& stack,
+                      std::vector<ShapePair>& pairs) const;
+
+private:
+
+    BasicAABBTree(const BasicAABBTree&);
+
+    BasicAABBTree& operator=(const BasicAABBTree&);
+
+private:
+
+    std::vector<Node> nodes_;
+
+    int root_;
+
+    int freeList_;
+
+    int leafCount_;
+
+    const T margin_;
+
+};
+
+
+typedef BasicAABBTree<float> AABBTree;
+
+
+} // namespace geom
+
+#endif // AABBTREE_H_
@@ -0,0 +1,164 @@
+#ifndef AABOX_H_
+#define AABOX_H_
+
+#include <algorithm>
+#include <type_traits>
+
+#include <Point2D.h>
+
+namespace geom
+{
+
+
+/** An axis-aligned box given by its minimum and maximum coordinates.
+ *
+ *  A plain aggregate of four coordinates (no virtual functions, no derived
+ *  data), 16 bytes in float, so it is cheap to copy and store in bulk; used
+ *  for bounding boxes and by the broad-phase structures. GenericRect is the
+ *  full-featured rectangle with edge lines.
+ */
+template <typename T>
+struct BasicAABox
+{
+    typedef BasicPoint2D<T> Point;
+
+    /// The box spanned by two opposite corners, in any order
+    static BasicAABox fromCorners(const Point& p1, const Point& p2);
+
+    Point min() const;
+
+    Point max() const;
+
+    Point extents() const;
+
+    Point center() const;
+
+    /// Boxes that only touch overlap as well
+    bool overlaps(const BasicAABox& other) const;
+
+    bool contains(const BasicAABox& other) const;
+
+    bool containsPoint(const Point& p) const;
+
+    /// The box grown by margin on every side
+    BasicAABox grown(T margin) const;
+
+    /// The smallest box containing this and other
+    BasicAABox combined(const BasicAABox& other) const;
+
+    T perimeter() const;
+
+    T minX, minY, maxX, maxY;
+};
+
+
+typedef BasicAABox<float> AABox;
+
+
+static_assert(sizeof(AABox) == 16, "AABox must stay 16 bytes");
+static_assert(std::is_trivially_copyable<AABox>::value
+              && std::is_trivially_copyable<BasicAABox<double> >::value,
+              "AABox must stay trivially copyable");
+
+
+template <typename T>
+inline BasicAABox<T>
+BasicAABox<T>::fromCorners(const Point& p1, const Point& p2)
+{
+    BasicAABox box = {
+        std::min(p1.x, p2.x), std::min(p1.y, p2.y),
+        std::max(p1.x, p2.x), std::max(p1.y, p2.y) };
+    return box;
+}
+
+
+template <typename T>
+inline BasicPoint2D<T>
+BasicAABox<T>::min() const
+{
+    return Point(minX, minY);
+}
+
+
+template <typename T>
+inline BasicPoint2D<T>
+BasicAABox<T>::max() const
+{
+    return Point(maxX, maxY);
+}
+
+
+template <typename T>
+inline BasicPoint2D<T>
+BasicAABox<T>::extents() const
+{
+    return Point(maxX - minX, maxY - minY);
+}
+
+
+template <typename T>
+inline BasicPoint2D<T>
+BasicAABox<T>::center() const
+{
+    return Point((minX + maxX) / 2, (minY + maxY) / 2);
+}
+
+
+template <typename T>
+inline bool
+BasicAABox<T>::overlaps(const BasicAABox& other) const
+{
+    return (minX <= other.maxX) && (other.minX <= maxX)
+        && (minY <= other.maxY) && (other.minY <= maxY);
+}
+
+
+template <typename T>
+inline bool
+BasicAABox<T>::contains(const BasicAABox& other) const
+{
+    return (minX <= other.minX) && (minY <= other.minY)
+        && (other.maxX <= maxX) && (other.maxY <= maxY);
+}
+
+
+template <typename T>
+inline bool
+BasicAABox<T>::containsPoint(const Point& p) const
+{
+    return (minX <= p.x) && (p.x <= maxX) && (minY <= p.y) && (p.y <= maxY);
+}
+
+
+template <typename T>
+inline BasicAABox<T>
+BasicAABox<T>::grown(T margin) const
+{
+    BasicAABox box = {
+        minX - margin, minY - margin, maxX + margin, maxY + margin };
+    return box;
+}
+
+
+template <typename T>
+inline BasicAABox<T>
+BasicAABox<T>::combined(const BasicAABox& other) const
+{
+    BasicAABox box = {
+        std::min(minX, other.minX), std::min(minY, other.minY),
+        std::max(maxX, other.maxX), std::max(maxY, other.maxY) };
+    return box;
+}
+
+
+template <typename T>
+inline T
+BasicAABox<T>::perimeter() const
+{
+    return T(2) * ((maxX - minX) + (maxY - minY));
+}
+
+
+} // namespace geom
+
+#endif // AABOX_H_
@@ -0,0 +1,111 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace geom
+{
+
+
+/** A bump allocator for the short-lived objects of one query or one frame,
+ *  such as the points of an intersection burst or the segments of a
+ *  SegmentedShape.
+ *
+ *  Memory is handed out from large blocks by advancing a pointer; nothing is
+ *  freed individually. reset() releases everything at once in O(1) and keeps
+ *  the blocks, so an arena reused frame after frame stops allocating once it
+ *  has grown to the largest frame. Destructors are never run: only objects
+ *  that need none (trivially destructible ones, or ones owning no resources)
+ *  may be placed in an arena.
+ *
+ *  Not thread-safe; use one arena per thread.
+ */
+class Arena
+{
+
+public:
+
+    /// Blocks are of blockSize bytes, unless a single request needs more
+    explicit Arena(size_t blockSize = 4096);
+
+    ~Arena();
+
+public:
+
+    /// size bytes aligned to align, a power of two
+    void* allocate(size_t size, size_t align);
+
+    /// Constructs a U in the arena
+    template <typename U, typename... Args>
+    U* create(Args&&... args);
+
+    /// Releases all allocations; the blocks are kept for reuse
+    void reset();
+
+    /// Returns the blocks to the global heap, as well as all allocations
+    void release();
+
+    /// Bytes held in blocks, in use or not
+    size_t capacity() const;
+
+private:
+
+    void* allocateSlow(size_t size, size_t align);
+
+private:
+
+    Arena(const Arena&);
+
+    Arena& operator=(const Arena&);
+
+private:
+
+    struct Block
+    {
+        char* begin;
+
+        size_t size;
+    };
+
+    const size_t blockSize_;
+
+    std::vector<Block> blocks_;
+
+    // Number of blocks in use; the last of them is being filled
+    size_t used_;
+
+    // Free part of the block being filled
+    std::uintptr_t ptr_, end_;
+
+};
+
+
+inline void*
+Arena::allocate(size_t size, size_t align)
+{
+    std::uintptr_t p = (ptr_ + (align - 1)) & ~(std::uintptr_t)(align - 1);
+    if (p + size > end_)
+    {
+        return allocateSlow(size, align);
+    }
+    ptr_ = p + size;
+    return reinterpret_cast<void*>(p);
+}
+
+
+template <typename U, typename... Args>
+inline U*
+Arena::create(Args&&... args)
+{
+    return new (allocate(sizeof(U), alignof(U)))
+        U(std::forward<Args>(args)...);
+}
+
+
+} // namespace geom
+
+#endif // ARENA_H_
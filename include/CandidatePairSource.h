@@ -0,0 +1,37 @@
+#ifndef CANDIDATEPAIRSOURCE_H_
+#define CANDIDATEPAIRSOURCE_H_
+
+#include <vector>
+
+#include "ShapePair.h"
+
+namespace geom
+{
+
+
+/** Anything that can tell which pairs of shapes may intersect, typically a
+ *  broad-phase structure. IntersectionEngine runs the narrow phase on the
+ *  pairs it reports.
+ */
+template <typename T>
+class BasicCandidatePairSource
+{
+
+public:
+
+    virtual ~BasicCandidatePairSource() {}
+
+public:
+
+    /// Appends the candidate pairs, each pair once
+    virtual void findPairs(std::vector<BasicShapePair<T> >& pairs) const = 0;
+
+};
+
+
+typedef BasicCandidatePairSource<float> CandidatePairSource;
+
+
+} // namespace geom
+
+#endif // CANDIDATEPAIRSOURCE_H_
@@ -0,0 +1,86 @@
+#ifndef CLIPRESULT_H_
+#define CLIPRESULT_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Segment.h"
+
+namespace geom
+{
+
+
+/** The outcome of a boolean operation of ShapeClipper: closed rings of
+ *  segments, all held in one array, ring after ring.
+ *
+ *  Each segment runs from its start point to the start point of the next
+ *  one in its ring, the last one back to the first, along start.parent: a
+ *  straight line for a LineElement, the elliptic arc of that quadrant for an
+ *  ArcElement. The type tells the direction: Positive if the segment runs
+ *  along its parent in the direction of growing t, Negative if against it.
+ *
+ *  The area is on the left of every ring, so outer boundaries run
+ *  counterclockwise and holes clockwise. Rings do not cross each other, but
+ *  may touch in single points.
+ *
+ *  clear() keeps the capacity, so a result reused across operations stops
+ *  allocating once it has grown to the largest one.
+ */
+template <typename T>
+class BasicClipResult
+{
+
+public:
+
+    typedef BasicSegment<T> Segment;
+
+    BasicClipResult();
+
+public:
+
+    void clear();
+
+    bool empty() const;
+
+    size_t numRings() const;
+
+    /// Index of the first segment of ring i
+    size_t ringBegin(size_t i) const;
+
+    /// Index past the last segment of ring i
+    size_t ringEnd(size_t i) const;
+
+    size_t numSegments() const;
+
+    const Segment& segment(size_t i) const;
+
+    /// Enclosed area of ring i, negative for a hole; exact for arcs as well
+    double ringArea(size_t i) const;
+
+    /// Sum of the areas of all rings
+    double area() const;
+
+    /// Appends a segment to the open ring, which follows the last closed one;
+    /// next is set by endRing(). A segment continuing the one before it on
+    /// the same parent, in the same direction, is merged into it.
+    void addSegment(const Segment& segm);
+
+    /// Closes the open ring and links its segments; an empty one is dropped
+    void endRing();
+
+private:
+
+    std::vector<Segment> segments_;
+
+    /// Index of the first segment of each ring, and one past the last ring
+    std::vector<size_t> ringBegins_;
+
+};
+
+
+typedef BasicClipResult<float> ClipResult;
+
+
+} // namespace geom
+
+#endif // CLIPRESULT_H_
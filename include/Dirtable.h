@@ -1,9 +1,11 @@
 #ifndef DIRTABLE_H_
 #define DIRTABLE_H_
 
+#include <atomic>
+
 
 #define CLEAN_IF_DIRTY(pdirtable)                   \
-    if ((pdirtable)->dirty_) (pdirtable)->makeClean()
+    if ((pdirtable)->isDirty()) (pdirtable)->makeClean()
 
 // Generates a getter that calls makeClean() before returning.
 // Use like this:
@@ -23,10 +25,24 @@
     void func_name                          \
     {                                       \
         rec = val;                          \
-        dirty_ = true;                      \
+        markDirty();                        \
     }
 
 
+/** Base for objects that derive data lazily, i.e., on the first const query
+ *  after a change.
+ *
+ *  Cleaning is safe for concurrent readers: the first thread to find the
+ *  object dirty performs the cleaning, others wait until it has finished,
+ *  and the cleaned data are published to all of them (acquire/release). If
+ *  the cleaning throws, the object is dirty again and a waiting thread
+ *  retries it. Once clean, a query costs a single atomic load. Changing the
+ *  object while other threads read it is not safe, as with any other data.
+ *
+ *  Every change also advances the generation of the object, so caches built
+ *  on top of it (spatial indices, tessellations, ...) can tell whether it
+ *  has changed since they last looked, long after it has been cleaned.
+ */
 class Dirtable
 {
 
@@ -36,17 +52,47 @@ public:
 
     Dirtable(bool state);
 
+    /// Copies the state; the copy is never left in the middle of cleaning and
+    /// starts at generation 0
+    Dirtable(const Dirtable& other);
+
+    /// Counts as a change of this object
+    Dirtable& operator=(const Dirtable& other);
+
     virtual ~Dirtable();
 
-protected:
+public:
 
-    virtual void performCleaning() const = 0;
+    bool isDirty() const;
+
+    /// Starts at 0 and increases with every markDirty(). Only meaningful
+    /// together with the identity of the object.
+    unsigned long generation() const;
+
+    /// Overridden by classes that consist of several Dirtables (e.g.,
+    /// Ellipse) so that all parts are marked at once
+    virtual void markDirty();
 
+    /// Performs the cleaning if the object is dirty
     void makeClean() const;
 
 protected:
 
-    mutable bool dirty_;
+    virtual void performCleaning() const = 0;
+
+private:
+
+    enum State { Clean, Dirty, Cleaning };
+
+    static int copyableState(const Dirtable& other);
+
+private:
+
+    mutable std::atomic<int> state_;
+
+    // Written by the (single) modifying thread only, atomic so that readers
+    // in other threads are well-defined
+    std::atomic<unsigned long> generation_;
 
 };
 
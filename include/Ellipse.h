@@ -10,56 +10,56 @@ namespace geom
 {
 
 
-class Ellipse : virtual public GenericEllipse, public Shape
+template <typename T>
+class BasicEllipse : virtual public BasicGenericEllipse<T>, public BasicShape<T>
 {
 
 public:
 
-    Ellipse();
+    // Both bases name them
+    typedef BasicPoint2D<T> Point;
 
-    Ellipse(const Point2D& center, const Point2D& radius);
+    typedef BasicSegmentPointVector<T> PointVector;
 
-    ~Ellipse();
+    BasicEllipse();
 
-public:
+    BasicEllipse(const Point& center, const Point& radius);
 
-    void performCleaning() const;
+    ~BasicEllipse();
 
-    void calculateBoundingBox(GenericRect& bb) const;
+public:
 
-    void moveBy(const Point2D& delta);
+    /// Marks the shape and the ellipse part
+    void markDirty();
 
-    SegmentedShape* toSegmentedShape() const;
+    void calculateBoundingBox(BasicAABox<T>& bb) const;
 
-    bool containsPoint(const Point2D& p) const;
+    void moveBy(const Point& delta);
 
-protected:
+    BasicSegmentedShape<T>* toSegmentedShape(Arena* arena = 0) const;
 
-    bool isIntersectedByRectangle(const Rectangle* r,
-                         SegmentPointVector& isecPoints,
-                         int& isecCount) const;
+    bool containsPoint(const Point& p) const;
 
-    bool isIntersectedByTriangle(const Triangle* t,
-                         SegmentPointVector& isecPoints,
-                         int& isecCount) const;
+    using BasicShape<T>::generation;
 
-    bool isIntersectedByEllipse(const Ellipse* e,
-                         SegmentPointVector& isecPoints,
-                         int& isecCount) const;
+    using BasicShape<T>::intersects;
 
-    //using GenericEllipse::isIntersectedBy;
+    using BasicGenericEllipse<T>::intersects;
 
-private:
+    using BasicShape<T>::countIntersections;
 
-    bool isIntersectedByLineBasedShape(const LineBasedShape* s,
-                                       SegmentPointVector& isecPoints,
-                                       int& isecCount) const;
+    using BasicGenericEllipse<T>::countIntersections;
 
-    SegmentPoint* makeSegmentPoint(const Point2D& p) const;
+protected:
+
+    void makeElementsClean() const;
 
 };
 
 
+typedef BasicEllipse<float> Ellipse;
+
+
 } // namespace geom
 
 #endif // ELLIPSE_H_
@@ -8,30 +8,40 @@ namespace geom
 
 
 // Forward declaration
-class GenericEllipse;
+template <typename T>
+class BasicGenericEllipse;
 
 
-class GenericArc : public GenericShapeElement
+template <typename T>
+class BasicGenericArc : public BasicGenericShapeElement<T>
 {
 
 public:
 
-    GenericArc(GenericEllipse* ellipse, int qIdx);
+    BasicGenericArc(BasicGenericEllipse<T>* ellipse, int qIdx);
 
-    bool containsPoint(const Point2D& p, float& t) const;
+    bool containsPoint(const BasicPoint2D<T>& p, T& t) const;
 
-    float getT(const Point2D& p) const;
+    /// Position of p, a point on the arc, from 0 at its start to 1 at its end
+    /// (clockwise, as the outline of the ellipse runs)
+    T getT(const BasicPoint2D<T>& p) const;
+
+    /// The ellipse the arc is a quadrant of
+    const BasicGenericEllipse<T>* ellipse() const;
 
 
 private:
 
-    GenericEllipse* const ellipse_;
+    BasicGenericEllipse<T>* const ellipse_;
 
     int qIdx_;
 
 };
 
 
+typedef BasicGenericArc<float> GenericArc;
+
+
 } // namespace geom
 
 #endif // GENERICARC_H_
@@ -10,76 +10,107 @@ namespace geom
 {
 
 
-class GenericEllipse : public Dirtable
+template <typename T>
+class BasicGenericEllipse : public Dirtable
 {
 
 public:
 
-    GenericEllipse();
+    typedef BasicPoint2D<T> Point;
 
-    GenericEllipse(const Point2D& center, const Point2D& radius);
+    typedef BasicSegmentPoint<T> SegPoint;
 
-    ~GenericEllipse();
+    typedef BasicSegmentPointVector<T> PointVector;
+
+    typedef BasicGenericLine<T> Line;
+
+    typedef BasicGenericArc<T> Arc;
+
+    BasicGenericEllipse();
+
+    BasicGenericEllipse(const Point& center, const Point& radius);
+
+    ~BasicGenericEllipse();
 
 public:
 
-    //void performCleaning() const;
+    void performCleaning() const;
 
-    GenericEllipse& moveBy(const Point2D& delta);
+    BasicGenericEllipse& moveBy(const Point& delta);
 
-    bool isIntersectedBy(const GenericEllipse* e,
-                         SegmentPointVector& isecPoints,
+    bool isIntersectedBy(const BasicGenericEllipse* e,
+                         PointVector& isecPoints,
                          int& isecCount) const;
 
-    bool isIntersectedBy(const GenericLine* lines,
+    bool isIntersectedBy(const Line* lines,
                          int numLines,
-                         SegmentPointVector& isecPoints,
+                         PointVector& isecPoints,
                          int& isecCount) const;
 
-    bool intersects(const GenericLine* lines,
+    bool intersects(const Line* lines,
                     int numLines,
-                    SegmentPointVector& isecPoints,
+                    PointVector& isecPoints,
                     int& isecCount) const;
 
-    const Point2D& center() const;
+    /// Boolean-only test; decides by the signs of a Sturm sequence instead of
+    /// solving the quartic
+    bool isIntersectedBy(const BasicGenericEllipse* e) const;
+
+    /// Returns on the first intersection found, no points are computed
+    bool isIntersectedBy(const Line* lines, int numLines) const;
 
-    void center(const Point2D& center);
+    /// Number of distinct intersection points, without computing them
+    int countIntersections(const BasicGenericEllipse* e) const;
 
-    const Point2D& radius() const;
+    int countIntersections(const Line* lines, int numLines) const;
 
-    void radius(const Point2D& radius);
+    const Point& center() const;
 
-    const GenericArc* getQuadrant(const Point2D& p) const;
+    void center(const Point& center);
 
-    bool isIntersectedByPoint(const Point2D& p) const;
+    const Point& radius() const;
+
+    void radius(const Point& radius);
+
+    const Arc* getQuadrant(const Point& p) const;
+
+    bool isIntersectedByPoint(const Point& p) const;
 
 protected:
 
-    bool isIntersectedByLine(const GenericLine& line,
-                             SegmentPointVector& isecPoints,
-                             int& isecCount) const;
+    /// Points are only appended if isecPoints is non-null, the number of
+    /// intersections is returned either way
+    int isIntersectedByLine(const Line& line,
+                            PointVector* isecPoints) const;
 
-    SegmentPoint* makeSegmentPoint(const Point2D& p,
-                                   const GenericShapeElement* parent2) const;
+    SegPoint makeSegmentPoint(
+        const Point& p, const BasicGenericShapeElement<T>* parent2) const;
 
 private:
 
-    void identifyIsecPoints(const Point2D& first,
-                            const GenericEllipse* e,
-                            SegmentPointVector& isecPoints,
+    int countIntersectionsWithLines(const Line* lines,
+                                    int numLines,
+                                    bool stopAtFirst) const;
+
+    void identifyIsecPoints(const Point& first,
+                            const BasicGenericEllipse* e,
+                            PointVector& isecPoints,
                             int& isecCount) const;
 
 protected:
 
-    Point2D center_;
+    Point center_;
 
-    Point2D radius_;
+    Point radius_;
 
-    GenericArc quadrant_[4];
+    Arc quadrant_[4];
 
 };
 
 
+typedef BasicGenericEllipse<float> GenericEllipse;
+
+
 } // namespace geom
 
 #endif // GENERICELLIPSE_H_
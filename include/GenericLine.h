@@ -13,84 +13,114 @@ namespace geom
 {
 
 
-class GenericLine : public GenericShapeElement, public Dirtable
+template <typename T>
+class BasicGenericLine : public BasicGenericShapeElement<T>, public Dirtable
 {
 
 public:
 
-    GenericLine();
+    typedef BasicPoint2D<T> Point;
 
-    GenericLine(const Point2D& p1, const Point2D& p2);
+    typedef BasicSegmentPoint<T> SegPoint;
 
-    ~GenericLine();
+    typedef BasicSegmentPointVector<T> PointVector;
+
+    BasicGenericLine();
+
+    BasicGenericLine(const Point& p1, const Point& p2);
+
+    ~BasicGenericLine();
 
 public:
 
     void performCleaning() const;
 
-    bool isIntersectedBy(const GenericLine& other,
-                         SegmentPointVector& isecPoints,
+    bool isIntersectedBy(const BasicGenericLine& other,
+                         PointVector& isecPoints,
                          int& isecCount) const;
 
-    bool isIntersectedByLines(const GenericLine others[],
+    /// Number of intersection points with other, without computing them
+    int countIntersections(const BasicGenericLine& other) const;
+
+    bool isIntersectedByLines(const BasicGenericLine others[],
                               int numOthers,
-                              SegmentPointVector& isecPoints,
+                              PointVector& isecPoints,
                               int& isecCount) const;
 
-    static bool areIntersectedBy(const GenericLine lines[],
+    static bool areIntersectedBy(const BasicGenericLine lines[],
                                  int numLines,
-                                 const GenericLine otherLines[],
+                                 const BasicGenericLine otherLines[],
                                  int numOtherLines,
-                                 SegmentPointVector& isecPoints,
+                                 PointVector& isecPoints,
                                  int& isecCount);
 
-    bool containsPoint(const Point2D& p) const;
-
-    bool containsPoint(const Point2D& p, float& t) const;
+    /// Returns on the first intersection found, no points are computed
+    static bool areIntersectedBy(const BasicGenericLine lines[],
+                                 int numLines,
+                                 const BasicGenericLine otherLines[],
+                                 int numOtherLines);
 
-    const Point2D& p1() const;
+    static int countIntersections(const BasicGenericLine lines[],
+                                  int numLines,
+                                  const BasicGenericLine otherLines[],
+                                  int numOtherLines);
 
-    const Point2D& p2() const;
+    bool containsPoint(const Point& p) const;
 
-    void p1(const Point2D& p);
+    bool containsPoint(const Point& p, T& t) const;
 
-    void p2(const Point2D& p);
+    const Point& p1() const;
 
-    void p1p2(const Point2D& p1, const Point2D& p2);
+    const Point& p2() const;
 
-    const Point2D& vec() const;
+    void p1(const Point& p);
 
-    float m() const;
+    void p2(const Point& p);
 
-    float n() const;
+    void p1p2(const Point& p1, const Point& p2);
 
-    friend std::ostream& operator<<(std::ostream& out, const GenericLine& line);
+    const Point& vec() const;
 
 private:
 
-    bool intersectsLine(const GenericLine& other,
-                        SegmentPointVector& isecPoints,
-                        int& isecCount) const;
+    /// The intersection kernel; points are only appended if isecPoints is
+    /// non-null, the number of intersections is returned either way
+    int intersectsLine(const BasicGenericLine& other,
+                       PointVector* isecPoints) const;
 
-    bool isSuperposedBy(const GenericLine& other,
-                        SegmentPointVector& intersecPoints,
-                        int& count) const;
+    /// Whether p1 == p2 exactly; needs a clean line
+    bool isPoint() const;
 
-private:
+    /// t of p, known to lie on the line, clamped to [0, 1]
+    T paramOf(const Point& p) const;
 
-    Point2D p1_;
+    int isSuperposedBy(const BasicGenericLine& other,
+                       PointVector* isecPoints) const;
 
-    Point2D p2_;
+    static int countIntersections(const BasicGenericLine lines[],
+                                  int numLines,
+                                  const BasicGenericLine otherLines[],
+                                  int numOtherLines,
+                                  bool stopAtFirst);
 
-    mutable Point2D vec_; // vec = p2 - p1
+private:
+
+    Point p1_;
 
-    mutable float m_;
+    Point p2_;
 
-    mutable float n_;
+    mutable Point vec_; // vec = p2 - p1
 
 };
 
 
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const BasicGenericLine<T>& line);
+
+
+typedef BasicGenericLine<float> GenericLine;
+
+
 } // namespace geom
 
 #endif // LINE_H_
@@ -10,68 +10,121 @@ namespace geom
 {
 
 
-class GenericRect : public Dirtable
+// Forward declaration
+template <typename T>
+class BasicRectangle;
+
+
+/** A rectangle with lazily derived extents, corners and edge lines.
+ *
+ *  The edge lines are only set up when lines() is called; for plain box
+ *  tests, use AABox.
+ */
+template <typename T>
+class BasicGenericRect : public Dirtable
 {
 
 public:
 
-    friend class Rectangle;
+    friend class BasicRectangle<T>;
 
-    GenericRect();
+    typedef BasicPoint2D<T> Point;
 
-    GenericRect(const Point2D& p1, const Point2D& p2);
+    typedef BasicGenericLine<T> Line;
 
-    virtual ~GenericRect();
+    BasicGenericRect();
+
+    BasicGenericRect(const Point& p1, const Point& p2);
+
+    virtual ~BasicGenericRect();
 
 public:
 
     void performCleaning() const;
 
-    void p1(const Point2D& p);
+    void p1(const Point& p);
 
-    void p2(const Point2D& p);
+    void p2(const Point& p);
 
     /** Note that a call to p1() will update the rectangle - if p2 hasn't been
      *  set, this will lead to seemingly false results. */
-    const Point2D& p1() const;
+    const Point& p1() const;
 
-    const Point2D& p2() const;
+    const Point& p2() const;
 
-    const Point2D& extents() const;
+    const Point& extents() const;
 
-    const GenericLine* lines() const;
+    const Line* lines() const;
 
-    void moveBy(const Point2D& delta);
+    void moveBy(const Point& delta);
 
-    bool isIntersectedByRect(const GenericRect& other) const;
+    bool isIntersectedByRect(const BasicGenericRect& other) const;
 
-    bool isIntersectedByRect(const GenericRect& other,
-                             GenericRect& intersecRect) const;
+    bool isIntersectedByRect(const BasicGenericRect& other,
+                             BasicGenericRect& intersecRect) const;
 
-    bool containsRect(const GenericRect& other) const;
+    bool containsRect(const BasicGenericRect& other) const;
 
-    bool containsPoint(const Point2D& p) const;
+    bool containsPoint(const Point& p) const;
 
-    friend std::ostream& operator<<(std::ostream& out, const GenericRect& rect);
+    template <typename U>
+    friend std::ostream& operator<<(std::ostream& out,
+                                    const BasicGenericRect<U>& rect);
 
 protected:
 
-    mutable Point2D p1_;
+    mutable Point p1_;
+
+    mutable Point p2_;
+
+    mutable Point extents_;
+
+    mutable Point bottomLeft_;
+
+    mutable Point topRight_;
+
+    mutable Point center_;
+
+private:
+
+    /// The edge lines, derived from the corners on the first call of lines()
+    /// after a change of the rectangle
+    class Edges : public Dirtable
+    {
+
+    public:
 
-    mutable Point2D p2_;
+        Edges();
 
-    mutable Point2D extents_;
+        void corners(const Point& p1, const Point& p2);
 
-    mutable Point2D bottomLeft_;
+    protected:
 
-    mutable Point2D topRight_;
+        void performCleaning() const;
 
-    mutable Point2D center_;
+    public:
 
-    mutable GenericLine lines_[4];
+        mutable Line lines[4];
+
+    private:
+
+        Point p1_;
+
+        Point p2_;
+
+    };
+
+    mutable Edges edges_;
 
 };
 
+
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const BasicGenericRect<T>& rect);
+
+
+typedef BasicGenericRect<float> GenericRect;
+
 } // namespace geom
 
 #endif // GENERICRECT_H_
@@ -7,16 +7,75 @@ namespace geom
 {
 
 
+/// A new element id, see BasicGenericShapeElement::id()
+unsigned newShapeElementId();
+
+
 // A common base class for GenericLine and GenericArc
-class GenericShapeElement {
+template <typename T>
+class BasicGenericShapeElement {
 
 public:
 
-    virtual bool containsPoint(const Point2D& p, float& t) const = 0;
+    BasicGenericShapeElement();
+
+    /// A copy is a new element and gets an id of its own
+    BasicGenericShapeElement(const BasicGenericShapeElement& other);
+
+    /// Keeps the id
+    BasicGenericShapeElement& operator=(const BasicGenericShapeElement& other);
+
+public:
+
+    virtual bool containsPoint(const BasicPoint2D<T>& p, T& t) const = 0;
+
+    /// Compact, unique id, handed out in order of construction (starting at
+    /// 1), so that the same program creates the same ids in every run unless
+    /// it creates elements in several threads at once. Points are sorted by
+    /// it instead of by address.
+    unsigned id() const;
+
+private:
+
+    const unsigned id_;
 
 };
 
 
+typedef BasicGenericShapeElement<float> GenericShapeElement;
+
+
+template <typename T>
+inline
+BasicGenericShapeElement<T>::BasicGenericShapeElement()
+:   id_(newShapeElementId())
+{}
+
+
+template <typename T>
+inline
+BasicGenericShapeElement<T>::BasicGenericShapeElement(
+    const BasicGenericShapeElement&)
+:   id_(newShapeElementId())
+{}
+
+
+template <typename T>
+inline BasicGenericShapeElement<T>&
+BasicGenericShapeElement<T>::operator=(const BasicGenericShapeElement&)
+{
+    return *this;
+}
+
+
+template <typename T>
+inline unsigned
+BasicGenericShapeElement<T>::id() const
+{
+    return id_;
+}
+
+
 } // namespace geom
 
 #endif // GENERICSHAPEELEMENT_H_
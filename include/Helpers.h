@@ -7,7 +7,8 @@
 namespace geom
 {
 
-inline bool between(float val, float min, float max)
+template <typename T>
+inline bool between(T val, T min, T max)
 {
     return val >= min && val <= max;
 }
@@ -25,13 +26,19 @@ inline float max3(float v1, float v2, float v3)
 }
 
 
-inline Point2D min3(const Point2D& p1, const Point2D& p2, const Point2D& p3)
+template <typename T>
+inline BasicPoint2D<T> min3(const BasicPoint2D<T>& p1,
+                            const BasicPoint2D<T>& p2,
+                            const BasicPoint2D<T>& p3)
 {
     return min(p1, min(p2, p3));
 }
 
 
-inline Point2D max3(const Point2D& p1, const Point2D& p2, const Point2D& p3)
+template <typename T>
+inline BasicPoint2D<T> max3(const BasicPoint2D<T>& p1,
+                            const BasicPoint2D<T>& p2,
+                            const BasicPoint2D<T>& p3)
 {
     return max(p1, max(p2, p3));
 }
@@ -43,7 +50,7 @@ inline bool listContainsPoint(const SegmentPoint* const list[],
 {
     for (int i = 0; i < listSize; ++i)
     {
-        if (list[i] == &p)
+        if (&list[i]->p == &p)
         {
             return true;
         }
@@ -52,7 +59,8 @@ inline bool listContainsPoint(const SegmentPoint* const list[],
 }
 
 
-inline float dot(const Point2D& v1, const Point2D& v2)
+template <typename T>
+inline T dot(const BasicPoint2D<T>& v1, const BasicPoint2D<T>& v2)
 {
     return v1.x * v2.x + v1.y * v2.y;
 }
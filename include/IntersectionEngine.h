@@ -0,0 +1,147 @@
+#ifndef INTERSECTIONENGINE_H_
+#define INTERSECTIONENGINE_H_
+
+#include <vector>
+
+#include "Shape.h"
+#include "ShapePair.h"
+#include "CandidatePairSource.h"
+#include "SegmentPointVector.h"
+#include "ThreadPool.h"
+
+namespace geom
+{
+
+
+/** Runs Shape::isIntersectedBy() on many pairs of shapes in parallel.
+ *
+ *  Before the narrow phase, every shape is brought up to date with
+ *  Shape::makeAllClean(), so the worker threads only read the shapes. The
+ *  shapes must not be changed while a query runs.
+ *
+ *  Each thread collects its results in a buffer of its own, tagged with the
+ *  chunk of pairs they came from; the buffers are merged in chunk order, so
+ *  the result is the same as that of a sequential run, whatever the number
+ *  of threads and the scheduling.
+ */
+template <typename T>
+class BasicIntersectionEngine
+{
+
+public:
+
+    typedef BasicShape<T> Shape;
+
+    typedef BasicShapePair<T> ShapePair;
+
+    typedef BasicCandidatePairSource<T> CandidatePairSource;
+
+    typedef BasicSegmentPointVector<T> SegmentPointVector;
+
+    /// numThreads <= 0 uses one thread per hardware thread
+    explicit BasicIntersectionEngine(int numThreads = 0);
+
+    ~BasicIntersectionEngine();
+
+public:
+
+    int numThreads() const;
+
+    /// By default, an error in the narrow phase is passed on to the caller
+    /// (the one of the first failing pair, after all pairs are done). If set,
+    /// a failing pair counts as not intersecting instead.
+    void skipFailedPairs(bool skip);
+
+    /// Number of pairs skipped due to errors in the last query
+    int numFailedPairs() const;
+
+    /// Makes all shapes clean, in parallel
+    void prepare(const std::vector<const Shape*>& shapes);
+
+    /// Tests the pairs reported by source; the pairs that actually intersect
+    /// are appended to pairs, their points to isecPoints. Returns the number
+    /// of intersecting pairs. Within each chunk, the pairs are tested and
+    /// reported grouped by the types of their shapes (see
+    /// ShapeDispatch::findIntersections()).
+    int findIntersections(const std::vector<const Shape*>& shapes,
+                          const CandidatePairSource& source,
+                          std::vector<ShapePair>& pairs,
+                          SegmentPointVector& isecPoints);
+
+    /// Same, but tests every pair of shapes (i, j) with i < j
+    int findIntersections(const std::vector<const Shape*>& shapes,
+                          std::vector<ShapePair>& pairs,
+                          SegmentPointVector& isecPoints);
+
+private:
+
+    /// The results of one chunk within a thread buffer
+    struct Span
+    {
+        size_t chunk;
+
+        size_t pairsBegin, pairsEnd;
+
+        size_t pointsBegin, pointsEnd;
+    };
+
+    /// Padded by a cache line on both sides, to keep the threads from
+    /// sharing cache lines when writing. alignas would not do: before C++17,
+    /// std::vector does not honour over-aligned types, so the buffers could
+    /// start anywhere within a line.
+    struct ThreadBuffer
+    {
+        char paddingBefore[64];
+
+        std::vector<ShapePair> pairs;
+
+        SegmentPointVector points;
+
+        std::vector<Span> spans;
+
+        int numFailed;
+
+        char paddingAfter[64];
+    };
+
+    /// Tests a and b and stores the result in buffer
+    void testPair(const Shape* a, const Shape* b, ThreadBuffer& buffer) const;
+
+    void beginSpan(ThreadBuffer& buffer, size_t chunk) const;
+
+    void endSpan(ThreadBuffer& buffer) const;
+
+    void clearBuffers();
+
+    /// Appends the buffered results in chunk order; returns the number of
+    /// intersecting pairs
+    int mergeBuffers(std::vector<ShapePair>& pairs,
+                     SegmentPointVector& isecPoints);
+
+private:
+
+    BasicIntersectionEngine(const BasicIntersectionEngine&);
+
+    BasicIntersectionEngine& operator=(const BasicIntersectionEngine&);
+
+private:
+
+    ThreadPool pool_;
+
+    std::vector<ThreadBuffer> buffers_;
+
+    std::vector<ShapePair> candidates_;
+
+    bool skipFailedPairs_;
+
+    int numFailedPairs_;
+
+};
+
+
+typedef BasicIntersectionEngine<float> IntersectionEngine;
+
+
+} // namespace geom
+
+#endif // INTERSECTIONENGINE_H_
@@ -3,6 +3,7 @@
 
 
 #include <cmath>
+#include <limits>
 
 #define ZERO_LIMIT (1. / 10000.)
 
@@ -14,4 +15,65 @@
 
 #define LESSTHAN_ZERO(exp) ((exp) < -ZERO_LIMIT)
 
+
+namespace geom
+{
+
+
+/** Tolerances of the geometry core per scalar type.
+ *
+ *  absolute() is the limit below which a value counts as zero (ZERO_LIMIT for
+ *  float). relative() scales with the magnitude of the values compared, so
+ *  that nearEqual() does not degrade to exact comparison for coordinates far
+ *  from the origin, where the spacing of representable numbers exceeds
+ *  absolute().
+ */
+template <typename T>
+struct Tolerance;
+
+
+template <>
+struct Tolerance<float>
+{
+    static constexpr float absolute() { return 1e-4f; }
+
+    static constexpr float relative()
+    {
+        return 4.f * std::numeric_limits<float>::epsilon();
+    }
+};
+
+
+template <>
+struct Tolerance<double>
+{
+    static constexpr double absolute() { return 1e-9; }
+
+    static constexpr double relative()
+    {
+        return 4. * std::numeric_limits<double>::epsilon();
+    }
+};
+
+
+template <typename T>
+inline bool
+nearZero(T v)
+{
+    return std::abs(v) <= Tolerance<T>::absolute();
+}
+
+
+template <typename T>
+inline bool
+nearEqual(T v1, T v2)
+{
+    const T mag = std::abs(v1) < std::abs(v2) ? std::abs(v2) : std::abs(v1);
+    return std::abs(v1 - v2)
+        <= Tolerance<T>::absolute() + Tolerance<T>::relative() * mag;
+}
+
+
+} // namespace geom
+
 #endif // LIMITS_H_
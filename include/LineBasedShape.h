@@ -8,46 +8,33 @@ namespace geom
 {
 
 
-class LineBasedShape : public Shape
+template <typename T>
+class BasicLineBasedShape : public BasicShape<T>
 {
 
 public:
 
-    LineBasedShape(int numLines, ShapeType type);
+    typedef BasicGenericLine<T> Line;
 
-    LineBasedShape(ShapeType type);
+    BasicLineBasedShape(int numLines, ShapeTypes::ShapeType type);
 
-    virtual ~LineBasedShape();
+    BasicLineBasedShape(ShapeTypes::ShapeType type);
+
+    virtual ~BasicLineBasedShape();
 
 public:
 
-    const GenericLine* lines() const;
+    const Line* lines() const;
 
     virtual int getNumLines() const = 0;
 
 protected:
 
-    bool isIntersectedByRectangle(const Rectangle* r,
-                         SegmentPointVector& isecPoints,
-                         int& isecCount) const;
-
-    bool isIntersectedByTriangle(const Triangle* t,
-                         SegmentPointVector& isecPoints,
-                         int& isecCount) const;
-
-    bool isIntersectedByEllipse(const Ellipse* e,
-                         SegmentPointVector& isecPoints,
-                         int& isecCount) const;
-
-private:
-
-    bool isIntersectedByLineBasedShape(const LineBasedShape* s,
-                                       SegmentPointVector& isecPoints,
-                                       int& isecCount) const;
+    void makeElementsClean() const;
 
 protected:
 
-    GenericLine* lines_;
+    Line* lines_;
 
 private:
 
@@ -58,6 +45,9 @@ private:
 };
 
 
+typedef BasicLineBasedShape<float> LineBasedShape;
+
+
 } // namespace geom
 
 #endif // LINEBASEDSHAPE_H_
@@ -1,89 +1,229 @@
-#ifndef POINT2D_H_
-#define POINT2D_H_
+#ifndef POINT2D_H_
+#define POINT2D_H_
 
+#include <cmath>
 #include <ostream>
-
-namespace geom
-{
-
-
-/** A simple 2D point class. */
-class Point2D
-{
-
-public:
-
-    Point2D();
-
-    Point2D(float x, float y);
-
-    Point2D(const Point2D& other);
-
-    virtual ~Point2D();
-
-    Point2D& operator=(const Point2D& rhs);
-
-    Point2D& operator+=(const Point2D& rhs);
-
-    Point2D& operator-=(const Point2D& rhs);
-
-    Point2D& operator*=(const Point2D& rhs);
-
-    Point2D& operator/=(const Point2D& rhs);
-
-    Point2D& operator*=(float factor);
-
-    Point2D& operator/=(float divisor);
-
-    const Point2D operator-() const;
-
-    const Point2D operator+(const Point2D& other) const;
-
-    const Point2D operator-(const Point2D& other) const;
-
-    const Point2D operator*(const Point2D& other) const;
-
-    const Point2D operator/(const Point2D& other) const;
-
-    const Point2D operator*(float factor) const;
-
-    const Point2D operator/(float divisor) const;
-
-    bool operator==(const Point2D& rhs) const;
-
-    bool operator!=(const Point2D& rhs) const;
-
-    bool operator<(const Point2D& rhs) const;
-
-    bool operator>(const Point2D& rhs) const;
-
-    bool operator<=(const Point2D& rhs) const;
-
-    bool operator>=(const Point2D& rhs) const;
-
-    const Point2D abs() const;
-
-    bool isIn(const Point2D list[], int listSize) const;
-
-    friend const Point2D min(const Point2D& p1, const Point2D& p2);
-
-    friend const Point2D max(const Point2D& p1, const Point2D& p2);
-
-    friend std::ostream& operator<<(std::ostream& out, const Point2D& point);
-
-public:
-
-    float x;
-
-    float y;
-
-}; // class Point2D
-
-
-float dist(const Point2D& p1, const Point2D& p2);
-
-
-} // namespace geom
-
-
-#endif // POINT2D_H_
+#include <type_traits>
+
+#include "Limits.h"
+
+namespace geom
+{
+
+
+/** A simple 2D point class.
+ *
+ *  A plain pair of scalars: trivially copyable, without a vtable, and with all
+ *  operators defined inline so chains of them can be optimised across
+ *  translation units. Arrays of points may be copied with memcpy().
+ *
+ *  T is float or double; Point2D is the float point used by the shapes.
+ */
+template <typename T>
+class BasicPoint2D
+{
+
+public:
+
+    typedef T Scalar;
+
+    constexpr BasicPoint2D()
+    :   x(0),
+        y(0)
+    {}
+
+    constexpr BasicPoint2D(T x, T y)
+    :   x(x),
+        y(y)
+    {}
+
+    BasicPoint2D& operator+=(const BasicPoint2D& rhs)
+    {
+        x += rhs.x;
+        y += rhs.y;
+        return *this;
+    }
+
+    BasicPoint2D& operator-=(const BasicPoint2D& rhs)
+    {
+        x -= rhs.x;
+        y -= rhs.y;
+        return *this;
+    }
+
+    BasicPoint2D& operator*=(const BasicPoint2D& rhs)
+    {
+        x *= rhs.x;
+        y *= rhs.y;
+        return *this;
+    }
+
+    BasicPoint2D& operator/=(const BasicPoint2D& rhs)
+    {
+        x /= rhs.x;
+        y /= rhs.y;
+        return *this;
+    }
+
+    BasicPoint2D& operator*=(T factor)
+    {
+        x *= factor;
+        y *= factor;
+        return *this;
+    }
+
+    BasicPoint2D& operator/=(T divisor)
+    {
+        x /= divisor;
+        y /= divisor;
+        return *this;
+    }
+
+    constexpr const BasicPoint2D operator-() const
+    {
+        return BasicPoint2D(-x, -y);
+    }
+
+    constexpr const BasicPoint2D operator+(const BasicPoint2D& other) const
+    {
+        return BasicPoint2D(x + other.x, y + other.y);
+    }
+
+    constexpr const BasicPoint2D operator-(const BasicPoint2D& other) const
+    {
+        return BasicPoint2D(x - other.x, y - other.y);
+    }
+
+    constexpr const BasicPoint2D operator*(const BasicPoint2D& other) const
+    {
+        return BasicPoint2D(x * other.x, y * other.y);
+    }
+
+    constexpr const BasicPoint2D operator/(const BasicPoint2D& other) const
+    {
+        return BasicPoint2D(x / other.x, y / other.y);
+    }
+
+    constexpr const BasicPoint2D operator*(T factor) const
+    {
+        return BasicPoint2D(x * factor, y * factor);
+    }
+
+    constexpr const BasicPoint2D operator/(T divisor) const
+    {
+        return BasicPoint2D(x / divisor, y / divisor);
+    }
+
+    /// Equal within the absolute tolerance of T in both coordinates (see
+    /// Tolerance); far from the origin, this becomes exact equality
+    bool operator==(const BasicPoint2D& rhs) const
+    {
+        return nearZero(x - rhs.x) && nearZero(y - rhs.y);
+    }
+
+    bool operator!=(const BasicPoint2D& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// Equal within the absolute and the relative tolerance of T in both
+    /// coordinates (see nearEqual()), which keeps some tolerance at any
+    /// distance from the origin
+    bool isNear(const BasicPoint2D& rhs) const
+    {
+        return nearEqual(x, rhs.x) && nearEqual(y, rhs.y);
+    }
+
+    /// The ordering operators compare both coordinates, so two points need
+    /// not be ordered either way
+    constexpr bool operator<(const BasicPoint2D& rhs) const
+    {
+        return (x < rhs.x) && (y < rhs.y);
+    }
+
+    constexpr bool operator>(const BasicPoint2D& rhs) const
+    {
+        return (x > rhs.x) && (y > rhs.y);
+    }
+
+    constexpr bool operator<=(const BasicPoint2D& rhs) const
+    {
+        return (x <= rhs.x) && (y <= rhs.y);
+    }
+
+    constexpr bool operator>=(const BasicPoint2D& rhs) const
+    {
+        return (x >= rhs.x) && (y >= rhs.y);
+    }
+
+    const BasicPoint2D abs() const
+    {
+        return BasicPoint2D(std::abs(x), std::abs(y));
+    }
+
+    bool isIn(const BasicPoint2D list[], int listSize) const
+    {
+        for (int i = 0; i < listSize; ++i)
+        {
+            if (list[i] == *this)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    friend constexpr const BasicPoint2D min(const BasicPoint2D& p1,
+                                            const BasicPoint2D& p2)
+    {
+        return BasicPoint2D(p2.x < p1.x ? p2.x : p1.x,
+                            p2.y < p1.y ? p2.y : p1.y);
+    }
+
+    friend constexpr const BasicPoint2D max(const BasicPoint2D& p1,
+                                            const BasicPoint2D& p2)
+    {
+        return BasicPoint2D(p1.x < p2.x ? p2.x : p1.x,
+                            p1.y < p2.y ? p2.y : p1.y);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out,
+                                    const BasicPoint2D& point)
+    {
+        out << "Point2D(" << point.x << ", " << point.y << ")";
+        return out;
+    }
+
+public:
+
+    T x;
+
+    T y;
+
+}; // class BasicPoint2D
+
+
+typedef BasicPoint2D<float> Point2D;
+
+
+static_assert(sizeof(Point2D) == 2 * sizeof(float),
+              "Point2D must be a plain pair of floats");
+
+static_assert(std::is_trivially_copyable<Point2D>::value
+              && std::is_trivially_copyable<BasicPoint2D<double> >::value,
+              "BasicPoint2D must be trivially copyable");
+
+
+template <typename T>
+inline T
+dist(const BasicPoint2D<T>& p1, const BasicPoint2D<T>& p2)
+{
+    return std::sqrt(
+        (p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y));
+}
+
+
+} // namespace geom
+
+
+#endif // POINT2D_H_
@@ -0,0 +1,116 @@
+#ifndef POINTBUFFER_H_
+#define POINTBUFFER_H_
+
+#include <vector>
+
+#include <Point2D.h>
+#include "AABox.h"
+
+namespace geom
+{
+
+
+/** Many points stored as a structure of arrays, i.e., all x coordinates in
+ *  one array and all y coordinates in another.
+ *
+ *  The bulk operations run on SIMD kernels: AVX2 (8 points per step) if the
+ *  CPU supports it, else SSE2 (4 points), else plain scalar code. The choice
+ *  is made at run time, so the library need not be built for a particular
+ *  instruction set. All kernels perform the same IEEE operations in the same
+ *  order as the scalar Point2D code (no FMA contraction, no approximate
+ *  reciprocals), so their results match it bit for bit.
+ */
+class PointBuffer
+{
+
+public:
+
+    enum Kernel { ScalarKernel, SSE2Kernel, AVX2Kernel };
+
+    PointBuffer();
+
+    explicit PointBuffer(size_t n);
+
+    PointBuffer(const Point2D* points, size_t n);
+
+    ~PointBuffer();
+
+public:
+
+    size_t size() const;
+
+    bool empty() const;
+
+    void resize(size_t n);
+
+    void reserve(size_t n);
+
+    void clear();
+
+    void push_back(const Point2D& p);
+
+    Point2D operator[](size_t i) const;
+
+    void set(size_t i, const Point2D& p);
+
+    float* x();
+
+    float* y();
+
+    const float* x() const;
+
+    const float* y() const;
+
+    /// Adds delta to every point
+    void translate(const Point2D& delta);
+
+    /// Multiplies every point by factor, componentwise
+    void scale(const Point2D& factor);
+
+    /// The smallest box containing all points; inverted (min = +inf,
+    /// max = -inf) if the buffer is empty
+    AABox bounds() const;
+
+    /// out[i] = dist(point i, p); out must hold size() floats
+    void distances(const Point2D& p, float* out) const;
+
+    /// out[i] = dist(point i, point i of other); both buffers must be of the
+    /// same size, out must hold size() floats
+    void distances(const PointBuffer& other, float* out) const;
+
+    /// out[i] = (x - c.x)^2 / r.x^2 + (y - c.y)^2 / r.y^2 for point i, i.e.,
+    /// the left-hand side of the implicit ellipse equation; <= 1 inside the
+    /// ellipse. out must hold size() floats.
+    void ellipseValues(const Point2D& center,
+                       const Point2D& radius,
+                       float* out) const;
+
+    /// Number of points inside or on the ellipse, as by
+    /// Ellipse::containsPoint()
+    size_t countInEllipse(const Point2D& center, const Point2D& radius) const;
+
+    /// The kernel used by all buffers (and by SegmentBuffer), the best one
+    /// supported by default
+    static Kernel kernel();
+
+    /// Selects the kernel for all buffers; returns false (and leaves the
+    /// choice unchanged) if the CPU does not support it. Meant for testing
+    /// and benchmarking, not to be called while buffers are in use.
+    static bool setKernel(Kernel k);
+
+    static bool isSupported(Kernel k);
+
+    static const char* kernelName(Kernel k);
+
+private:
+
+    std::vector<float> x_;
+
+    std::vector<float> y_;
+
+};
+
+
+} // namespace geom
+
+#endif // POINTBUFFER_H_
@@ -0,0 +1,192 @@
+#ifndef PREDICATES_H_
+#define PREDICATES_H_
+
+#include <algorithm>
+#include <limits>
+
+#include <Point2D.h>
+
+namespace geom
+{
+
+
+/** Robust orientation tests after J. R. Shewchuk, "Adaptive Precision
+ *  Floating-Point Arithmetic and Fast Robust Geometric Predicates" (1997).
+ *
+ *  The determinant is first evaluated in plain double arithmetic and checked
+ *  against a bound on its rounding error. Only if the result is too close to
+ *  zero for its sign to be trusted is it evaluated again exactly, with
+ *  floating-point expansions. float coordinates convert to double exactly, so
+ *  the fast path is nearly always taken for them.
+ */
+
+
+/// Exact evaluation, for orient2d() only
+double orient2dExact(double ax, double ay,
+                     double bx, double by,
+                     double cx, double cy);
+
+
+/// Positive if a, b, c are in counterclockwise order, negative if clockwise
+/// and zero if collinear; the sign is exact, the magnitude approximately
+/// twice the area of the triangle
+inline double
+orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    // Shewchuk's ccwerrboundA, with eps = 2^-53
+    const double eps = std::numeric_limits<double>::epsilon() * 0.5;
+    const double errBound = (3. + 16. * eps) * eps;
+
+    double detLeft = (ax - cx) * (by - cy);
+    double detRight = (ay - cy) * (bx - cx);
+    double det = detLeft - detRight;
+
+    double detSum;
+    if (detLeft > 0.)
+    {
+        if (detRight <= 0.)
+        {
+            return det;
+        }
+        detSum = detLeft + detRight;
+    }
+    else if (detLeft < 0.)
+    {
+        if (detRight >= 0.)
+        {
+            return det;
+        }
+        detSum = -detLeft - detRight;
+    }
+    else
+    {
+        return det;
+    }
+
+    double bound = errBound * detSum;
+    if (det >= bound || -det >= bound)
+    {
+        return det;
+    }
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+
+/// Sign of orient2d(): 1 if c is left of the directed line a -> b, -1 if
+/// right of it and 0 if on it
+template <typename T>
+inline int
+orientation(const BasicPoint2D<T>& a,
+            const BasicPoint2D<T>& b,
+            const BasicPoint2D<T>& c)
+{
+    double det = orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+    return (det > 0.) - (det < 0.);
+}
+
+
+/// Whether p, known to be collinear with a and b, lies within the segment
+/// a -- b (end points included)
+template <typename T>
+inline bool
+withinCollinear(const BasicPoint2D<T>& a,
+                const BasicPoint2D<T>& b,
+                const BasicPoint2D<T>& p)
+{
+    return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x)
+        && std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+
+/// Whether p lies on the segment a -- b, exactly
+template <typename T>
+inline bool
+onSegment(const BasicPoint2D<T>& a,
+          const BasicPoint2D<T>& b,
+          const BasicPoint2D<T>& p)
+{
+    return orientation(a, b, p) == 0 && withinCollinear(a, b, p);
+}
+
+
+/// How two segments p1 -- p2 and q1 -- q2 relate, decided exactly
+enum SegmentRelation
+{
+    /// No common point
+    SegmentsDisjoint,
+
+    /// One common point inside both segments
+    SegmentsCross,
+
+    /// One common point, an end point of at least one segment; the zero
+    /// SegmentOrientations tell which
+    SegmentsTouch,
+
+    /// Collinear, with one (shared end point) or infinitely many common
+    /// points
+    SegmentsOverlap
+};
+
+
+/// orient2d() of the end points of each segment relative to the other, as
+/// computed by classifySegments()
+struct SegmentOrientations
+{
+    /// Of q1 and q2 relative to p1 -> p2
+    double q1, q2;
+
+    /// Of p1 and p2 relative to q1 -> q2
+    double p1, p2;
+};
+
+
+/// Classifies the segments p1 -- p2 and q1 -- q2, none of which may be of
+/// zero length. Disjoint segments are mostly rejected after the first two
+/// orientation tests.
+///
+/// If the segments cross, they do so at p1 + t * (p2 - p1) with
+/// t = o.p1 / (o.p1 - o.p2), and likewise for q; the orientations are of
+/// opposite signs then, so this is well-conditioned and within [0, 1].
+template <typename T>
+inline SegmentRelation
+classifySegments(const BasicPoint2D<T>& p1,
+                 const BasicPoint2D<T>& p2,
+                 const BasicPoint2D<T>& q1,
+                 const BasicPoint2D<T>& q2,
+                 SegmentOrientations& o)
+{
+    o.q1 = orient2d(p1.x, p1.y, p2.x, p2.y, q1.x, q1.y);
+    o.q2 = orient2d(p1.x, p1.y, p2.x, p2.y, q2.x, q2.y);
+    if ((o.q1 > 0. && o.q2 > 0.) || (o.q1 < 0. && o.q2 < 0.))
+    {
+        return SegmentsDisjoint;
+    }
+
+    if (o.q1 == 0. && o.q2 == 0.)
+    {
+        o.p1 = 0.;
+        o.p2 = 0.;
+        bool overlap = withinCollinear(p1, p2, q1)
+            || withinCollinear(p1, p2, q2)
+            || withinCollinear(q1, q2, p1);
+        return overlap ? SegmentsOverlap : SegmentsDisjoint;
+    }
+
+    o.p1 = orient2d(q1.x, q1.y, q2.x, q2.y, p1.x, p1.y);
+    o.p2 = orient2d(q1.x, q1.y, q2.x, q2.y, p2.x, p2.y);
+    if ((o.p1 > 0. && o.p2 > 0.) || (o.p1 < 0. && o.p2 < 0.))
+    {
+        return SegmentsDisjoint;
+    }
+
+    if (o.q1 != 0. && o.q2 != 0. && o.p1 != 0. && o.p2 != 0.)
+    {
+        return SegmentsCross;
+    }
+    return SegmentsTouch;
+}
+
+
+} // namespace geom
+
+#endif // PREDICATES_H_
@@ -10,40 +10,49 @@ namespace geom
 {
 
 
-class Rectangle : public LineBasedShape
+template <typename T>
+class BasicRectangle : public BasicLineBasedShape<T>
 {
 
 public:
 
-    Rectangle();
+    typedef BasicPoint2D<T> Point;
 
-    Rectangle(const Point2D& p1, const Point2D& p2);
+    /// The number of edges, known at compile time to ShapeDispatch
+    static const int NumLines = 4;
 
-    ~Rectangle();
+    BasicRectangle();
+
+    BasicRectangle(const Point& p1, const Point& p2);
+
+    ~BasicRectangle();
 
 public:
 
-    void p1p2(const Point2D& p1, const Point2D& p2);
+    void p1p2(const Point& p1, const Point& p2);
 
-    void performCleaning() const;
+    void performShapeCleaning() const;
 
-    void calculateBoundingBox(GenericRect& bb) const;
+    void calculateBoundingBox(BasicAABox<T>& bb) const;
 
-    void moveBy(const Point2D& delta);
+    void moveBy(const Point& delta);
 
     int getNumLines() const;
 
-    SegmentedShape* toSegmentedShape() const;
+    BasicSegmentedShape<T>* toSegmentedShape(Arena* arena = 0) const;
 
-    bool containsPoint(const Point2D& p) const;
+    bool containsPoint(const Point& p) const;
 
 private:
 
-    GenericRect r_;
+    BasicGenericRect<T> r_;
 
 };
 
 
+typedef BasicRectangle<float> Rectangle;
+
+
 } // namespace geom
 
 #endif // RECTANGLE_H_
@@ -116,6 +116,32 @@ void quarticPolynomialRoots(double a,
                             int& numRoots);
 
 
+/**
+ *  Counts the distinct real roots of the polynomial
+ *  coeffs[0]*x^degree + ... + coeffs[degree] in (lo, hi] by means of a Sturm
+ *  sequence, i.e., with a few sign evaluations instead of solving for them.
+ *  degree must not exceed 4.
+ */
+int countRealRoots(const double coeffs[],
+                   int degree,
+                   double lo,
+                   double hi);
+
+
+/**
+ *  Finds the distinct real roots of the same polynomial in (lo, hi], in
+ *  ascending order: the Sturm sequence isolates them, bisection narrows them
+ *  down to the precision of double. Roots of any multiplicity are found, and
+ *  returned once. The number of roots is that of countRealRoots(); roots is
+ *  to hold degree of them.
+ */
+int findRealRoots(const double coeffs[],
+                  int degree,
+                  double lo,
+                  double hi,
+                  double roots[]);
+
+
 bool newtonRoot(const Func& func,
                 const Func& derivedFunc,
                 double x0,
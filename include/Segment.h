@@ -7,74 +7,31 @@ namespace geom
 {
 
 
-class Segment
+/** One piece of the outline of a SegmentedShape, from its start point to the
+ *  start point of the next segment. A plain record: the shape keeps all its
+ *  segments in one array and links them into a ring by index, so splitting
+ *  a segment appends one record and relinks, without an allocation of its
+ *  own or a virtual call. */
+template <typename T>
+struct BasicSegment
 {
-
-public:
-
     enum SegmentType { Positive, Negative };
 
-    class Iterator
-    {
-
-    public:
-
-        Iterator(Segment* start);
-
-        bool endReached() const;
-
-        void operator++();
-
-        Segment* operator*() const;
-
-    private:
-
-        Segment* start_;
-
-        Segment* current_;
-
-        bool startPassed_;
-
-    };
-
-    Segment(const SegmentPoint& start, SegmentType type);
-
-    Segment(const SegmentPoint& start, Segment* next, SegmentType type);
+    /// The kind of element the segment lies on, i.e., the parent of start
+    enum ElementKind { LineElement, ArcElement };
 
-    virtual ~Segment();
+    BasicSegmentPoint<T> start;
 
-public:
+    /// Index of the next segment in the ring
+    int next;
 
-    virtual void makeClean() const;
+    SegmentType type;
 
-    const SegmentPoint& start() const;
-
-    const SegmentPoint& end() const;
-
-    const GenericShapeElement* parent() const;
-
-    void insertNewSegment(const SegmentPoint& p, SegmentType type);
-
-    void insertSegment(Segment* s);
-
-    Segment* next() const;
-
-    void next(Segment* s);
-
-    const SegmentType type;
-
-protected:
-
-    virtual Segment* duplicate(const SegmentPoint& start, SegmentType type) const = 0;
-
-protected:
-
-    SegmentPoint start_;
-
-    Segment* next_;
+    ElementKind kind;
+};
 
 
-};
+typedef BasicSegment<float> Segment;
 
 
 } // namespace geom
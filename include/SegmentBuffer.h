@@ -0,0 +1,91 @@
+#ifndef SEGMENTBUFFER_H_
+#define SEGMENTBUFFER_H_
+
+#include <vector>
+
+#include <Point2D.h>
+
+namespace geom
+{
+
+
+/** An intersection found by SegmentBuffer::intersect(): segment i of the
+ *  first buffer meets segment j of the second at parameter t on i and t2 on
+ *  j. */
+struct SegmentHit
+{
+    int i;
+
+    int j;
+
+    float t;
+
+    float t2;
+};
+
+
+/** Many line segments stored as a structure of arrays (start and end point
+ *  coordinates in four separate arrays), for batch intersection tests.
+ *
+ *  intersect() tests every segment of one buffer against every segment of
+ *  another, 8 pairs per step with AVX2 and 4 with SSE2, using the same
+ *  kernel selection as PointBuffer. Each pair is decided by cross products
+ *  alone, without branches and without dividing; only the parameters of
+ *  actual hits are divided out. Pairs that are (nearly) parallel or contain a
+ *  zero-length segment are handed to GenericLine, so overlapping collinear
+ *  segments are reported as there. All kernels return identical results.
+ */
+class SegmentBuffer
+{
+
+public:
+
+    SegmentBuffer();
+
+    ~SegmentBuffer();
+
+public:
+
+    size_t size() const;
+
+    bool empty() const;
+
+    void reserve(size_t n);
+
+    void clear();
+
+    void push_back(const Point2D& p1, const Point2D& p2);
+
+    /// Appends the n - 1 segments between consecutive points, and the
+    /// closing one from the last to the first point if closed
+    void appendPolyline(const Point2D* points, size_t n, bool closed = false);
+
+    Point2D p1(size_t i) const;
+
+    Point2D p2(size_t i) const;
+
+    /// Appends a hit for every intersection of a segment of this buffer with
+    /// one of other, ordered by i, then j. Returns the number of hits
+    /// appended.
+    size_t intersect(const SegmentBuffer& other,
+                     std::vector<SegmentHit>& hits) const;
+
+    /// The number of hits intersect() would append
+    size_t countIntersections(const SegmentBuffer& other) const;
+
+private:
+
+    std::vector<float> x1_;
+
+    std::vector<float> y1_;
+
+    std::vector<float> x2_;
+
+    std::vector<float> y2_;
+
+};
+
+
+} // namespace geom
+
+#endif // SEGMENTBUFFER_H_
@@ -1,6 +1,8 @@
 #ifndef SEGMENTPOINT_H_
 #define SEGMENTPOINT_H_
 
+#include <type_traits>
+
 #include <Point2D.h>
 #include "GenericShapeElement.h"
 
@@ -8,41 +10,53 @@ namespace geom
 {
 
 
-// Forward declaration
-//class GenericShapeElement;
-
-
-class SegmentPoint : public Point2D
+/** A point on one or two shape elements, together with its parameter on
+ *  each. The point is held as a member rather than inherited from, so a
+ *  SegmentPoint is trivially copyable and not mistaken for a plain point. */
+template <typename T>
+class BasicSegmentPoint
 {
 
 public:
 
-    SegmentPoint(float x, float y, float t, const GenericShapeElement* parent);
+    typedef BasicPoint2D<T> Point;
+
+    typedef BasicGenericShapeElement<T> Element;
+
+    BasicSegmentPoint(T x, T y, T t, const Element* parent);
 
-    SegmentPoint(const Point2D& p, float t, const GenericShapeElement* parent);
+    BasicSegmentPoint(const Point& p, T t, const Element* parent);
 
-    SegmentPoint(
-        const Point2D& p,
-        float t,
-        const GenericShapeElement* parent,
-        float t2,
-        const GenericShapeElement* parent2);
+    BasicSegmentPoint(
+        const Point& p,
+        T t,
+        const Element* parent,
+        T t2,
+        const Element* parent2);
 
-    SegmentPoint(const SegmentPoint* other);
+    BasicSegmentPoint(const BasicSegmentPoint* other);
 
-    ~SegmentPoint();
+    Point p;
 
-    float t;
+    T t;
 
-    const GenericShapeElement* parent;
+    T t2;
 
-    float t2;
+    const Element* parent;
 
-    const GenericShapeElement* parent2;
+    const Element* parent2;
 
 };
 
 
+typedef BasicSegmentPoint<float> SegmentPoint;
+
+
+static_assert(std::is_trivially_copyable<SegmentPoint>::value
+              && std::is_trivially_copyable<BasicSegmentPoint<double> >::value,
+              "SegmentPoint must be trivially copyable");
+
+
 } // namespace geom
 
 #endif // SEGMENTPOINT_H_
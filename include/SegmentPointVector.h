@@ -1,67 +1,363 @@
 #ifndef SEGMENTPOINTVECTOR_H_
 #define SEGMENTPOINTVECTOR_H_
 
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "Arena.h"
 #include "SegmentPoint.h"
-#include "PointerAllocator.h"
-#include <vector>
 #include "GenericShapeElement.h"
 
 namespace geom
 {
 
 
-// Forward declaration
-//class GenericShapeElement;
-
-
-//class SegmentPointVector : public std::vector<SegmentPoint*, PointerAllocator<SegmentPoint*> >
-class SegmentPointVector : public std::vector<SegmentPoint*>
+/** Stores intersection results by value in one contiguous buffer.
+ *
+ *  The first InlineCapacity points are held inside the object itself; only
+ *  beyond that are they moved to the heap. That covers nearly all single
+ *  queries (rect against rect yields at most 8 points, ellipse against
+ *  ellipse at most 4), so a local vector never allocates for them. clear()
+ *  keeps the capacity, so a vector reused across queries stops allocating
+ *  once it has grown to the largest result size.
+ *
+ *  Given an Arena, the vector takes its larger buffers from there instead of
+ *  the global heap, so that the results of a burst of queries are released
+ *  with the arena. The arena must outlive the vector; copies and moves use
+ *  the arena of the vector they are constructed from.
+ *
+ *  The interface is the part of std::vector the library needs; iterators are
+ *  plain pointers, invalidated whenever the size grows beyond the capacity.
+ */
+template <typename T>
+class BasicSegmentPointVector
 {
 
 public:
 
-    /// Needs SegmentPointVector::sort() to be called before construction!
+    typedef BasicSegmentPoint<T> SegPoint;
+
+    typedef BasicGenericShapeElement<T> Element;
+
+    typedef SegPoint value_type;
+
+    typedef SegPoint* iterator;
+
+    typedef const SegPoint* const_iterator;
+
+    typedef SegPoint& reference;
+
+    typedef const SegPoint& const_reference;
+
+    typedef size_t size_type;
+
+    /// Number of points held without an allocation
+    static const size_t InlineCapacity = 8;
+
+    /// Needs BasicSegmentPointVector::sort() to be called before construction!
     class RangeIterator
     {
 
     public:
 
         RangeIterator(
-            const SegmentPointVector& v,
-            const GenericShapeElement* commonParent);
+            const BasicSegmentPointVector& v,
+            const Element* commonParent);
 
         bool endReached() const;
 
         void operator++();
 
-        SegmentPoint* operator*() const;
+        const SegPoint& operator*() const;
 
     private:
 
-        const SegmentPointVector& v_;
+        const BasicSegmentPointVector& v_;
 
-        const GenericShapeElement* commonParent_;
+        const Element* commonParent_;
 
         size_t idx_;
 
     };
 
-    //SegmentPointVector();
+public:
+
+    BasicSegmentPointVector();
+
+    /// Spills to arena, if not null, instead of the heap
+    explicit BasicSegmentPointVector(Arena* arena);
 
-    //~SegmentPointVector();
+    BasicSegmentPointVector(const BasicSegmentPointVector& other);
+
+    /// Takes over the buffer of other, if not inline; other is left empty
+    BasicSegmentPointVector(BasicSegmentPointVector&& other) noexcept;
+
+    ~BasicSegmentPointVector();
+
+    BasicSegmentPointVector& operator=(const BasicSegmentPointVector& other);
+
+    BasicSegmentPointVector& operator=(BasicSegmentPointVector&& other)
+        noexcept;
 
 public:
 
+    size_t size() const;
+
+    bool empty() const;
+
+    size_t capacity() const;
+
+    /// Whether the points are held inline, not on the heap
+    bool isInline() const;
+
+    void reserve(size_t n);
+
+    void clear();
+
+    void push_back(const SegPoint& p);
+
+    void pop_back();
+
+    SegPoint& operator[](size_t i);
+
+    const SegPoint& operator[](size_t i) const;
+
+    SegPoint& front();
+
+    const SegPoint& front() const;
+
+    SegPoint& back();
+
+    const SegPoint& back() const;
+
+    iterator begin();
+
+    iterator end();
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    SegPoint* data();
+
+    const SegPoint* data() const;
+
+    /// Inserts the points first to last, which must not be of this vector,
+    /// before pos. Returns an iterator to the first inserted point.
+    iterator insert(iterator pos, const_iterator first, const_iterator last);
+
+    /// Removes the points first to last; returns an iterator to the point
+    /// after them
+    iterator erase(iterator first, iterator last);
+
+    iterator erase(iterator pos);
+
+    void swap(BasicSegmentPointVector& other);
+
+    /// Orders the points by the id of their parent, then by t; the order
+    /// does not depend on where the parents are in memory. Points without a
+    /// parent go first.
     void sort();
 
-    bool hasPoint(const Point2D& p) const;
+    bool hasPoint(const BasicPoint2D<T>& p) const;
+
+private:
 
-    void deleteReferencedObjectsAndClear();
+    /// Moves the points to a buffer of n points, from the arena if any
+    void grow(size_t n);
 
+    /// push_back() for a full vector; p may be one of its points
+    void pushBackGrow(const SegPoint& p);
+
+    /// Takes over the points of other and leaves it empty
+    void moveFrom(BasicSegmentPointVector& other);
+
+    void release();
+
+private:
+
+    typedef typename std::aligned_storage<sizeof(SegPoint),
+                                          alignof(SegPoint)>::type Storage;
+
+    Arena* arena_;
+
+    SegPoint* data_;
+
+    size_t size_;
+
+    size_t capacity_;
+
+    Storage inline_[InlineCapacity];
 
 };
 
 
+typedef BasicSegmentPointVector<float> SegmentPointVector;
+
+
+// The points are trivially copyable, so they are copied as raw memory and
+// never destroyed; the accessors are inline, as for std::vector
+
+
+template <typename T>
+inline size_t
+BasicSegmentPointVector<T>::size() const
+{
+    return size_;
+}
+
+
+template <typename T>
+inline bool
+BasicSegmentPointVector<T>::empty() const
+{
+    return size_ == 0;
+}
+
+
+template <typename T>
+inline size_t
+BasicSegmentPointVector<T>::capacity() const
+{
+    return capacity_;
+}
+
+
+template <typename T>
+inline bool
+BasicSegmentPointVector<T>::isInline() const
+{
+    return data_ == reinterpret_cast<const SegPoint*>(inline_);
+}
+
+
+template <typename T>
+inline void
+BasicSegmentPointVector<T>::clear()
+{
+    size_ = 0;
+}
+
+
+template <typename T>
+inline void
+BasicSegmentPointVector<T>::push_back(const SegPoint& p)
+{
+    if (size_ == capacity_)
+    {
+        pushBackGrow(p);
+        return;
+    }
+    new (data_ + size_) SegPoint(p);
+    ++size_;
+}
+
+
+template <typename T>
+inline void
+BasicSegmentPointVector<T>::pop_back()
+{
+    --size_;
+}
+
+
+template <typename T>
+inline BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::operator[](size_t i)
+{
+    return data_[i];
+}
+
+
+template <typename T>
+inline const BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::operator[](size_t i) const
+{
+    return data_[i];
+}
+
+
+template <typename T>
+inline BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::front()
+{
+    return data_[0];
+}
+
+
+template <typename T>
+inline const BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::front() const
+{
+    return data_[0];
+}
+
+
+template <typename T>
+inline BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::back()
+{
+    return data_[size_ - 1];
+}
+
+
+template <typename T>
+inline const BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::back() const
+{
+    return data_[size_ - 1];
+}
+
+
+template <typename T>
+inline typename BasicSegmentPointVector<T>::iterator
+BasicSegmentPointVector<T>::begin()
+{
+    return data_;
+}
+
+
+template <typename T>
+inline typename BasicSegmentPointVector<T>::iterator
+BasicSegmentPointVector<T>::end()
+{
+    return data_ + size_;
+}
+
+
+template <typename T>
+inline typename BasicSegmentPointVector<T>::const_iterator
+BasicSegmentPointVector<T>::begin() const
+{
+    return data_;
+}
+
+
+template <typename T>
+inline typename BasicSegmentPointVector<T>::const_iterator
+BasicSegmentPointVector<T>::end() const
+{
+    return data_ + size_;
+}
+
+
+template <typename T>
+inline BasicSegmentPoint<T>*
+BasicSegmentPointVector<T>::data()
+{
+    return data_;
+}
+
+
+template <typename T>
+inline const BasicSegmentPoint<T>*
+BasicSegmentPointVector<T>::data() const
+{
+    return data_;
+}
+
+
 } // namespace geom
 
 
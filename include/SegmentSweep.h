@@ -0,0 +1,58 @@
+#ifndef SEGMENTSWEEP_H_
+#define SEGMENTSWEEP_H_
+
+#include "GenericLine.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+
+/** Finds all intersections among many line segments by a Bentley-Ottmann
+ *  sweep, in O((n + k) log n) for n segments and k intersecting pairs instead
+ *  of the O(n^2) of GenericLine::areIntersectedBy().
+ *
+ *  A vertical sweep line moves from left to right over the segment end points
+ *  and the crossings found so far, which are kept in an event queue. The
+ *  segments currently cut by the sweep line are kept in a balanced tree,
+ *  ordered by their y at the sweep line; only segments that become neighbours
+ *  in that order are tested against each other. All segments through an
+ *  event point are tested pairwise, so shared end points, T-junctions and
+ *  several segments crossing in one point are found as well.
+ *
+ *  Every pair is tested by GenericLine::isIntersectedBy(), so the points,
+ *  parents and t values are the same as those of the brute-force path,
+ *  including the two points of overlapping collinear segments. Each
+ *  intersecting pair is reported once, but not in any particular order.
+ */
+class SegmentSweep
+{
+
+public:
+
+    /// Appends the intersections of all pairs of distinct lines; parent is
+    /// the line of the lower index. Returns the number of points appended.
+    static int findIntersections(const GenericLine lines[],
+                                 int numLines,
+                                 SegmentPointVector& isecPoints);
+
+    /// Appends the intersections of lines with otherLines, as
+    /// GenericLine::areIntersectedBy() does (parent is of lines, parent2 of
+    /// otherLines); pairs within one array are not reported. Returns the
+    /// number of points appended.
+    static int findIntersections(const GenericLine lines[],
+                                 int numLines,
+                                 const GenericLine otherLines[],
+                                 int numOtherLines,
+                                 SegmentPointVector& isecPoints);
+
+private:
+
+    SegmentSweep();
+
+};
+
+
+} // namespace geom
+
+#endif // SEGMENTSWEEP_H_
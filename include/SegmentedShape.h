@@ -1,6 +1,7 @@
 #ifndef SEGMENTEDSHAPE_H_
 #define SEGMENTEDSHAPE_H_
 
+#include "Arena.h"
 #include "Shape.h"
 #include "Segment.h"
 #include "SegmentPointVector.h"
@@ -10,30 +11,117 @@ namespace geom
 {
 
 
-class SegmentedShape
+/** The outline of a shape as a ring of segments, split further at the
+ *  intersections added to it.
+ *
+ *  The segments are records in one contiguous array, linked into the ring
+ *  by index; the first one added is the start of the ring. The array is
+ *  taken from an Arena, either passed in, to be reset by the caller once per
+ *  query or frame together with everything else allocated there, or the
+ *  shape's own and released with it.
+ */
+template <typename T>
+class BasicSegmentedShape
 {
 
 public:
 
-    SegmentedShape(const Shape* shape, Segment* start);
+    typedef BasicSegment<T> Segment;
 
-    ~SegmentedShape();
+    typedef BasicSegmentPoint<T> SegmentPoint;
+
+    typedef BasicSegmentPointVector<T> SegmentPointVector;
+
+    /// Takes the segments from arena, which must outlive the shape, or from
+    /// an arena of its own if null
+    BasicSegmentedShape(const BasicShape<T>* shape, Arena* arena);
+
+    ~BasicSegmentedShape();
 
 public:
 
+    /// Appends a Positive segment to the ring, between the last one and the
+    /// first one
+    void addSegment(const SegmentPoint& start,
+                    typename Segment::ElementKind kind);
+
+    size_t numSegments() const;
+
+    /// Segment i of the ring, counted from its start; segment(i).next is
+    /// i + 1, save for the last one
+    const Segment& segment(size_t i) const;
+
+    /// Splits the segments at the points, which must lie on their parents;
+    /// the new segments are Negative. Points of other parents are ignored.
+    ///
+    /// Sorts p (see SegmentPointVector::sort()) and merges it with the ring
+    /// in one pass, into a new array in ring order; O(n + k) for n segments
+    /// and k points if the parents come along the ring in the order of their
+    /// ids, as they do unless elements were copied around.
     void addIntersections(SegmentPointVector& p);
 
-    friend std::ostream& operator<<(std::ostream& out, const SegmentedShape& s);
+    template <typename U>
+    friend std::ostream& operator<<(std::ostream& out,
+                                    const BasicSegmentedShape<U>& s);
+
+private:
+
+    /// Walks the ring once, starting from the first segment
+    class Iterator
+    {
+
+    public:
+
+        Iterator(const BasicSegmentedShape& shape);
+
+        bool endReached() const;
+
+        void operator++();
+
+        int operator*() const;
+
+    private:
+
+        const BasicSegmentedShape& shape_;
+
+        int current_;
+
+        bool startPassed_;
+
+    };
+
+    void reserve(size_t n);
+
+private:
+
+    BasicSegmentedShape(const BasicSegmentedShape&);
+
+    BasicSegmentedShape& operator=(const BasicSegmentedShape&);
 
 private:
 
-    const Shape* const shape_;
+    const BasicShape<T>* const shape_;
 
-    Segment* start_;
+    Arena ownArena_;
+
+    Arena& arena_;
+
+    Segment* segments_;
+
+    size_t numSegments_;
+
+    size_t capacity_;
 
 };
 
 
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const BasicSegmentedShape<T>& s);
+
+
+typedef BasicSegmentedShape<float> SegmentedShape;
+
+
 } // namespace geom
 
 #endif // SEGMENTEDSHAPE_H_
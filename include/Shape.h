@@ -2,7 +2,7 @@
 #define SHAPE_H_
 
 #include "Dirtable.h"
-#include "GenericRect.h"
+#include "AABox.h"
 #include "SegmentPointVector.h"
 #include "GenericShapeElement.h"
 
@@ -11,64 +11,102 @@ namespace geom
 {
 
 // Forward declarations
-class Triangle;
-class Rectangle;
-class Ellipse;
-class SegmentPoint;
-class SegmentedShape;
+template <typename T>
+class BasicSegmentedShape;
+class Arena;
 
-class Shape : public Dirtable
+
+/// The types of shapes, the same for every instantiation of BasicShape
+struct ShapeTypes
+{
+    enum ShapeType { TRectangle, TTriangle, TEllipse };
+
+    /// The number of shape types; the tables of ShapeDispatch have an entry
+    /// for each combination of two
+    static const int NumShapeTypes = 3;
+};
+
+
+template <typename T>
+class BasicShape : public Dirtable, public ShapeTypes
 {
 
 public:
 
-    enum ShapeType { TRectangle, TTriangle, TEllipse };
+    typedef BasicPoint2D<T> Point;
 
-    Shape(ShapeType type);
+    typedef BasicAABox<T> Box;
 
-    virtual ~Shape();
+    typedef BasicSegmentPointVector<T> PointVector;
+
+    typedef BasicSegmentedShape<T> Outline;
+
+    BasicShape(ShapeType type);
+
+    virtual ~BasicShape();
 
 public:
 
-    void makeClean() const;
+    /// Cleans the shape and everything it derives lazily (bounding box, edge
+    /// lines), so that const queries do not modify it until it is changed
+    /// again. Not needed for correctness, but saves threads querying a shape
+    /// at once from waiting for each other's cleaning.
+    void makeAllClean() const;
+
+    const Box& bb() const;
 
-    const GenericRect& bb() const;
+    ShapeType type() const;
 
-    virtual void moveBy(const Point2D& delta) = 0;
+    virtual void moveBy(const Point& delta) = 0;
 
-    bool isIntersectedBy(const Shape* s,
-                         SegmentPointVector& isecPoints,
+    /// Appends the intersections of the outlines of this and s to
+    /// isecPoints, parent on this and parent2 on s, through the kernel of
+    /// ShapeDispatch for the two types
+    bool isIntersectedBy(const BasicShape* s,
+                         PointVector& isecPoints,
                          int& isecCount) const;
 
-    virtual SegmentedShape* toSegmentedShape() const = 0;
+    /// Whether the outlines of this and s touch; returns on the first
+    /// intersection found and computes no points
+    bool intersects(const BasicShape* s) const;
 
-    virtual bool containsPoint(const Point2D& p) const = 0;
+    /// The number of points isIntersectedBy() would report, without computing
+    /// them
+    int countIntersections(const BasicShape* s) const;
+
+    /// The outline as segments, allocated in arena if not null (see
+    /// SegmentedShape); to be deleted by the caller
+    virtual Outline* toSegmentedShape(Arena* arena = 0) const = 0;
+
+    virtual bool containsPoint(const Point& p) const = 0;
 
 protected:
 
-    virtual bool isIntersectedByRectangle(const Rectangle* r,
-                                          SegmentPointVector& isecPoints,
-                                          int& isecCount) const = 0;
+    /// Updates what the shape derives from its defining data, then the
+    /// bounding box
+    void performCleaning() const;
 
-    virtual bool isIntersectedByTriangle(const Triangle* t,
-                                         SegmentPointVector& isecPoints,
-                                         int& isecCount) const = 0;
+    /// Updates what the subclass derives from its defining data (e.g., edge
+    /// lines); called when the shape is cleaned
+    virtual void performShapeCleaning() const;
 
-    virtual bool isIntersectedByEllipse(const Ellipse* e,
-                                        SegmentPointVector& isecPoints,
-                                        int& isecCount) const = 0;
+    virtual void calculateBoundingBox(Box& bb) const = 0;
 
-    virtual void calculateBoundingBox(GenericRect& bb) const = 0;
+    /// Cleans the elements of the shape for makeAllClean()
+    virtual void makeElementsClean() const;
 
 private:
 
     // Bounding box
-    mutable GenericRect bb_;
+    mutable Box bb_;
 
     const ShapeType type_;
 
 };
 
+
+typedef BasicShape<float> Shape;
+
 } // namespace geom
 
 #endif // SHAPE_H_
@@ -0,0 +1,150 @@
+#ifndef SHAPECLIPPER_H_
+#define SHAPECLIPPER_H_
+
+#include <vector>
+
+#include "Arena.h"
+#include "ClipResult.h"
+#include "SegmentedShape.h"
+#include "SegmentPointVector.h"
+#include "Shape.h"
+
+namespace geom
+{
+
+
+/** Boolean operations on the areas of two shapes, after Weiler and
+ *  Atherton.
+ *
+ *  Both outlines are split at their intersections (Shape::isIntersectedBy(),
+ *  SegmentedShape::addIntersections()), and every piece between two split
+ *  points is located relative to the other shape: inside, outside, or on its
+ *  outline, running the same way or the opposite way. The operation keeps
+ *  some of the pieces, turning around the ones of the second shape inside
+ *  the first for a difference, and chains them into rings where the end of
+ *  one is the start of the next. The intersection points are shared by both
+ *  outlines, so the chaining compares coordinates exactly.
+ *
+ *  After the intersections are found, the n segments of both outlines and
+ *  the k intersections take O((n + k) log (n + k)). Shapes of either
+ *  orientation are accepted; the result is oriented as ClipResult describes.
+ *  Outlines touching in a point, and edges overlapping in a collinear
+ *  stretch, are handled; the location of a piece is decided at its midpoint
+ *  by exact predicates for lines, in double precision for ellipses.
+ *
+ *  The segments of the outlines and the pieces are kept in storage reused by
+ *  the next operation, so a clipper reused for many shapes allocates only
+ *  the two SegmentedShape objects per operation. Not thread-safe; use one
+ *  clipper per thread.
+ */
+template <typename T>
+class BasicShapeClipper
+{
+
+public:
+
+    typedef BasicShape<T> Shape;
+
+    typedef BasicClipResult<T> ClipResult;
+
+    enum Operation { Intersection, Union, Difference, Xor };
+
+    BasicShapeClipper();
+
+    ~BasicShapeClipper();
+
+public:
+
+    /// Replaces result by a op b, where Difference is a minus b. Returns the
+    /// number of rings.
+    size_t clip(const Shape* a, const Shape* b, Operation op,
+                ClipResult& result);
+
+private:
+
+    typedef BasicPoint2D<T> Point;
+
+    typedef BasicSegment<T> Segment;
+
+    typedef BasicSegmentedShape<T> SegmentedShape;
+
+    typedef BasicSegmentPointVector<T> SegmentPointVector;
+
+private:
+
+    /// Where a piece of one outline is relative to the other shape
+    enum Location { Inside, Outside, SameOutline, OppositeOutline };
+
+    /// A part of an outline between two split points, on a single element
+    struct Piece
+    {
+        /// End points in the direction of the element
+        Point from, to;
+
+        T tFrom, tTo;
+
+        const BasicGenericShapeElement<T>* parent;
+
+        typename Segment::ElementKind kind;
+
+        /// 0 for the first shape, 1 for the second
+        int shape;
+
+        /// Whether the piece is kept turned around against its element
+        bool reversed;
+
+        bool used;
+
+        const Point& head() const;
+
+        const Point& tail() const;
+    };
+
+    /// Which way op keeps a piece of shape (0 or 1) at location: 1 along its
+    /// outline, -1 against it, 0 not at all
+    static int keepDirection(Operation op, int shape, Location location);
+
+    /// Appends the pieces of outline that op keeps. sense is 1 for an outline
+    /// running counterclockwise, -1 for one running clockwise.
+    void addPieces(const SegmentedShape& outline, double sense, int shape,
+                   const Shape* other, double otherSense, bool disjoint,
+                   Operation op);
+
+    Location locate(const Piece& piece, double sense, const Shape* other,
+                    double otherSense, bool disjoint) const;
+
+    /// The unused piece starting where piece ends, preferring one of the same
+    /// shape; -1 if none
+    int successor(const Piece& piece) const;
+
+    /// Chains the pieces into rings
+    void buildRings(ClipResult& result);
+
+private:
+
+    BasicShapeClipper(const BasicShapeClipper&);
+
+    BasicShapeClipper& operator=(const BasicShapeClipper&);
+
+private:
+
+    Arena arena_;
+
+    SegmentPointVector points_;
+
+    SegmentPointVector otherPoints_;
+
+    std::vector<Piece> pieces_;
+
+    /// Indices of pieces_, ordered by head
+    std::vector<int> byHead_;
+
+};
+
+
+typedef BasicShapeClipper<float> ShapeClipper;
+
+
+} // namespace geom
+
+#endif // SHAPECLIPPER_H_
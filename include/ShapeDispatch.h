@@ -0,0 +1,121 @@
+#ifndef SHAPEDISPATCH_H_
+#define SHAPEDISPATCH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Shape.h"
+#include "ShapePair.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+
+/** The intersection queries between two shapes, by the types of both.
+ *
+ *  For every combination (A, B) of shape types there is a kernel working on
+ *  the concrete classes: the line counts of A and B are constants and the
+ *  calls below it are not virtual, so each kernel compiles into one function
+ *  of its own. The kernels are gathered in tables of NumShapeTypes x
+ *  NumShapeTypes entries, generated from the list of types at compile time,
+ *  and Shape::isIntersectedBy() and friends take a single indirect call
+ *  through them.
+ *
+ *  Adding a shape type means adding it to ShapeTypes::ShapeType, mapping it to
+ *  its class in ShapeDispatch.cpp and, if it is neither line-based nor an
+ *  ellipse, writing its kernels there; the tables follow by themselves.
+ *
+ *  For many pairs, findIntersections() first groups them by the combination
+ *  of types and then runs each group through the loop of its kernel, so the
+ *  branches taken stay the same from one pair to the next.
+ *
+ *  The kernels and tables exist for each scalar type of the shapes; shapes
+ *  of type T are dispatched through BasicShapeDispatch<T>.
+ */
+template <typename T>
+class BasicShapeDispatch
+{
+
+public:
+
+    typedef BasicShape<T> Shape;
+
+    typedef BasicShapePair<T> ShapePair;
+
+    typedef BasicSegmentPointVector<T> PointVector;
+
+    typedef bool (*IntersectFunc)(const Shape* a,
+                                  const Shape* b,
+                                  PointVector& isecPoints,
+                                  int& isecCount);
+
+    typedef int (*CountFunc)(const Shape* a, const Shape* b, bool stopAtFirst);
+
+    /// The kernel of a->isIntersectedBy(b) for a of type a and b of type b
+    static IntersectFunc intersectFunc(ShapeTypes::ShapeType a,
+                                       ShapeTypes::ShapeType b);
+
+    /// The kernel counting the intersections of a and b, or telling whether
+    /// there is one if stopAtFirst
+    static CountFunc countFunc(ShapeTypes::ShapeType a,
+                               ShapeTypes::ShapeType b);
+
+    /// Reorders pairs so that those of the same combination of types follow
+    /// each other, the combinations in the order of (first->type(),
+    /// second->type()). The reordering is the same for the same input, but
+    /// does not keep the order within a combination.
+    static void groupByTypes(ShapePair* pairs, size_t numPairs);
+
+    /// Groups pairs by groupByTypes(), then tests them the way
+    /// Shape::isIntersectedBy() does, in one loop per combination; the pairs
+    /// that actually intersect are appended to intersecting, their points to
+    /// isecPoints, in the grouped order. Returns the number of intersecting
+    /// pairs.
+    ///
+    /// Without numFailed, an error of the narrow phase is passed on to the
+    /// caller. Otherwise a failing pair counts as not intersecting, the
+    /// points it may have added are dropped, and *numFailed is incremented.
+    static int findIntersections(ShapePair* pairs,
+                                 size_t numPairs,
+                                 std::vector<ShapePair>& intersecting,
+                                 PointVector& isecPoints,
+                                 int* numFailed = 0);
+
+private:
+
+    BasicShapeDispatch();
+
+private:
+
+    static const IntersectFunc* const intersectTable_;
+
+    static const CountFunc* const countTable_;
+
+};
+
+
+typedef BasicShapeDispatch<float> ShapeDispatch;
+
+
+template <typename T>
+inline typename BasicShapeDispatch<T>::IntersectFunc
+BasicShapeDispatch<T>::intersectFunc(ShapeTypes::ShapeType a,
+                                     ShapeTypes::ShapeType b)
+{
+    return intersectTable_[a * ShapeTypes::NumShapeTypes + b];
+}
+
+
+template <typename T>
+inline typename BasicShapeDispatch<T>::CountFunc
+BasicShapeDispatch<T>::countFunc(ShapeTypes::ShapeType a,
+                                 ShapeTypes::ShapeType b)
+{
+    return countTable_[a * ShapeTypes::NumShapeTypes + b];
+}
+
+
+} // namespace geom
+
+#endif // SHAPEDISPATCH_H_
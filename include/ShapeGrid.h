@@ -0,0 +1,150 @@
+#ifndef SHAPEGRID_H_
+#define SHAPEGRID_H_
+
+#include <vector>
+
+#include "AABox.h"
+#include "Dirtable.h"
+#include "Shape.h"
+#include "ShapePair.h"
+#include "CandidatePairSource.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+
+/** A uniform grid over the bounding boxes of shapes, stored as a spatial hash.
+ *
+ *  Works best for many shapes of similar size (particle-like scenes), where
+ *  each shape covers only a few cells. Unless given explicitly, the cell size
+ *  is derived from the mean bounding box extent of the shapes inserted before
+ *  the first query.
+ *
+ *  Binning is done lazily: the grid is dirty until the first query, and again
+ *  after rebuild() or when the hash table has become too small.
+ *
+ *  The grid does not own the shapes.
+ */
+template <typename T>
+class BasicShapeGrid : public Dirtable, public BasicCandidatePairSource<T>
+{
+
+public:
+
+    typedef BasicShape<T> Shape;
+
+    typedef BasicShapePair<T> ShapePair;
+
+    typedef BasicAABox<T> AABox;
+
+    typedef BasicSegmentPointVector<T> SegmentPointVector;
+
+    /// A cellSize <= 0 lets the grid choose the cell size automatically
+    BasicShapeGrid(T cellSize = 0);
+
+    ~BasicShapeGrid();
+
+public:
+
+    void performCleaning() const;
+
+    /// Returns a handle that identifies the shape within this grid
+    int insert(const Shape* shape);
+
+    void remove(int handle);
+
+    /// Re-bins the shape if its bounding box has changed (e.g., after
+    /// Shape::moveBy()); returns whether the set of covered cells changed.
+    /// Shapes whose generation has not changed are skipped right away.
+    bool update(int handle);
+
+    /// Calls update() for every shape; returns the number of re-binned ones
+    int update();
+
+    /// Chooses a new cell size (automatically if cellSize <= 0) and re-bins
+    /// all shapes
+    void rebuild(T cellSize = 0);
+
+    const Shape* shape(int handle) const;
+
+    int size() const;
+
+    T cellSize() const;
+
+    /// Appends every pair of shapes whose bounding boxes overlap, each pair
+    /// once
+    void findPairs(std::vector<ShapePair>& pairs) const;
+
+    /// Runs Shape::isIntersectedBy() on all pairs found by findPairs(); the
+    /// pairs that actually intersect are appended to pairs, their points to
+    /// isecPoints. Returns the number of intersecting pairs. Errors of the
+    /// narrow phase are passed on to the caller.
+    int findIntersections(std::vector<ShapePair>& pairs,
+                          SegmentPointVector& isecPoints) const;
+
+private:
+
+    struct CellRange
+    {
+        int minX, minY, maxX, maxY;
+    };
+
+    struct Entry
+    {
+        const Shape* shape;
+
+        AABox box;
+
+        CellRange cells;
+
+        // Of the shape when box was fetched
+        unsigned long generation;
+
+        bool inUse;
+    };
+
+    int cellCoord(T v) const;
+
+    void cellRange(const AABox& box, CellRange& range) const;
+
+    size_t bucket(int cx, int cy) const;
+
+    void addToBuckets(int handle) const;
+
+    void removeFromBuckets(int handle) const;
+
+private:
+
+    BasicShapeGrid(const BasicShapeGrid&);
+
+    BasicShapeGrid& operator=(const BasicShapeGrid&);
+
+private:
+
+    mutable std::vector<Entry> entries_;
+
+    std::vector<int> freeHandles_;
+
+    // Shape handles per hash bucket; cells whose coordinates hash to the same
+    // bucket share it
+    mutable std::vector<std::vector<int> > buckets_;
+
+    // As requested by the user, <= 0 for automatic
+    T requestedCellSize_;
+
+    mutable T cellSize_;
+
+    mutable T invCellSize_;
+
+    int count_;
+
+};
+
+
+typedef BasicShapeGrid<float> ShapeGrid;
+
+
+} // namespace geom
+
+#endif // SHAPEGRID_H_
@@ -0,0 +1,38 @@
+#ifndef SHAPEPAIR_H_
+#define SHAPEPAIR_H_
+
+namespace geom
+{
+
+
+// Forward declaration
+template <typename T>
+class BasicShape;
+
+
+/** A pair of shapes as reported by the broad-phase structures. */
+template <typename T>
+struct BasicShapePair
+{
+    BasicShapePair()
+    :   first(0),
+        second(0)
+    {}
+
+    BasicShapePair(const BasicShape<T>* first, const BasicShape<T>* second)
+    :   first(first),
+        second(second)
+    {}
+
+    const BasicShape<T>* first;
+
+    const BasicShape<T>* second;
+};
+
+
+typedef BasicShapePair<float> ShapePair;
+
+
+} // namespace geom
+
+#endif // SHAPEPAIR_H_
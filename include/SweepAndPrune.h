@@ -0,0 +1,177 @@
+#ifndef SWEEPANDPRUNE_H_
+#define SWEEPANDPRUNE_H_
+
+#include <vector>
+#include <set>
+
+#include "AABox.h"
+#include "Dirtable.h"
+#include "Shape.h"
+#include "ShapePair.h"
+#include "CandidatePairSource.h"
+#include "SegmentPointVector.h"
+
+namespace geom
+{
+
+
+/** Incremental sweep-and-prune over the bounding boxes of shapes.
+ *
+ *  The box end points are kept sorted along x and y. update() re-sorts them
+ *  by insertion sort, which is close to linear when shapes move only a little
+ *  between two calls (e.g., once per simulation frame). Every swap of two end
+ *  points tells whether two boxes start or stop overlapping along one axis;
+ *  this is used to maintain the set of overlapping pairs, so the pairs that
+ *  were added or removed since the last update are known without a full
+ *  search.
+ *
+ *  Inserted shapes are merged in lazily: the manager is dirty until the next
+ *  query or update(), which sorts all new end points at once and finds their
+ *  overlaps with a single sweep instead of one insertion sort per shape.
+ *
+ *  The manager does not own the shapes.
+ */
+template <typename T>
+class BasicSweepAndPrune : public Dirtable, public BasicCandidatePairSource<T>
+{
+
+public:
+
+    typedef BasicShape<T> Shape;
+
+    typedef BasicShapePair<T> ShapePair;
+
+    typedef BasicAABox<T> AABox;
+
+    typedef BasicSegmentPointVector<T> SegmentPointVector;
+
+    BasicSweepAndPrune();
+
+    ~BasicSweepAndPrune();
+
+public:
+
+    void performCleaning() const;
+
+    /// Returns a handle that identifies the shape within this manager
+    int insert(const Shape* shape);
+
+    void remove(int handle);
+
+    /// Fetches the bounding boxes of the shapes whose generation has changed
+    /// and updates the overlapping pairs; returns the number of pairs added
+    /// or removed since the last update
+    int update();
+
+    const Shape* shape(int handle) const;
+
+    int size() const;
+
+    /// Appends all currently overlapping pairs
+    void findPairs(std::vector<ShapePair>& pairs) const;
+
+    /// Pairs that started overlapping between the last two update() calls
+    /// (including those caused by insert())
+    const std::vector<ShapePair>& addedPairs() const;
+
+    /// Pairs that stopped overlapping between the last two update() calls
+    /// (including those caused by remove())
+    const std::vector<ShapePair>& removedPairs() const;
+
+    /// Runs Shape::isIntersectedBy() on all overlapping pairs; the pairs that
+    /// actually intersect are appended to pairs, their points to isecPoints.
+    /// Returns the number of intersecting pairs. Errors of the narrow phase
+    /// are passed on to the caller.
+    int findIntersections(std::vector<ShapePair>& pairs,
+                          SegmentPointVector& isecPoints) const;
+
+private:
+
+    struct Proxy
+    {
+        const Shape* shape;
+
+        AABox box;
+
+        // Of the shape when box was fetched
+        unsigned long generation;
+
+        bool inUse;
+    };
+
+    struct EndPoint
+    {
+        T value;
+
+        int handle;
+
+        bool isMin;
+
+        /// Min end points go first on ties, so touching boxes overlap
+        bool operator<(const EndPoint& other) const;
+    };
+
+    typedef unsigned long long PairKey;
+
+    struct PairEvent
+    {
+        PairKey key;
+
+        ShapePair pair;
+
+        // +1 for added, -1 for removed
+        int delta;
+
+        bool operator<(const PairEvent& other) const;
+    };
+
+    static PairKey pairKey(int h1, int h2);
+
+    bool overlaps(int h1, int h2) const;
+
+    void sortAxis(int axis);
+
+    void addPair(int h1, int h2) const;
+
+    void removePair(int h1, int h2) const;
+
+    /// Turns the events collected since the last update into the reported
+    /// added and removed pairs
+    void reportEvents();
+
+private:
+
+    BasicSweepAndPrune(const BasicSweepAndPrune&);
+
+    BasicSweepAndPrune& operator=(const BasicSweepAndPrune&);
+
+private:
+
+    std::vector<Proxy> proxies_;
+
+    std::vector<int> freeHandles_;
+
+    mutable std::vector<EndPoint> endPoints_[2];
+
+    // Inserted, but not merged into the end point lists yet
+    mutable std::vector<int> pending_;
+
+    mutable std::set<PairKey> pairs_;
+
+    mutable std::vector<PairEvent> events_;
+
+    std::vector<ShapePair> added_;
+
+    std::vector<ShapePair> removed_;
+
+    int count_;
+
+};
+
+
+typedef BasicSweepAndPrune<float> SweepAndPrune;
+
+
+} // namespace geom
+
+#endif // SWEEPANDPRUNE_H_
@@ -0,0 +1,110 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace geom
+{
+
+
+/** A fixed set of worker threads for data-parallel loops.
+ *
+ *  parallelFor() cuts the index range into chunks and deals them out to the
+ *  threads in contiguous blocks. A thread works through its own block front
+ *  to back; once it runs dry, it steals chunks from the back of the other
+ *  blocks, so uneven chunk costs (e.g., a few expensive ellipse pairs) do not
+ *  leave threads idle.
+ *
+ *  The calling thread takes part in the work, so a pool of n threads starts
+ *  n - 1 of its own. Only one parallelFor() may run at a time.
+ */
+class ThreadPool
+{
+
+public:
+
+    /// The body of a loop: processes the indices [begin, end) on the thread
+    /// with the given index (0 <= thread < numThreads())
+    typedef std::function<void (std::size_t begin, std::size_t end, int thread)>
+        Body;
+
+    /// numThreads <= 0 uses one thread per hardware thread
+    explicit ThreadPool(int numThreads = 0);
+
+    ~ThreadPool();
+
+public:
+
+    int numThreads() const;
+
+    /// Runs body on [0, count) in chunks of grainSize indices and returns when
+    /// all chunks are done. If chunks throw, the exception of the first one
+    /// (by index) is rethrown after the loop has finished.
+    void parallelFor(std::size_t count, std::size_t grainSize, const Body& body);
+
+private:
+
+    struct Queue
+    {
+        std::mutex mutex;
+
+        std::deque<std::size_t> chunks;
+    };
+
+    void workerLoop(int thread);
+
+    void runChunks(int thread);
+
+    bool popChunk(int thread, std::size_t& chunk);
+
+    bool stealChunk(int thread, std::size_t& chunk);
+
+private:
+
+    ThreadPool(const ThreadPool&);
+
+    ThreadPool& operator=(const ThreadPool&);
+
+private:
+
+    std::vector<std::thread> threads_;
+
+    // One per thread, including the calling one
+    std::vector<Queue*> queues_;
+
+    // Guards the fields below and the start and end of a loop
+    std::mutex mutex_;
+
+    std::condition_variable wakeUp_;
+
+    std::condition_variable done_;
+
+    unsigned long generation_;
+
+    int busyThreads_;
+
+    bool stop_;
+
+    const Body* body_;
+
+    std::size_t count_;
+
+    std::size_t grainSize_;
+
+    std::exception_ptr error_;
+
+    std::size_t errorChunk_;
+
+};
+
+
+} // namespace geom
+
+#endif // THREADPOOL_H_
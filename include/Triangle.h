@@ -8,45 +8,52 @@
 namespace geom
 {
 
-class Triangle : public LineBasedShape
+template <typename T>
+class BasicTriangle : public BasicLineBasedShape<T>
 {
 
 public:
 
-    Triangle();
+    typedef BasicPoint2D<T> Point;
 
-    Triangle(const Point2D& p1, const Point2D& p2, const Point2D& p3);
+    /// The number of edges, known at compile time to ShapeDispatch
+    static const int NumLines = 3;
 
-    ~Triangle();
+    BasicTriangle();
 
-public:
+    BasicTriangle(const Point& p1, const Point& p2, const Point& p3);
+
+    ~BasicTriangle();
 
-    void moveBy(const Point2D& delta);
+public:
 
-    void performCleaning() const;
+    void moveBy(const Point& delta);
 
-    void p1p2p3(const Point2D& p1, const Point2D& p2, const Point2D& p3);
+    void performShapeCleaning() const;
 
-    const GenericLine* lines() const;
+    void p1p2p3(const Point& p1, const Point& p2, const Point& p3);
 
-    SegmentedShape* toSegmentedShape() const;
+    BasicSegmentedShape<T>* toSegmentedShape(Arena* arena = 0) const;
 
     int getNumLines() const;
 
-    bool containsPoint(const Point2D& p) const;
+    bool containsPoint(const Point& p) const;
 
 protected:
 
-    void calculateBoundingBox(GenericRect& bb) const;
+    void calculateBoundingBox(BasicAABox<T>& bb) const;
 
 private:
 
-    Point2D p1_;
-    Point2D p2_;
-    Point2D p3_;
+    Point p1_;
+    Point p2_;
+    Point p3_;
 
 };
 
+
+typedef BasicTriangle<float> Triangle;
+
 } // namespace geom
 
 #endif // TRIANGLE_H_
@@ -0,0 +1,605 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+
+#include "GeometryExceptions.h"
+
+namespace geom
+{
+
+
+namespace
+{
+
+    const int nullNode = -1;
+
+}
+
+
+template <typename T>
+bool
+BasicAABBTree<T>::Node::isLeaf() const
+{
+    return child1 == nullNode;
+}
+
+
+template <typename T>
+BasicAABBTree<T>::BasicAABBTree(T margin)
+:   root_(nullNode),
+    freeList_(nullNode),
+    leafCount_(0),
+    margin_(margin)
+{}
+
+
+template <typename T>
+BasicAABBTree<T>::~BasicAABBTree()
+{}
+
+
+template <typename T>
+int
+BasicAABBTree<T>::insert(const Shape* shape)
+{
+    int leaf = allocateNode();
+    Node& n = nodes_[leaf];
+
+    n.box = shape->bb().grown(margin_);
+    n.shape = shape;
+    n.generation = shape->generation();
+    n.height = 0;
+
+    insertLeaf(leaf);
+    ++leafCount_;
+
+    return leaf;
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::remove(int proxyId)
+{
+    if (proxyId < 0 || proxyId >= (int)nodes_.size()
+        || !nodes_[proxyId].isLeaf() || nodes_[proxyId].height != 0)
+    {
+        throw error::GeometryError("AABBTree::remove: invalid proxy id");
+    }
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --leafCount_;
+}
+
+
+template <typename T>
+bool
+BasicAABBTree<T>::update(int proxyId)
+{
+    Node& n = nodes_[proxyId];
+
+    // Unchanged shapes are skipped without computing their bounding box
+    const unsigned long generation = n.shape->generation();
+    if (generation == n.generation)
+    {
+        return false;
+    }
+    n.generation = generation;
+
+    const AABox& box = n.shape->bb();
+
+    if (n.box.contains(box))
+    {
+        return false;
+    }
+
+    removeLeaf(proxyId);
+
+    nodes_[proxyId].box = box.grown(margin_);
+
+    insertLeaf(proxyId);
+
+    return true;
+}
+
+
+template <typename T>
+int
+BasicAABBTree<T>::update()
+{
+    int refitted = 0;
+
+    for (int i = 0; i != (int)nodes_.size(); ++i)
+    {
+        if (nodes_[i].height == 0 && update(i))
+        {
+            ++refitted;
+        }
+    }
+
+    return refitted;
+}
+
+
+template <typename T>
+const BasicShape<T>*
+BasicAABBTree<T>::shape(int proxyId) const
+{
+    return nodes_[proxyId].shape;
+}
+
+
+template <typename T>
+int
+BasicAABBTree<T>::size() const
+{
+    return leafCount_;
+}
+
+
+template <typename T>
+int
+BasicAABBTree<T>::height() const
+{
+    return (root_ == nullNode) ? -1 : nodes_[root_].height;
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::findPairs(std::vector<ShapePair>& pairs) const
+{
+    std::vector<int> stack;
+
+    for (int i = 0; i != (int)nodes_.size(); ++i)
+    {
+        if (nodes_[i].height == 0)
+        {
+            collectPairs(i, stack, pairs);
+        }
+    }
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::query(const AABox& box,
+                        std::vector<const Shape*>& shapes) const
+{
+    if (root_ == nullNode)
+    {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.push_back(root_);
+
+    while (!stack.empty())
+    {
+        const Node& n = nodes_[stack.back()];
+        stack.pop_back();
+
+        if (n.box.overlaps(box))
+        {
+            if (n.isLeaf())
+            {
+                shapes.push_back(n.shape);
+            }
+            else
+            {
+                stack.push_back(n.child1);
+                stack.push_back(n.child2);
+            }
+        }
+    }
+}
+
+
+template <typename T>
+int
+BasicAABBTree<T>::findIntersections(
+    std::vector<ShapePair>& pairs, SegmentPointVector& isecPoints) const
+{
+    std::vector<ShapePair> candidates;
+    findPairs(candidates);
+
+    int numIntersecting = 0;
+    for (size_t i = 0; i != candidates.size(); ++i)
+    {
+        int count = 0;
+        if (candidates[i].first->isIntersectedBy(
+                candidates[i].second, isecPoints, count))
+        {
+            pairs.push_back(candidates[i]);
+            ++numIntersecting;
+        }
+    }
+
+    return numIntersecting;
+}
+
+
+
+
+
+
+
+template <typename T>
+int
+BasicAABBTree<T>::allocateNode()
+{
+    int node;
+
+    if (freeList_ != nullNode)
+    {
+        node = freeList_;
+        freeList_ = nodes_[node].parent;
+    }
+    else
+    {
+        node = (int)nodes_.size();
+        nodes_.push_back(Node());
+    }
+
+    Node& n = nodes_[node];
+    n.parent = nullNode;
+    n.child1 = nullNode;
+    n.child2 = nullNode;
+    n.height = 0;
+    n.shape = 0;
+
+    return node;
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::freeNode(int node)
+{
+    nodes_[node].parent = freeList_;
+    nodes_[node].height = -1;
+    nodes_[node].shape = 0;
+    freeList_ = node;
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::insertLeaf(int leaf)
+{
+    if (root_ == nullNode)
+    {
+        root_ = leaf;
+        nodes_[root_].parent = nullNode;
+        return;
+    }
+
+    // Find the best sibling by descending along the child that causes the
+    // smallest increase in total perimeter (surface area heuristic)
+    const AABox leafBox = nodes_[leaf].box;
+    int index = root_;
+
+    while (!nodes_[index].isLeaf())
+    {
+        const Node& n = nodes_[index];
+
+        AABox combined = n.box.combined(leafBox);
+        T area = n.box.perimeter();
+        T combinedArea = combined.perimeter();
+
+        // Cost of creating a new parent for this node and the new leaf
+        T cost = 2 * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree
+        T inheritanceCost = 2 * (combinedArea - area);
+
+        T childCost[2];
+        int children[2] = { n.child1, n.child2 };
+        for (int c = 0; c != 2; ++c)
+        {
+            const Node& child = nodes_[children[c]];
+            AABox b = leafBox.combined(child.box);
+            if (child.isLeaf())
+            {
+                childCost[c] = b.perimeter() + inheritanceCost;
+            }
+            else
+            {
+                childCost[c] =
+                    b.perimeter() - child.box.perimeter() + inheritanceCost;
+            }
+        }
+
+        if ((cost < childCost[0]) && (cost < childCost[1]))
+        {
+            break;
+        }
+
+        index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    int sibling = index;
+
+    // Create a new parent for sibling and leaf
+    int oldParent = nodes_[sibling].parent;
+    int newParent = allocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].shape = 0;
+    nodes_[newParent].box = leafBox.combined(nodes_[sibling].box);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent != nullNode)
+    {
+        if (nodes_[oldParent].child1 == sibling)
+        {
+            nodes_[oldParent].child1 = newParent;
+        }
+        else
+        {
+            nodes_[oldParent].child2 = newParent;
+        }
+    }
+    else
+    {
+        root_ = newParent;
+    }
+
+    refitUpwards(nodes_[leaf].parent);
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::removeLeaf(int leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = nullNode;
+        return;
+    }
+
+    int parent = nodes_[leaf].parent;
+    int grandParent = nodes_[parent].parent;
+    int sibling = (nodes_[parent].child1 == leaf)
+        ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent != nullNode)
+    {
+        // Replace parent by sibling
+        if (nodes_[grandParent].child1 == parent)
+        {
+            nodes_[grandParent].child1 = sibling;
+        }
+        else
+        {
+            nodes_[grandParent].child2 = sibling;
+        }
+        nodes_[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refitUpwards(grandParent);
+    }
+    else
+    {
+        root_ = sibling;
+        nodes_[sibling].parent = nullNode;
+        freeNode(parent);
+    }
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::refitUpwards(int node)
+{
+    while (node != nullNode)
+    {
+        node = balance(node);
+
+        Node& n = nodes_[node];
+        const Node& c1 = nodes_[n.child1];
+        const Node& c2 = nodes_[n.child2];
+
+        n.height = 1 + std::max(c1.height, c2.height);
+        n.box = c1.box.combined(c2.box);
+
+        node = n.parent;
+    }
+}
+
+
+template <typename T>
+int
+BasicAABBTree<T>::balance(int iA)
+{
+    /* Performs a left or right rotation if node A is imbalanced; returns the
+     * new root of the subtree.
+     *
+     *         A
+     *       /   \
+     *      B     C
+     *     / \   / \
+     *    D   E F   G
+     */
+
+    Node* A = &nodes_[iA];
+    if (A->isLeaf() || A->height < 2)
+    {
+        return iA;
+    }
+
+    int iB = A->child1;
+    int iC = A->child2;
+    Node* B = &nodes_[iB];
+    Node* C = &nodes_[iC];
+
+    int diff = C->height - B->height;
+
+    // Rotate C up
+    if (diff > 1)
+    {
+        int iF = C->child1;
+        int iG = C->child2;
+        Node* F = &nodes_[iF];
+        Node* G = &nodes_[iG];
+
+        // Swap A and C
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        // A's old parent should point to C
+        if (C->parent != nullNode)
+        {
+            if (nodes_[C->parent].child1 == iA)
+            {
+                nodes_[C->parent].child1 = iC;
+            }
+            else
+            {
+                nodes_[C->parent].child2 = iC;
+            }
+        }
+        else
+        {
+            root_ = iC;
+        }
+
+        // Rotate
+        if (F->height > G->height)
+        {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->box = B->box.combined(G->box);
+            C->box = A->box.combined(F->box);
+
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        }
+        else
+        {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->box = B->box.combined(F->box);
+            C->box = A->box.combined(G->box);
+
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (diff < -1)
+    {
+        int iD = B->child1;
+        int iE = B->child2;
+        Node* D = &nodes_[iD];
+        Node* E = &nodes_[iE];
+
+        // Swap A and B
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+
+        // A's old parent should point to B
+        if (B->parent != nullNode)
+        {
+            if (nodes_[B->parent].child1 == iA)
+            {
+                nodes_[B->parent].child1 = iB;
+            }
+            else
+            {
+                nodes_[B->parent].child2 = iB;
+            }
+        }
+        else
+        {
+            root_ = iB;
+        }
+
+        // Rotate
+        if (D->height > E->height)
+        {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->box = C->box.combined(E->box);
+            B->box = A->box.combined(D->box);
+
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        }
+        else
+        {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->box = C->box.combined(D->box);
+            B->box = A->box.combined(E->box);
+
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+
+template <typename T>
+void
+BasicAABBTree<T>::collectPairs(
+    int leaf,
+    std::vector<int>& stack,
+    std::vector<ShapePair>& pairs) const
+{
+    const Node& l = nodes_[leaf];
+
+    stack.clear();
+    stack.push_back(root_);
+
+    while (!stack.empty())
+    {
+        const Node& n = nodes_[stack.back()];
+        int index = stack.back();
+        stack.pop_back();
+
+        if (!n.box.overlaps(l.box))
+        {
+            continue;
+        }
+
+        if (n.isLeaf())
+        {
+            // Report each pair once, from the leaf with the lower index
+            if (index > leaf)
+            {
+                pairs.push_back(ShapePair(l.shape, n.shape));
+            }
+        }
+        else
+        {
+            stack.push_back(n.child1);
+            stack.push_back(n.child2);
+        }
+    }
+}
+
+
+template class BasicAABBTree<float>;
+template class BasicAABBTree<double>;
+
+
+} // namespace geom
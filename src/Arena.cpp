@@ -0,0 +1,79 @@
+#include "Arena.h"
+
+#include <algorithm>
+
+namespace geom
+{
+
+
+Arena::Arena(size_t blockSize)
+:   blockSize_(blockSize),
+    used_(0),
+    ptr_(0),
+    end_(0)
+{}
+
+
+Arena::~Arena()
+{
+    release();
+}
+
+
+void
+Arena::reset()
+{
+    used_ = 0;
+    ptr_ = 0;
+    end_ = 0;
+}
+
+
+void
+Arena::release()
+{
+    for (size_t i = 0; i != blocks_.size(); ++i)
+    {
+        ::operator delete(blocks_[i].begin);
+    }
+    blocks_.clear();
+    reset();
+}
+
+
+size_t
+Arena::capacity() const
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i != blocks_.size(); ++i)
+    {
+        bytes += blocks_[i].size;
+    }
+    return bytes;
+}
+
+
+void*
+Arena::allocateSlow(size_t size, size_t align)
+{
+    // Enough for size bytes at any alignment. The next kept block is used if
+    // large enough, else a new one is put in its place; a smaller one is
+    // moved to the end, for smaller requests after the next reset()
+    size_t needed = size + align - 1;
+    if (used_ == blocks_.size() || blocks_[used_].size < needed)
+    {
+        Block block;
+        block.size = std::max(blockSize_, needed);
+        block.begin = static_cast<char*>(::operator new(block.size));
+        blocks_.push_back(block);
+        std::swap(blocks_[used_], blocks_.back());
+    }
+
+    const Block& block = blocks_[used_++];
+    ptr_ = reinterpret_cast<std::uintptr_t>(block.begin);
+    end_ = ptr_ + block.size;
+    return allocate(size, align);
+}
+
+
+} // namespace geom
@@ -0,0 +1,199 @@
+#include "ClipResult.h"
+
+#include <cmath>
+
+#include "GenericArc.h"
+#include "GenericEllipse.h"
+
+
+namespace geom
+{
+
+
+namespace
+{
+
+    const double pi = std::atan(1.) * 4.;
+
+
+    /// Twice the area swept by the segment from p to q, seen from the origin
+    template <typename T>
+    double
+    sweptArea(const BasicSegment<T>& segm, const BasicPoint2D<T>& q)
+    {
+        const BasicPoint2D<T>& p = segm.start.p;
+        if (segm.kind == BasicSegment<T>::LineElement)
+        {
+            return (double)p.x * q.y - (double)p.y * q.x;
+        }
+
+        // By Green's theorem, for x = c.x + a cos(u), y = c.y + b sin(u) from
+        // u1 to u2: c x (q - p) + a b (u2 - u1). An arc spans less than a
+        // quadrant, so u2 - u1 is the difference of least magnitude.
+        const BasicGenericArc<T>* arc =
+            static_cast<const BasicGenericArc<T>*>(segm.start.parent);
+        const BasicGenericEllipse<T>* e = arc->ellipse();
+        const BasicPoint2D<T>& c = e->center();
+        const BasicPoint2D<T>& r = e->radius();
+        double u1 = std::atan2(((double)p.y - c.y) / r.y,
+                               ((double)p.x - c.x) / r.x);
+        double u2 = std::atan2(((double)q.y - c.y) / r.y,
+                               ((double)q.x - c.x) / r.x);
+        double du = u2 - u1;
+        if (du > pi)
+        {
+            du -= 2. * pi;
+        }
+        else if (du < -pi)
+        {
+            du += 2. * pi;
+        }
+        return (double)c.x * (q.y - p.y) - (double)c.y * (q.x - p.x)
+            + (double)r.x * r.y * du;
+    }
+
+}
+
+
+template <typename T>
+BasicClipResult<T>::BasicClipResult()
+:   ringBegins_(1, 0)
+{}
+
+
+template <typename T>
+void
+BasicClipResult<T>::clear()
+{
+    segments_.clear();
+    ringBegins_.resize(1);
+}
+
+
+template <typename T>
+bool
+BasicClipResult<T>::empty() const
+{
+    return ringBegins_.size() == 1;
+}
+
+
+template <typename T>
+size_t
+BasicClipResult<T>::numRings() const
+{
+    return ringBegins_.size() - 1;
+}
+
+
+template <typename T>
+size_t
+BasicClipResult<T>::ringBegin(size_t i) const
+{
+    return ringBegins_[i];
+}
+
+
+template <typename T>
+size_t
+BasicClipResult<T>::ringEnd(size_t i) const
+{
+    return ringBegins_[i + 1];
+}
+
+
+template <typename T>
+size_t
+BasicClipResult<T>::numSegments() const
+{
+    return ringBegins_.back();
+}
+
+
+template <typename T>
+const BasicSegment<T>&
+BasicClipResult<T>::segment(size_t i) const
+{
+    return segments_[i];
+}
+
+
+template <typename T>
+double
+BasicClipResult<T>::ringArea(size_t i) const
+{
+    double area = 0.;
+    for (size_t s = ringBegin(i); s != ringEnd(i); ++s)
+    {
+        area += sweptArea(segments_[s], segments_[segments_[s].next].start.p);
+    }
+    return 0.5 * area;
+}
+
+
+template <typename T>
+double
+BasicClipResult<T>::area() const
+{
+    double area = 0.;
+    for (size_t i = 0; i != numRings(); ++i)
+    {
+        area += ringArea(i);
+    }
+    return area;
+}
+
+
+template <typename T>
+void
+BasicClipResult<T>::addSegment(const Segment& segm)
+{
+    if (segments_.size() != ringBegins_.back())
+    {
+        const Segment& last = segments_.back();
+        if (last.start.parent == segm.start.parent && last.type == segm.type)
+        {
+            return;
+        }
+    }
+    segments_.push_back(segm);
+}
+
+
+template <typename T>
+void
+BasicClipResult<T>::endRing()
+{
+    size_t begin = ringBegins_.back();
+    size_t end = segments_.size();
+
+    // The last segment may continue into the first one
+    if (end - begin > 1
+        && segments_[end - 1].start.parent == segments_[begin].start.parent
+        && segments_[end - 1].type == segments_[begin].type)
+    {
+        segments_[begin] = segments_[end - 1];
+        segments_.pop_back();
+        --end;
+    }
+
+    // A single segment cannot enclose an area
+    if (end - begin < 2)
+    {
+        segments_.erase(segments_.begin() + begin, segments_.end());
+        return;
+    }
+
+    for (size_t s = begin; s != end; ++s)
+    {
+        segments_[s].next = s + 1 != end ? (int)s + 1 : (int)begin;
+    }
+    ringBegins_.push_back(end);
+}
+
+
+template class BasicClipResult<float>;
+template class BasicClipResult<double>;
+
+
+} // namespace geom
@@ -1,23 +1,100 @@
 #include "Dirtable.h"
 
+#include <thread>
+
 
 Dirtable::Dirtable()
-:   dirty_(true)
+:   state_(Dirty),
+    generation_(0)
 {}
 
 
 Dirtable::Dirtable(bool state)
-:   dirty_(state)
+:   state_(state ? Dirty : Clean),
+    generation_(0)
+{}
+
+
+Dirtable::Dirtable(const Dirtable& other)
+:   state_(copyableState(other)),
+    generation_(0)
 {}
 
 
+Dirtable&
+Dirtable::operator=(const Dirtable& other)
+{
+    state_.store(copyableState(other), std::memory_order_release);
+    generation_.store(generation_.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    return *this;
+}
+
+
 Dirtable::~Dirtable()
 {}
 
 
+bool
+Dirtable::isDirty() const
+{
+    return state_.load(std::memory_order_acquire) != Clean;
+}
+
+
+unsigned long
+Dirtable::generation() const
+{
+    return generation_.load(std::memory_order_relaxed);
+}
+
+
+void
+Dirtable::markDirty()
+{
+    // No read-modify-write needed, there is only one modifying thread
+    generation_.store(generation_.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    state_.store(Dirty, std::memory_order_release);
+}
+
+
 void
 Dirtable::makeClean() const
 {
-    performCleaning();
-    dirty_ = false;
+    int expected = Dirty;
+    while (!state_.compare_exchange_strong(expected, Cleaning,
+                                           std::memory_order_acquire))
+    {
+        // Clean already, or another thread is cleaning; cleaning is short,
+        // so wait for it to finish. If it failed, the object is dirty again
+        // and this thread tries cleaning itself.
+        while (expected == Cleaning)
+        {
+            std::this_thread::yield();
+            expected = state_.load(std::memory_order_acquire);
+        }
+        if (expected == Clean)
+        {
+            return;
+        }
+    }
+
+    try
+    {
+        performCleaning();
+    }
+    catch (...)
+    {
+        state_.store(Dirty, std::memory_order_release);
+        throw;
+    }
+    state_.store(Clean, std::memory_order_release);
+}
+
+
+int
+Dirtable::copyableState(const Dirtable& other)
+{
+    return other.state_.load(std::memory_order_acquire) == Clean ? Clean : Dirty;
 }
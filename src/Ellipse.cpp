@@ -1,113 +1,103 @@
 #include "Ellipse.h"
 
-#include "Rectangle.h"
-#include "Triangle.h"
 #include "SegmentPoint.h"
 #include "SegmentedShape.h"
-#include "EllipseSegment.h"
 #include "Limits.h"
 #include "Helpers.h"
 #include <cmath>
 
 
+// Changes to the ellipse part mark the shape as well (see markDirty()), so
+// the shape part tells whether the bounding box is up to date
 #define ELLIPSE_CLEAN_IF_DIRTY(pdirtable)   \
-    if (GenericEllipse::dirty_)             \
-    {                                       \
-        Shape::dirty_ = true;               \
-        Shape::makeClean();                 \
-    }
+    CLEAN_IF_DIRTY(static_cast<const BasicShape<T>*>(pdirtable))
 
 
 namespace geom
 {
 
 
-Ellipse::Ellipse()
-:   GenericEllipse(),
-    Shape(TEllipse)
+template <typename T>
+BasicEllipse<T>::BasicEllipse()
+:   BasicGenericEllipse<T>(),
+    BasicShape<T>(ShapeTypes::TEllipse)
 {}
 
 
-Ellipse::Ellipse(const Point2D& center, const Point2D& radius)
-:   GenericEllipse(center, radius),
-    Shape(TEllipse)
+template <typename T>
+BasicEllipse<T>::BasicEllipse(const Point& center, const Point& radius)
+:   BasicGenericEllipse<T>(center, radius),
+    BasicShape<T>(ShapeTypes::TEllipse)
 {}
 
 
-Ellipse::~Ellipse()
+template <typename T>
+BasicEllipse<T>::~BasicEllipse()
 {}
 
 
+template <typename T>
 void
-Ellipse::performCleaning() const
+BasicEllipse<T>::markDirty()
 {
-    // Nothing to do here, since radius and center are always up to date
-}
-
-void
-Ellipse::calculateBoundingBox(GenericRect& bb) const
-{
-    bb.p1(center_ - radius_);
-    bb.p2(center_ + radius_);
+    BasicShape<T>::markDirty();
+    BasicGenericEllipse<T>::markDirty();
 }
 
 
+template <typename T>
 void
-Ellipse::moveBy(const Point2D& delta)
+BasicEllipse<T>::calculateBoundingBox(BasicAABox<T>& bb) const
 {
-    GenericEllipse::moveBy(delta);
-    GenericEllipse::dirty_ = true;
+    bb = BasicAABox<T>::fromCorners(this->center_ - this->radius_,
+                                    this->center_ + this->radius_);
 }
 
 
-bool
-Ellipse::isIntersectedByRectangle(
-    const Rectangle* r, SegmentPointVector& isecPoints, int& isecCount) const
-{
-    return isIntersectedByLineBasedShape(r, isecPoints, isecCount);
-}
-
-
-bool
-Ellipse::isIntersectedByTriangle(
-    const Triangle* t, SegmentPointVector& isecPoints, int& isecCount) const
+template <typename T>
+void
+BasicEllipse<T>::moveBy(const Point& delta)
 {
-    return isIntersectedByLineBasedShape(t, isecPoints, isecCount);
+    BasicGenericEllipse<T>::moveBy(delta);
 }
 
 
-bool
-Ellipse::isIntersectedByEllipse(
-    const Ellipse* e, SegmentPointVector& isecPoints, int& isecCount) const
+template <typename T>
+void
+BasicEllipse<T>::makeElementsClean() const
 {
-    return GenericEllipse::isIntersectedBy(e, isecPoints, isecCount);
+    BasicGenericEllipse<T>::makeClean();
 }
 
 
-SegmentedShape*
-Ellipse::toSegmentedShape() const
+template <typename T>
+BasicSegmentedShape<T>*
+BasicEllipse<T>::toSegmentedShape(Arena* arena) const
 {
     ELLIPSE_CLEAN_IF_DIRTY(this);
 
+    typedef BasicSegmentPoint<T> SegmentPoint;
+    const Point& c = this->center_;
+    const Point& r = this->radius_;
     SegmentPoint sp[] = {
-        SegmentPoint(center_ + Point2D(0, radius_.y), 0.f, &quadrant_[0]),
-        SegmentPoint(center_ + Point2D(radius_.x, 0), 0.f, &quadrant_[1]),
-        SegmentPoint(center_ - Point2D(0, radius_.y), 0.f, &quadrant_[2]),
-        SegmentPoint(center_ - Point2D(radius_.x, 0), 0.f, &quadrant_[3])
+        SegmentPoint(c + Point(0, r.y), 0, &this->quadrant_[0]),
+        SegmentPoint(c + Point(r.x, 0), 0, &this->quadrant_[1]),
+        SegmentPoint(c - Point(0, r.y), 0, &this->quadrant_[2]),
+        SegmentPoint(c - Point(r.x, 0), 0, &this->quadrant_[3])
     };
 
-    EllipseSegment* q4 = new EllipseSegment(sp[3], Segment::Positive);
-    EllipseSegment* q3 = new EllipseSegment(sp[2], q4, Segment::Positive);
-    EllipseSegment* q2 = new EllipseSegment(sp[1], q3, Segment::Positive);
-    EllipseSegment* q1 = new EllipseSegment(sp[0], q2, Segment::Positive);
-    q4->next(q1);
-
-    return new SegmentedShape(this, q1);
+    BasicSegmentedShape<T>* shape = new BasicSegmentedShape<T>(this, arena);
+    for (int i = 0; i != 4; ++i)
+    {
+        shape->addSegment(sp[i], BasicSegment<T>::ArcElement);
+    }
+    return shape;
 }
 
 
+template <typename T>
 bool
-Ellipse::containsPoint(const Point2D& p) const
+BasicEllipse<T>::containsPoint(const Point& p) const
 {
     ELLIPSE_CLEAN_IF_DIRTY(this);
 
@@ -117,29 +107,14 @@ Ellipse::containsPoint(const Point2D& p) const
     // --------------------- + --------------------- <= 1
     //     radius_.x^2             radius_.y^2
 
-    Point2D p0 = (p - center_);
-    p0 = (p0 * p0) / (radius_ * radius_);
-    return (p0.x + p0.y) <= 1.f;
+    Point p0 = (p - this->center_);
+    p0 = (p0 * p0) / (this->radius_ * this->radius_);
+    return (p0.x + p0.y) <= 1;
 }
 
 
-bool
-Ellipse::isIntersectedByLineBasedShape(
-    const LineBasedShape* s,
-    SegmentPointVector& isecPoints,
-    int& isecCount) const
-{
-    ELLIPSE_CLEAN_IF_DIRTY(this);
-
-    if (!bb().isIntersectedByRect(s->bb()))
-    {
-        isecCount = 0;
-        return false;
-    }
-
-    return GenericEllipse::isIntersectedBy(
-        s->lines(), s->getNumLines(), isecPoints, isecCount);
-}
+template class BasicEllipse<float>;
+template class BasicEllipse<double>;
 
 
 } // namespace geom
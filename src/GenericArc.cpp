@@ -16,14 +16,16 @@ namespace geom
 {
 
 
-GenericArc::GenericArc(GenericEllipse* ellipse, int qIdx)
+template <typename T>
+BasicGenericArc<T>::BasicGenericArc(BasicGenericEllipse<T>* ellipse, int qIdx)
 :   ellipse_(ellipse),
     qIdx_(qIdx)
 {}
 
 
+template <typename T>
 bool
-GenericArc::containsPoint(const Point2D& p, float& t) const
+BasicGenericArc<T>::containsPoint(const BasicPoint2D<T>& p, T& t) const
 {
     if ((ellipse_->getQuadrant(p) == this) && ellipse_->isIntersectedByPoint(p))
     {
@@ -34,12 +36,15 @@ GenericArc::containsPoint(const Point2D& p, float& t) const
 }
 
 
-float
-GenericArc::getT(const Point2D& p) const
+template <typename T>
+T
+BasicGenericArc<T>::getT(const BasicPoint2D<T>& p) const
 {
-    // Calculating t requires mapping point into Q0
+    // Calculating t requires mapping point into Q0. t grows clockwise, from
+    // the start of the quadrant (the top, right, bottom and left end of the
+    // ellipse for Q0 to Q3) to its end, as the outline runs
 
-    const Point2D& c = ellipse_->center();
+    const BasicPoint2D<T>& c = ellipse_->center();
     switch (qIdx_)
     {
     case 0:
@@ -48,11 +53,11 @@ GenericArc::getT(const Point2D& p) const
             // TODO really needed? should suffice to test against p == (0,0)
             if (p.x == c.x)
             {
-                return 0.f;
+                return T(0);
             }
 
-            Point2D d = p.abs() - c;
-            float t = 1.0 - atan2(d.y, d.x) / (0.5 * pi);
+            BasicPoint2D<T> d = (p - c).abs();
+            T t = 1.0 - atan2(d.y, d.x) / (0.5 * pi);
             return t;
         }
     case 1:
@@ -61,13 +66,13 @@ GenericArc::getT(const Point2D& p) const
             // TODO really needed? should suffice to test against p == (0,0)
             if (p.y == c.y)
             {
-                return 0.f;
+                return T(0);
             }
 
             // Swap x and y since in Q1 and Q3, t = 0 for y = 0 and t grows with
             // greater absolute values of y
-            Point2D d(std::abs(p.y - c.x), std::abs(p.x - c.y));
-            float t = 1.0 - atan2(d.y, d.x) / (0.5 * pi);
+            BasicPoint2D<T> d(std::abs(p.y - c.y), std::abs(p.x - c.x));
+            T t = 1.0 - atan2(d.y, d.x) / (0.5 * pi);
             return t;
         }
     default:
@@ -76,4 +81,16 @@ GenericArc::getT(const Point2D& p) const
 }
 
 
+template <typename T>
+const BasicGenericEllipse<T>*
+BasicGenericArc<T>::ellipse() const
+{
+    return ellipse_;
+}
+
+
+template class BasicGenericArc<float>;
+template class BasicGenericArc<double>;
+
+
 } // namespace geom
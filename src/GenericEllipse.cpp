@@ -3,80 +3,190 @@
 #include "Limits.h"
 #include "Helpers.h"
 //#include "Point2D.h"
-#include "GenericRect.h"
 #include "SegmentPoint.h"
 #include "RootSolvers.h"
 #include "GeometryExceptions.h"
 
-#include <iostream>
+#include <algorithm>
+
+namespace
+{
+
+    // The intersection of a circle around the origin with an ellipse:
+    // Circle:
+    //     x^2 + y^2 = r^2
+    // Ellipse:
+    //     (x - c)^2 / a^2 + (y - d)^2 / b^2 = 1
+    // Solving for x leads to a quartic polynomial (see below), each real root
+    // of which is the x coordinate of an intersection point.
+    template <typename T>
+    struct EllipseQuartic
+    {
+        // Takes circle center and radius, ellipse center and radii
+        EllipseQuartic(
+            const geom::BasicPoint2D<T>& m1,
+            const geom::BasicPoint2D<T>& r1,
+            const geom::BasicPoint2D<T>& m2,
+            const geom::BasicPoint2D<T>& r2)
+        {
+            // Translate whole coordinate system so ellipse (circle) 1's center
+            // is at origin to simplify our calculation; don't forget to
+            // re-translate later.
+            // Ellipse 2 is now: (x - c)^2 / a^2 + (y - d)^2 / b^2 = 1
+            c = m2.x - m1.x;
+            d = m2.y - m1.y;
+
+            double a_squ = r2.x * r2.x;
+            double b_squ = r2.y * r2.y;
+            double b_squ_div_a_squ = b_squ / a_squ;
+            double d_squ = d*d;
+            r_squ = r1.x * r1.x;
+
+            // P = b^2 / a^2 - 1
+            pp = b_squ_div_a_squ - 1.;
+            // Q = -2 * b^2 / a^2 * c
+            qq = -2. * b_squ_div_a_squ * c;
+            // R = r^2 + d^2 - b^2 + b^2 / a^2 *c^2
+            rr = r_squ + d_squ - b_squ + b_squ_div_a_squ * (c*c);
+
+            // Formula:
+            // 0 =
+            // (P^2)x^4 + (2PQ)x^3 + (Q^2 + 2PR + 4d^2)x^2 + (2QR)x + R^2 - 4(d^2)(r^2)
+
+            // alpha = P^2
+            coeffs[0] = pp*pp;
+            // beta = 2PQ
+            coeffs[1] = 2. * pp * qq;
+            // gamma = Q^2 + 2PR + 4d^2
+            coeffs[2] = qq*qq + (2. * pp * rr) + (4. * d_squ);
+            // delta = 2QR
+            coeffs[3] = 2. * qq * rr;
+            // epsilon = R^2 - 4(d^2)(r^2)
+            coeffs[4] = (rr*rr) - (4. * d_squ * r_squ);
+        }
+
+        // With both centers on one horizontal line (d == 0), the quartic
+        // degenerates to (Px^2 + Qx + R)^2 = 0: returns the distinct roots
+        // of Px^2 + Qx + R in x, each standing for the points (x, +-y)
+        int horizontalRoots(double x[2]) const
+        {
+            int numRoots = 0;
+            if (pp == 0.)
+            {
+                if (qq != 0.)
+                {
+                    x[numRoots++] = -rr / qq;
+                }
+            }
+            else
+            {
+                double disc = qq * qq - 4. * pp * rr;
+                if (disc >= 0.)
+                {
+                    double discSqrt = std::sqrt(disc);
+                    x[numRoots++] = (-qq + discSqrt) / (2. * pp);
+                    if (disc > 0.)
+                    {
+                        x[numRoots++] = (-qq - discSqrt) / (2. * pp);
+                    }
+                }
+            }
+            return numRoots;
+        }
+
+        double c, d, r_squ, pp, qq, rr;
+
+        double coeffs[5];
+    };
+
+}
+
 
 namespace geom
 {
 
 
-GenericEllipse::GenericEllipse()
-:   center_(Point2D(0,0)),
-    radius_(Point2D(1,1)),
-    quadrant_((GenericArc[]) {
-        GenericArc(this, 0), GenericArc(this, 1), GenericArc(this, 2), GenericArc(this, 3) })
+template <typename T>
+BasicGenericEllipse<T>::BasicGenericEllipse()
+:   center_(Point(0,0)),
+    radius_(Point(1,1)),
+    quadrant_((Arc[]) {
+        Arc(this, 0), Arc(this, 1), Arc(this, 2), Arc(this, 3) })
 {}
 
 
-GenericEllipse::GenericEllipse(const Point2D& center, const Point2D& radius)
+template <typename T>
+BasicGenericEllipse<T>::BasicGenericEllipse(
+    const Point& center, const Point& radius)
 :   center_(center),
     radius_(radius),
-    quadrant_((GenericArc[]) {
-        GenericArc(this, 0), GenericArc(this, 1), GenericArc(this, 2), GenericArc(this, 3) })
+    quadrant_((Arc[]) {
+        Arc(this, 0), Arc(this, 1), Arc(this, 2), Arc(this, 3) })
 {}
 
 
-GenericEllipse::~GenericEllipse()
+template <typename T>
+BasicGenericEllipse<T>::~BasicGenericEllipse()
 {}
 
 
-GenericEllipse&
-GenericEllipse::moveBy(const Point2D& delta)
+template <typename T>
+void
+BasicGenericEllipse<T>::performCleaning() const
+{
+    // Nothing to do here, since radius and center are always up to date
+}
+
+
+template <typename T>
+BasicGenericEllipse<T>&
+BasicGenericEllipse<T>::moveBy(const Point& delta)
 {
     center_ += delta;
-    dirty_ = true;
+    markDirty();
     return *this;
 }
 
 
-const Point2D&
-GenericEllipse::center() const
+template <typename T>
+const BasicPoint2D<T>&
+BasicGenericEllipse<T>::center() const
 {
     return center_;
 }
 
 
+template <typename T>
 void
-GenericEllipse::center(const Point2D& center)
+BasicGenericEllipse<T>::center(const Point& center)
 {
     center_ = center;
-    dirty_ = true;
+    markDirty();
 }
 
 
-const Point2D&
-GenericEllipse::radius() const
+template <typename T>
+const BasicPoint2D<T>&
+BasicGenericEllipse<T>::radius() const
 {
     return radius_;
 }
 
 
+template <typename T>
 void
-GenericEllipse::radius(const Point2D& radius)
+BasicGenericEllipse<T>::radius(const Point& radius)
 {
     radius_ = radius;
-    dirty_ = true;
+    markDirty();
 }
 
 
+template <typename T>
 bool
-GenericEllipse::isIntersectedBy(
-    const GenericEllipse* e,
-    SegmentPointVector& isecPoints,
+BasicGenericEllipse<T>::isIntersectedBy(
+    const BasicGenericEllipse* e,
+    PointVector& isecPoints,
     int& isecCount) const
 {
     isecCount = 0;
@@ -94,73 +204,23 @@ GenericEllipse::isIntersectedBy(
     // For the calculation, make ellipse 1's vertical radius equal to the
     // horizontal one such that we have a circle, and scale the coordinate
     // system accordingly
-    Point2D scale(1.f, radius_.x / radius_.y);
-    Point2D m1 = center_ * scale;
-    Point2D r1 = radius_ * scale;
-    Point2D m2 = e->center_ * scale;
-    Point2D r2 = e->radius_ * scale;
-
-    geom::GenericRect bb1(m1 - r1, m1 + r1);
-    geom::GenericRect bb2(m2 - r2, m2 + r2);
-
-    // The rectangle enclosing the area in which the intersection point(s) is
-    // (are) located
-    GenericRect searchRect;
-    if (!bb1.isIntersectedByRect(bb2, searchRect))
+    Point scale(1.f, radius_.x / radius_.y);
+    Point m1 = center_ * scale;
+    Point r1 = radius_ * scale;
+    Point m2 = e->center_ * scale;
+    Point r2 = e->radius_ * scale;
+
+    // Bounding box test of the scaled ellipses
+    Point centerDist = (m2 - m1).abs();
+    Point maxDist = r1 + r2;
+    if ((centerDist.x > maxDist.x) || (centerDist.y > maxDist.y))
     {
         return false;
     }
 
-    // Translate whole coordinate system so ellipse (circle) 1's center is at
-    // origin to simplify our calculation; don't forget to re-translate later.
-    // Ellipse 2 is now: (x - c)^2 / a^2 + (y - d)^2 / b^2 = 1
-    double c = m2.x - m1.x;
-    double d = m2.y - m1.y;
-
-    double a_squ = r2.x * r2.x;
-    double b_squ = r2.y * r2.y;
-    double b_squ_div_a_squ = b_squ / a_squ;
-    double r_squ = r1.x * r1.x;
-    double d_squ = d*d;
-
-    // P = b^2 / a^2 - 1
-    double pp = b_squ_div_a_squ - 1.;
-    // Q = -2 * b^2 / a^2 * c
-    double qq = -2. * b_squ_div_a_squ * c;
-    // R = r^2 + d^2 - b^2 + b^2 / a^2 *c^2
-    double rr = r_squ + d_squ - b_squ + b_squ_div_a_squ * (c*c);
-
-    double qq_squ = qq*qq;
-
-    // Formula:
-    // 0 =
-    // (P^2)x^4 + (2PQ)x^3 + (Q^2 + 2PR + 4d^2)x^2 + (2QR)x + R^2 - 4(d^2)(r^2)
-
-    // alpha = P^2
-    double alpha = pp*pp;
-    // beta = 2PQ
-    double beta = 2. * pp * qq;
-    // gamma = Q^2 + 2PR + 4d^2
-    double gamma = qq_squ + (2. * pp * rr) + (4. * d_squ);
-    // delta = 2QR
-    double delta = 2. * qq * rr;
-    // epsilon = R^2 - 4(d^2)(r^2)
-    double epsilon = (rr*rr) - (4. * d_squ * r_squ);
-
-    // Now solve alpha*x^4 + beta*x^3 + gamma*x^2 + delta*x + epsilon = 0
-    double roots[4];
-    int numRoots;
-    quarticPolynomialRoots(alpha, beta, gamma, delta, epsilon, roots, numRoots);
-
-
-    float fx[4], fy[4];
-    for (int i = 0; i != numRoots; ++i)
-    {
-        // Rescale and retranslate y to normal coordinate system
-        // y = sqrt(r^2 - x^2)
-        fy[i] = (std::sqrt(r_squ - roots[i] * roots[i]) + m1.y) / scale.y;
-        fx[i] = roots[i] + m1.x;
-    }
+    T fx[4], fy[4];
+    int numRoots = 0;
+    EllipseQuartic<T> q(m1, r1, m2, r2);
 
     // Handle identical ellipses case
     if ((center_ == e->center_) && (radius_ == e->radius_))
@@ -169,29 +229,88 @@ GenericEllipse::isIntersectedBy(
         fx[0] = center_.x;
         fy[0] = center_.y + radius_.y;
     }
-    // Handle symmetric case where every x corresponds to two roots (x, +-y).
-    // For some cases (two circles intersecting only, it seems), only one or two
-    // roots will be found by solving the polynomial, so we have to add the
-    // missing roots.
-    else if ((center_.y == e->center_.y) && ((numRoots == 1) || (numRoots == 2)))
+    // Handle symmetric case, both centers on one horizontal line, where every
+    // x corresponds to the two points (x, +-y), or to one where they touch;
+    // the same closed form as in countIntersections()
+    else if (q.d == 0.)
     {
-        std::cout << "numroots "<< numRoots << std::endl;
-        for (int i = 0; i != numRoots; ++i)
+        double x[2];
+        int numX = q.horizontalRoots(x);
+        for (int i = 0; i != numX; ++i)
         {
-            fx[i + numRoots] = fx[i];
-            fy[i + numRoots] = 2. * center_.y - fy[i];
+            double y_squ = q.r_squ - x[i] * x[i];
+            if (nearZero(y_squ))
+            {
+                fx[numRoots] = x[i] + m1.x;
+                fy[numRoots++] = center_.y;
+            }
+            else if (y_squ > 0.)
+            {
+                double y = std::sqrt(y_squ);
+                fx[numRoots] = x[i] + m1.x;
+                fy[numRoots++] = (m1.y + y) / scale.y;
+                fx[numRoots] = x[i] + m1.x;
+                fy[numRoots++] = (m1.y - y) / scale.y;
+            }
         }
-        numRoots *= 2;
     }
     else
     {
+        // Now solve alpha*x^4 + beta*x^3 + gamma*x^2 + delta*x + epsilon = 0
+        double roots[4];
+        int numSolved;
+        quarticPolynomialRoots(q.coeffs[0], q.coeffs[1], q.coeffs[2],
+                               q.coeffs[3], q.coeffs[4], roots, numSolved);
+
+        // The distinct roots in [-r, r], a double root where the ellipses
+        // touch counting once, are the points countIntersections() counts.
+        // The closed-form solver loses roots when the quartic is close to a
+        // square (centers at almost the same y) and may split a double root;
+        // when its roots do not add up to the count, they are isolated from
+        // the Sturm sequence instead.
+        double r = std::sqrt(q.r_squ);
+        double margin = 1e-6 * r + Tolerance<T>::absolute();
+        for (int i = 1; i < numSolved; ++i)
+        {
+            for (int j = i; j != 0 && roots[j] < roots[j - 1]; --j)
+            {
+                std::swap(roots[j], roots[j - 1]);
+            }
+        }
+        for (int i = 0; i != numSolved; ++i)
+        {
+            if (roots[i] < -r - margin || roots[i] > r + margin)
+            {
+                continue;
+            }
+            if (numRoots != 0 && roots[i] - roots[numRoots - 1] <= margin)
+            {
+                continue;
+            }
+            roots[numRoots++] = roots[i];
+        }
+        if (numRoots != countRealRoots(q.coeffs, 4, -r - margin, r + margin))
+        {
+            numRoots = findRealRoots(q.coeffs, 4, -r - margin, r + margin,
+                                     roots);
+        }
+
+        for (int i = 0; i != numRoots; ++i)
+        {
+            // Rescale and retranslate y to normal coordinate system
+            // y = sqrt(r^2 - x^2)
+            double y_squ = std::max(q.r_squ - roots[i] * roots[i], 0.);
+            fy[i] = (std::sqrt(y_squ) + m1.y) / scale.y;
+            fx[i] = roots[i] + m1.x;
+        }
+
         // Check if points are valid; for those that are not, we assume that
         // their y coordinate is on the wrong side of the x axis, so mirror it
         // along that axis. If the point is invalid in general,
         // makeSegmentPoint() will finally fail (see below).
         for (int i = 0; i != numRoots; ++i)
         {
-            Point2D p(fx[i], fy[i]);
+            Point p(fx[i], fy[i]);
             if (!e->isIntersectedByPoint(p))
             {
                 fy[i] = 2. * center_.y - fy[i];
@@ -201,9 +320,8 @@ GenericEllipse::isIntersectedBy(
 
     for (int i = 0; i != numRoots; ++i)
     {
-        Point2D p(fx[i], fy[i]);
-        SegmentPoint* s = makeSegmentPoint(p, e->getQuadrant(p));
-        isecPoints.push_back(s);
+        Point p(fx[i], fy[i]);
+        isecPoints.push_back(makeSegmentPoint(p, e->getQuadrant(p)));
         ++isecCount;
     }
 
@@ -211,21 +329,123 @@ GenericEllipse::isIntersectedBy(
 }
 
 
+template <typename T>
 bool
-GenericEllipse::isIntersectedBy(
-    const GenericLine* lines,
+BasicGenericEllipse<T>::isIntersectedBy(
+    const Line* lines,
     int numLines,
-    SegmentPointVector& isecPoints,
+    PointVector& isecPoints,
     int& isecCount) const
 {
     isecCount = 0;
 
     for (int i = 0; i < numLines; ++i)
     {
-        int n = 0;
-        if (isIntersectedByLine(lines[i], isecPoints, n))
+        isecCount += isIntersectedByLine(lines[i], &isecPoints);
+    }
+
+    return isecCount;
+}
+
+
+template <typename T>
+bool
+BasicGenericEllipse<T>::isIntersectedBy(const Line* lines, int numLines) const
+{
+    return countIntersectionsWithLines(lines, numLines, true);
+}
+
+
+template <typename T>
+int
+BasicGenericEllipse<T>::countIntersections(const Line* lines, int numLines) const
+{
+    return countIntersectionsWithLines(lines, numLines, false);
+}
+
+
+template <typename T>
+int
+BasicGenericEllipse<T>::countIntersectionsWithLines(
+    const Line* lines,
+    int numLines,
+    bool stopAtFirst) const
+{
+    int isecCount = 0;
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        isecCount += isIntersectedByLine(lines[i], 0);
+
+        if (stopAtFirst && isecCount)
+        {
+            break;
+        }
+    }
+
+    return isecCount;
+}
+
+
+template <typename T>
+bool
+BasicGenericEllipse<T>::isIntersectedBy(const BasicGenericEllipse* e) const
+{
+    return countIntersections(e);
+}
+
+
+template <typename T>
+int
+BasicGenericEllipse<T>::countIntersections(const BasicGenericEllipse* e) const
+{
+    // Same setup as in isIntersectedBy(), see there
+    Point scale(1.f, radius_.x / radius_.y);
+    Point m1 = center_ * scale;
+    Point r1 = radius_ * scale;
+    Point m2 = e->center_ * scale;
+    Point r2 = e->radius_ * scale;
+
+    Point centerDist = (m2 - m1).abs();
+    Point maxDist = r1 + r2;
+    if ((centerDist.x > maxDist.x) || (centerDist.y > maxDist.y))
+    {
+        return 0;
+    }
+
+    // isIntersectedBy() reports a single point for identical ellipses
+    if ((center_ == e->center_) && (radius_ == e->radius_))
+    {
+        return 1;
+    }
+
+    EllipseQuartic<T> q(m1, r1, m2, r2);
+
+    if (q.d != 0.)
+    {
+        // Each real root x of the quartic yields exactly one intersection
+        // point, (x, (Px^2 + Qx + R) / 2d), and all of them lie in [-r, r]
+        double r = std::sqrt(q.r_squ);
+        double margin = 1e-6 * r + Tolerance<T>::absolute();
+        return countRealRoots(q.coeffs, 4, -r - margin, r + margin);
+    }
+
+    // Both centers on one horizontal line: each root x with |x| < r stands
+    // for the two points (x, +-y)
+    double x[2];
+    int numRoots = q.horizontalRoots(x);
+
+    int isecCount = 0;
+    for (int i = 0; i != numRoots; ++i)
+    {
+        double y_squ = q.r_squ - x[i] * x[i];
+        if (nearZero(y_squ))
+        {
+            ++isecCount;
+        }
+        else if (y_squ > 0.)
         {
-            isecCount += n;
+            isecCount += 2;
         }
     }
 
@@ -233,11 +453,12 @@ GenericEllipse::isIntersectedBy(
 }
 
 
+template <typename T>
 bool
-GenericEllipse::intersects(
-    const GenericLine* lines,
+BasicGenericEllipse<T>::intersects(
+    const Line* lines,
     int numLines,
-    SegmentPointVector& isecPoints,
+    PointVector& isecPoints,
     int& isecCount) const
 {
     bool ret = isIntersectedBy(lines, numLines, isecPoints, isecCount);
@@ -246,124 +467,104 @@ GenericEllipse::intersects(
     // "this" (ellipse) *intersects* the lines, i.e., the function to call
     // should actually be "lines.areIntersectedBy(ellipse)". We don't have it,
     // though, in order to avoid unnecessary code doublettes.
-    for (int i = 0; i != isecCount; ++i)
+    // Only touch the points appended by this call; the vector may already
+    // hold results of earlier queries.
+    for (size_t i = isecPoints.size() - isecCount; i != isecPoints.size(); ++i)
     {
-        SegmentPoint* s = isecPoints[i];
-        std::swap(s->parent, s->parent2);
-        std::swap(s->t, s->t2);
+        SegPoint& s = isecPoints[i];
+        std::swap(s.parent, s.parent2);
+        std::swap(s.t, s.t2);
     }
     return ret;
 }
 
 
-bool
-GenericEllipse::isIntersectedByLine(
-    const GenericLine& line,
-    SegmentPointVector& isecPoints,
-    int& isecCount) const
+template <typename T>
+int
+BasicGenericEllipse<T>::isIntersectedByLine(
+    const Line& line,
+    PointVector* isecPoints) const
 {
 //    CLEAN_IF_DIRTY(this);
-    isecCount = 0;
+    int isecCount = 0;
 
     // Ellipse:
     //     (x - c)^2 / a^2 + (y - d)^2 / b^2 = 1
     // Line:
-    //     (x,y) = p1 + v * (p2 - p1)
+    //     (x,y) = p1 + t * v,  v = p2 - p1
+    // Substituting the line into the ellipse, with u = (p1 - (c,d)) / (a,b)
+    // and w = v / (a,b), gives
+    //     (w.w) t^2 + 2 (u.w) t + (u.u - 1) = 0
+    // which holds for lines of any direction, no vertical special case
 
-    // Solution vars
-    int nSolutions = 0;
-    float x[2], y[2];
+    const Point& p1 = line.p1();
+    const Point& v = line.vec();
 
-    const Point2D& p1 = line.p1();
-    const Point2D& p2 = line.p2();
+    const Point u = (p1 - center_) / radius_;
+    const Point w = v / radius_;
 
-    float a_squ = radius_.x * radius_.x;
-
-    // Handle vertical lines separately
-    if (NEAR_ZERO(line.vec().x))
+    T l = dot(w, w);
+    if (nearZero(l))
     {
-        // Solve y1,2 = d + b * sqrt(1 - (x - c)^2 / a^2)
-        // rr = expression in sqrt() -> (rr < 0) => no solution
-        float rr = 1 - ((p1.x - center_.x) * (p1.x - center_.x) / a_squ);
-
-        if (rr >= 0.f)
+        // p1 == p2, treat line as point
+        if (!isIntersectedByPoint(p1))
         {
-            if (NEAR_ZERO(rr))
-            {
-                // One solution
-                nSolutions = 1;
-                y[0] = center_.y;
-            }
-            else
-            {
-                // Two solutions
-                nSolutions = 2;
-                float addend = sqrt(rr) * radius_.y;
-                y[0] = center_.y + addend;
-                y[1] = center_.y - addend;
-            }
-
-            for (int i = 0; i != nSolutions; ++i)
-            {
-                float f = (y[i] - p1.y) / (p2.y - p1.y);
-                if (between(f, 0.f, 1.f))
-                {
-                    Point2D p(p1.x, y[i]);
-                    isecPoints.push_back(makeSegmentPoint(p, &line));
-                    ++isecCount;
-                }
-            }
+            return 0;
         }
-
-        return isecCount;
+        if (isecPoints)
+        {
+            const Arc* parent = getQuadrant(p1);
+            isecPoints->push_back(
+                SegPoint(p1, parent->getT(p1), parent, T(0), &line));
+        }
+        return 1;
     }
 
-    // Handle all non-vertical lines from here on
-
-    // Line: y = m * x + n
-    float m = line.m();
-    float n = line.n();
+    // Solve t1,2 = - K / L +- sqrt((K / L)^2 - R / L)
+    // rr = expression in sqrt() -> rr < 0 => no solution
+    T k_div_l = dot(u, w) / l;
+    T rr = k_div_l * k_div_l - (dot(u, u) - 1) / l;
 
-    float a_squ_div_b_squ = a_squ / (radius_.y * radius_.y);
+    if (rr < T(0))
+    {
+        return 0;
+    }
 
-    float q = n - center_.y;
-    float k = a_squ_div_b_squ * m * q - center_.x;
-    float l = a_squ_div_b_squ * m * m + 1;
-    float r = a_squ_div_b_squ * q * q + (center_.x * center_.x) - a_squ;
+    // Solution vars
+    int nSolutions;
+    T t[2];
 
-    // Solve x1,2 = - K / L +- sqrt((K / L)^2 - R / L)
-    // rr = expression in sqrt() -> rr < 0 => no solution
-    float k_div_l = k / l;
-    float rr = k_div_l * k_div_l - (r / l);
+    // rr is in units of t^2; scaled by |v|^2 it is a squared length, as the
+    // tangent tolerance is meant
+    if (nearZero(rr * dot(v, v)))
+    {
+        // One solution: t = - K / L +- 0
+        nSolutions = 1;
+        t[0] = -k_div_l;
+    }
+    else
+    {
+        // Two solutions
+        nSolutions = 2;
+        T rr_sqrt = sqrt(rr);
+        t[0] = -k_div_l + rr_sqrt;
+        t[1] = -k_div_l - rr_sqrt;
+    }
 
-    if (rr >= 0.f)
+    // Make sure intersection is between the line's end points, i.e.,
+    // 0 <= t <= 1
+    for (int i = 0; i != nSolutions; ++i)
     {
-        if (NEAR_ZERO(rr))
-        {
-            // One solution: x = - K / L +- 0
-            nSolutions = 1;
-            x[0] = -k_div_l;
-        }
-        else
-        {
-            // Two solutions
-            nSolutions = 2;
-            float rr_sqrt = sqrt(rr);
-            x[0] = -k_div_l + rr_sqrt;
-            x[1] = -k_div_l - rr_sqrt;
-        };
-
-        // Make sure intersection is between the line's end points via:
-        // p1 + f * (p2 - p1) = (x,y): (0 <= f <= 1) ==> (x,y) between points
-        for (int i = 0; i != nSolutions; ++i)
+        if (between(t[i], T(0), T(1)))
         {
-            float f = (x[i] - p1.x) / (p2.x - p1.x);
-            if (between(f, 0.f, 1.f))
+            if (isecPoints)
             {
-                Point2D p(x[i], m * x[i] + n);
-                isecPoints.push_back(makeSegmentPoint(p, &line));
-                ++isecCount;
+                Point p = p1 + v * t[i];
+                const Arc* parent = getQuadrant(p);
+                isecPoints->push_back(
+                    SegPoint(p, parent->getT(p), parent, t[i], &line));
             }
+            ++isecCount;
         }
     }
 
@@ -371,17 +572,18 @@ GenericEllipse::isIntersectedByLine(
 }
 
 
-SegmentPoint*
-GenericEllipse::makeSegmentPoint(
-    const Point2D& p,
-    const GenericShapeElement* parent2) const
+template <typename T>
+BasicSegmentPoint<T>
+BasicGenericEllipse<T>::makeSegmentPoint(
+    const Point& p,
+    const BasicGenericShapeElement<T>* parent2) const
 {
-    float t2;
+    T t2;
 
     if (parent2->containsPoint(p, t2))
     {
-        const GenericArc* parent = getQuadrant(p);
-        return new SegmentPoint(p, parent->getT(p), parent, t2, parent2);
+        const Arc* parent = getQuadrant(p);
+        return SegPoint(p, parent->getT(p), parent, t2, parent2);
     }
     else
     {
@@ -392,8 +594,9 @@ GenericEllipse::makeSegmentPoint(
 }
 
 
-const GenericArc*
-GenericEllipse::getQuadrant(const Point2D& p) const
+template <typename T>
+const BasicGenericArc<T>*
+BasicGenericEllipse<T>::getQuadrant(const Point& p) const
 {
     //            | +y
     //            |
@@ -431,23 +634,28 @@ GenericEllipse::getQuadrant(const Point2D& p) const
 }
 
 
+template <typename T>
 bool
-GenericEllipse::isIntersectedByPoint(const Point2D& p) const
+BasicGenericEllipse<T>::isIntersectedByPoint(const Point& p) const
 {
-    Point2D p0 = (p - center_);
+    Point p0 = (p - center_);
     p0 = (p0 * p0) / (radius_ * radius_);
-    return NEAR_EQUAL(p0.x + p0.y, 1.f);
+    return nearEqual(p0.x + p0.y, T(1));
 }
 
 /*void
-GenericEllipse::identifyIsecPoints(
-    const Point2D& first,
-    const GenericEllipse* e,
-    SegmentPointVector& isecPoints,
+BasicGenericEllipse<T>::identifyIsecPoints(
+    const Point& first,
+    const BasicGenericEllipse* e,
+    PointVector& isecPoints,
     int& isecCount) const
 {
 
 }*/
 
 
+template class BasicGenericEllipse<float>;
+template class BasicGenericEllipse<double>;
+
+
 } // namespace geom
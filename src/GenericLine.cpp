@@ -3,153 +3,201 @@
 #include <cmath>
 #include "Limits.h"
 #include "Helpers.h"
+#include "Predicates.h"
 
 
 namespace geom {
 
 
-GenericLine::GenericLine()
+namespace
+{
+
+    template <typename T>
+    inline T
+    clampParam(T t)
+    {
+        return t < T(0) ? T(0) : (t > T(1) ? T(1) : t);
+    }
+
+}
+
+
+template <typename T>
+BasicGenericLine<T>::BasicGenericLine()
 :   Dirtable(true),
-    p1_(Point2D(0,0)),
-    p2_(Point2D(1,1))
+    p1_(Point(0,0)),
+    p2_(Point(1,1))
 {}
 
 
-GenericLine::GenericLine(const Point2D& p1, const Point2D& p2)
+template <typename T>
+BasicGenericLine<T>::BasicGenericLine(const Point& p1, const Point& p2)
 :   Dirtable(true),
     p1_(p1),
     p2_(p2)
 {}
 
 
-GenericLine::~GenericLine()
+template <typename T>
+BasicGenericLine<T>::~BasicGenericLine()
 {}
 
 
+template <typename T>
 void
-GenericLine::performCleaning() const
+BasicGenericLine<T>::performCleaning() const
 {
     vec_ = p2_ - p1_;
-    m_ = (NEAR_ZERO(vec_.x)) ? 0.f : (vec_.y / vec_.x);
-    n_ = m_ * (-p1_.x) + p1_.y;
 }
 
 
-MAKE_GETTER(const Point2D& GenericLine::p1() const, p1_)
+template <typename T>
+MAKE_GETTER(const BasicPoint2D<T>& BasicGenericLine<T>::p1() const, p1_)
 
-MAKE_GETTER(const Point2D& GenericLine::p2() const, p2_)
+template <typename T>
+MAKE_GETTER(const BasicPoint2D<T>& BasicGenericLine<T>::p2() const, p2_)
 
-MAKE_SETTER(GenericLine::p1(const Point2D& p), p1_, p)
+template <typename T>
+MAKE_SETTER(BasicGenericLine<T>::p1(const Point& p), p1_, p)
 
-MAKE_SETTER(GenericLine::p2(const Point2D& p), p2_, p)
+template <typename T>
+MAKE_SETTER(BasicGenericLine<T>::p2(const Point& p), p2_, p)
 
 
+template <typename T>
 void
-GenericLine::p1p2(const Point2D& p1, const Point2D& p2)
+BasicGenericLine<T>::p1p2(const Point& p1, const Point& p2)
 {
     p1_ = p1;
     p2_ = p2;
-    dirty_ = true;
+    markDirty();
 }
 
 
-MAKE_GETTER(const Point2D& GenericLine::vec() const, vec_)
-
-MAKE_GETTER(float GenericLine::m() const, m_)
-
-MAKE_GETTER(float GenericLine::n() const, n_)
-
+template <typename T>
+MAKE_GETTER(const BasicPoint2D<T>& BasicGenericLine<T>::vec() const, vec_)
 
+template <typename T>
 bool
-GenericLine::isIntersectedBy(
-    const GenericLine& other,
-    SegmentPointVector& isecPoints,
+BasicGenericLine<T>::isIntersectedBy(
+    const BasicGenericLine& other,
+    PointVector& isecPoints,
     int& isecCount) const
 {
-    isecCount = 0;
+    isecCount = intersectsLine(other, &isecPoints);
+    return isecCount;
+}
+
 
+template <typename T>
+int
+BasicGenericLine<T>::countIntersections(const BasicGenericLine& other) const
+{
+    return intersectsLine(other, 0);
+}
+
+
+template <typename T>
+int
+BasicGenericLine<T>::intersectsLine(
+    const BasicGenericLine& other, PointVector* isecPoints) const
+{
     CLEAN_IF_DIRTY(this);
     CLEAN_IF_DIRTY(&other);
 
-    // Check for x = Const and p1 == p2 cases
-    if (NEAR_ZERO(vec_.x))
+    // All decisions are made by the exact predicates; only the intersection
+    // points and their t values are computed in T.
+
+    // Check for p1 == p2 cases, treat such lines as points
+    if (isPoint())
     {
-        if (NEAR_ZERO(vec_.y))
+        bool onOther = other.isPoint()
+            ? p1_.x == other.p1_.x && p1_.y == other.p1_.y
+            : onSegment(other.p1_, other.p2_, p1_);
+        if (!onOther)
         {
-            // p1 == p2, treat line as point
-            float t;
-            if (other.containsPoint(p1_, t))
-            {
-                isecPoints.push_back(new SegmentPoint(p1_, 0.f, this, t, &other));
-                isecCount = 1;
-            }
+            return 0;
         }
-        else // We have the x = Const case!
+        if (isecPoints)
         {
-            // Check if parallel (i.e., other line is also x = Const case)
-            if (NEAR_ZERO(other.vec_.x))
-            {
-                // Check if collinear and segments superpose
-                if (NEAR_EQUAL(p1_.x, other.p1_.x))
-                {
-                    isSuperposedBy(other, isecPoints, isecCount);
-                }
-            }
-            else // Not parallel / collinear
-            {
-                Point2D p(p1_.x, other.m_ * p1_.x + other.n_);
-
-                float t, t2;
-                if (containsPoint(p, t) && other.containsPoint(p, t2))
-                {
-                    isecPoints.push_back(new SegmentPoint(p, t, this, t2, &other));
-                    isecCount = 1;
-                }
-            }
+            isecPoints->push_back(
+                SegPoint(p1_, T(0), this, other.paramOf(p1_), &other));
         }
-
-        return isecCount;
+        return 1;
     }
 
-    // Check if parallel and collinear
-    if (NEAR_EQUAL(m_, other.m_) && NEAR_EQUAL(n_, other.n_))
+    if (other.isPoint())
     {
-        // Check if segments superpose
-        isSuperposedBy(other, isecPoints, isecCount);
-    }
-    else // Not parallel, thus intersection (somewhere)
-    {
-        Point2D p;
-        // Check if other is x = Const case
-        if (NEAR_ZERO(other.vec_.x))
+        if (!onSegment(p1_, p2_, other.p1_))
         {
-            p.x = other.p1_.x;
-            p.y = m_ * p.x + n_;
+            return 0;
         }
-        else
+        if (isecPoints)
         {
-            p.x = (n_ - other.n_) / (other.m_ - m_);
-            p.y = (other.m_ * n_ - m_ * other.n_) / (other.m_ - m_);
+            isecPoints->push_back(
+                SegPoint(other.p1_, paramOf(other.p1_), this, T(0), &other));
         }
+        return 1;
+    }
+
+    SegmentOrientations o;
+    switch (classifySegments(p1_, p2_, other.p1_, other.p2_, o))
+    {
+    case SegmentsDisjoint:
+        return 0;
+
+    case SegmentsOverlap:
+        return isSuperposedBy(other, isecPoints);
 
-        // Check for intersection of particular line segments
-        float t, t2;
-        if (containsPoint(p, t) && other.containsPoint(p, t2))
+    case SegmentsTouch:
+        if (isecPoints)
         {
-            isecPoints.push_back(new SegmentPoint(p, t, this, t2, &other));
-            isecCount = 1;
+            // The common point is an end point lying on the other line
+            if (o.q1 == 0.)
+            {
+                isecPoints->push_back(SegPoint(
+                    other.p1_, paramOf(other.p1_), this, T(0), &other));
+            }
+            else if (o.q2 == 0.)
+            {
+                isecPoints->push_back(SegPoint(
+                    other.p2_, paramOf(other.p2_), this, T(1), &other));
+            }
+            else if (o.p1 == 0.)
+            {
+                isecPoints->push_back(SegPoint(
+                    p1_, T(0), this, other.paramOf(p1_), &other));
+            }
+            else
+            {
+                isecPoints->push_back(SegPoint(
+                    p2_, T(1), this, other.paramOf(p2_), &other));
+            }
         }
+        return 1;
+
+    case SegmentsCross:
+        break;
     }
 
-    return isecCount;
+    if (isecPoints)
+    {
+        // The orientations are the signed distances of the end points to the
+        // other line (times its length); they change linearly along the line
+        T t = T(o.p1 / (o.p1 - o.p2));
+        T t2 = T(o.q1 / (o.q1 - o.q2));
+        isecPoints->push_back(SegPoint(p1_ + vec_ * t, t, this, t2, &other));
+    }
+    return 1;
 }
 
 
+template <typename T>
 bool
-GenericLine::isIntersectedByLines(
-    const GenericLine others[],
+BasicGenericLine<T>::isIntersectedByLines(
+    const BasicGenericLine others[],
     int numOthers,
-    SegmentPointVector& isecPoints, int& isecCount) const
+    PointVector& isecPoints, int& isecCount) const
 {
     isecCount = 0;
 
@@ -168,13 +216,14 @@ GenericLine::isIntersectedByLines(
 }
 
 
+template <typename T>
 bool
-GenericLine::areIntersectedBy(
-    const GenericLine lines[],
+BasicGenericLine<T>::areIntersectedBy(
+    const BasicGenericLine lines[],
     int numLines,
-    const GenericLine otherLines[],
+    const BasicGenericLine otherLines[],
     int numOtherLines,
-    SegmentPointVector& isecPoints,
+    PointVector& isecPoints,
     int& isecCount)
 {
     isecCount  = 0;
@@ -192,64 +241,128 @@ GenericLine::areIntersectedBy(
 }
 
 
+template <typename T>
 bool
-GenericLine::containsPoint(const Point2D& p) const
+BasicGenericLine<T>::areIntersectedBy(
+    const BasicGenericLine lines[],
+    int numLines,
+    const BasicGenericLine otherLines[],
+    int numOtherLines)
 {
-    float t;
-    return containsPoint(p, t);
+    return countIntersections(lines, numLines, otherLines, numOtherLines, true);
 }
 
 
-bool
-GenericLine::containsPoint(const Point2D& p, float& t) const
+template <typename T>
+int
+BasicGenericLine<T>::countIntersections(
+    const BasicGenericLine lines[],
+    int numLines,
+    const BasicGenericLine otherLines[],
+    int numOtherLines)
 {
-    // (I)   p = p1 + t * (p2 - p1)
-    // (II)  p.x = p1.x + t * (p2.x - p1.x)
-    // (III) t = (p.x - p1.x) / (p2.x - p1.x)
+    return countIntersections(lines, numLines, otherLines, numOtherLines, false);
+}
 
-    CLEAN_IF_DIRTY(this);
 
-    // Check for x = Const and p1 == p2 cases
-    if (NEAR_ZERO(vec_.x))
+template <typename T>
+int
+BasicGenericLine<T>::countIntersections(
+    const BasicGenericLine lines[],
+    int numLines,
+    const BasicGenericLine otherLines[],
+    int numOtherLines,
+    bool stopAtFirst)
+{
+    int isecCount = 0;
+
+    for (int i = 0; i < numLines; ++i)
     {
-        if (NEAR_ZERO(vec_.y))
+        for (int j = 0; j < numOtherLines; ++j)
         {
-            // p1 == p2, treat line as point
-            t = 0.f;
-            return p1_ == p;
-        }
+            isecCount += lines[i].intersectsLine(otherLines[j], 0);
 
-        t = (p.y - p1_.y) / vec_.y;
+            if (stopAtFirst && isecCount)
+            {
+                return isecCount;
+            }
+        }
     }
-    else
+
+    return isecCount;
+}
+
+
+template <typename T>
+bool
+BasicGenericLine<T>::containsPoint(const Point& p) const
+{
+    T t;
+    return containsPoint(p, t);
+}
+
+
+template <typename T>
+bool
+BasicGenericLine<T>::containsPoint(const Point& p, T& t) const
+{
+    // (I)   p = p1 + t * (p2 - p1)
+    // (II)  t = (p - p1) . (p2 - p1) / |p2 - p1|^2
+    // i.e., t of the projection of p onto the line
+
+    CLEAN_IF_DIRTY(this);
+
+    if (isPoint())
     {
-        t = (p.x - p1_.x) / vec_.x;
+        // p1 == p2, treat line as point
+        t = T(0);
+        return p1_ == p;
     }
 
-    // (IV)  p.y = p1.y + t * (p2.y - p1.y)
-    // The NEAR_EQUAL check is not necessary here and error prone due to
-    // rounding errors (so remove that commented line some day?!)
-    //return (between(t, 0.f, 1.f) && NEAR_EQUAL(p1_.y + t * vec_.y, p.y));
-    return between(t, 0.f, 1.f);
+    t = dot(p - p1_, vec_) / dot(vec_, vec_);
+
+    // Whether p actually lies on the line is not checked here, that is
+    // error prone due to rounding errors
+    return between(t, T(0), T(1));
 }
 
 
+template <typename T>
 bool
-GenericLine::isSuperposedBy(
-    const GenericLine& other, SegmentPointVector& isecPoints, int& isecCount) const
+BasicGenericLine<T>::isPoint() const
+{
+    return vec_.x == T(0) && vec_.y == T(0);
+}
+
+
+template <typename T>
+T
+BasicGenericLine<T>::paramOf(const Point& p) const
+{
+    T t;
+    containsPoint(p, t);
+    return clampParam(t);
+}
+
+
+template <typename T>
+int
+BasicGenericLine<T>::isSuperposedBy(
+    const BasicGenericLine& other, PointVector* isecPoints) const
 {
     // No need for CLEAN_IF_DIRTY here, as this method is available internally
     // only and cleaning should already have been performed in the calling
     // method
 
-    isecCount = 0;
+    // Superposition yields at most two points, collected here first so that
+    // the end point checks below work without a result vector as well
+    SegPoint isp[2] = { SegPoint(p1_, T(0), this), SegPoint(p1_, T(0), this) };
+    int isecCount = 0;
 
     // Factors that determine the t of the intersection point equation p in
     // p = p1 + t * (p2 - p1)
-    float t[2]; // t of intersection points relative to this line
-    float tOther[2]; // t of intersection points relative to other line
-
-    SegmentPoint* isp[2] = {0, 0};
+    T t[2]; // t of intersection points relative to this line
+    T tOther[2]; // t of intersection points relative to other line
 
     bool containsOtherP1 = containsPoint(other.p1_, t[0]);
     bool containsOtherP2 = containsPoint(other.p2_, t[1]);
@@ -258,8 +371,8 @@ GenericLine::isSuperposedBy(
     {
         // other is fully contained by this
         isecCount = 2;
-        isp[0] = new SegmentPoint(other.p1_, t[0], this, 0.f, &other);
-        isp[1] = new SegmentPoint(other.p2_, t[1], this, 1.f, &other);
+        isp[0] = SegPoint(other.p1_, t[0], this, T(0), &other);
+        isp[1] = SegPoint(other.p2_, t[1], this, T(1), &other);
     }
     else
     {
@@ -270,62 +383,64 @@ GenericLine::isSuperposedBy(
         {
             // this is fully contained by other
             isecCount = 2;
-            isp[0] = new SegmentPoint(p1_, 0.f, this, tOther[0], &other);
-            isp[1] = new SegmentPoint(p2_, 1.f, this, tOther[1], &other);
+            isp[0] = SegPoint(p1_, T(0), this, tOther[0], &other);
+            isp[1] = SegPoint(p2_, T(1), this, tOther[1], &other);
         }
         else // Only possibilities left: partial or no superposition
         {
             if (containsOtherP1)
             {
-                isp[0] = new SegmentPoint(other.p1_, t[0], this, 0.f, &other);
-                isecCount++;
+                isp[isecCount++] = SegPoint(other.p1_, t[0], this, T(0), &other);
             }
             else if (containsOtherP2)
             {
-                isp[0] = new SegmentPoint(other.p2_, t[1], this, 1.f, &other);
-                isecCount++;
+                isp[isecCount++] = SegPoint(other.p2_, t[1], this, T(1), &other);
             }
 
             // Find second intersection point, check for end point intersection
             if (isecCount == 1)
             {
-                if (otherContainsP1 && (*isp[0] != p1_))
+                if (otherContainsP1 && (isp[0].p != p1_))
                 {
-                    isp[1] = new SegmentPoint(p1_, 0.f, this, tOther[0], &other);
-                    isecCount++;
+                    isp[isecCount++] = SegPoint(p1_, T(0), this, tOther[0], &other);
                 }
-                else if (otherContainsP2 && (*isp[0] != p2_))
+                else if (otherContainsP2 && (isp[0].p != p2_))
                 {
-                    isp[1] = new SegmentPoint(p2_, 1.f, this, tOther[1], &other);
-                    isecCount++;
+                    isp[isecCount++] = SegPoint(p2_, T(1), this, tOther[1], &other);
                 }
                 // ... else: Both lines share only one end point, count stays 1
             }
         }
     }
 
-    if (isp[0])
+    if (isecPoints)
     {
-        isecPoints.push_back(isp[0]);
-        if (isp[1])
-        {
-            isecPoints.push_back(isp[1]);
-        }
+        isecPoints->insert(isecPoints->end(), isp, isp + isecCount);
     }
 
     return isecCount;
 }
 
 
+template <typename T>
 std::ostream&
-operator<<(std::ostream& out, const GenericLine& line)
+operator<<(std::ostream& out, const BasicGenericLine<T>& line)
 {
-    const geom::Point2D& p1 = line.p1();
-    const geom::Point2D& p2 = line.p2();
+    const BasicPoint2D<T>& p1 = line.p1();
+    const BasicPoint2D<T>& p2 = line.p2();
     out << "GenericLine (" << p1.x << ", " << p1.y << ") -- (" << p2.x << ", "
         << p2.y << ")";
     return out;
 }
 
 
+template class BasicGenericLine<float>;
+template class BasicGenericLine<double>;
+
+template std::ostream& operator<<(std::ostream&,
+                                  const BasicGenericLine<float>&);
+template std::ostream& operator<<(std::ostream&,
+                                  const BasicGenericLine<double>&);
+
+
 } // namespace geom
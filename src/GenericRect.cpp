@@ -6,29 +6,33 @@ namespace geom
 {
 
 
-GenericRect::GenericRect()
+template <typename T>
+BasicGenericRect<T>::BasicGenericRect()
 :   Dirtable(),
-    p1_(Point2D(0,0)),
-    p2_(Point2D(1,1))
+    p1_(Point(0,0)),
+    p2_(Point(1,1))
 {}
 
 
-GenericRect::GenericRect(const Point2D& p1, const Point2D& p2)
+template <typename T>
+BasicGenericRect<T>::BasicGenericRect(const Point& p1, const Point& p2)
 :   Dirtable(),
     p1_(p1),
     p2_(p2)
 {}
 
 
-GenericRect::~GenericRect()
+template <typename T>
+BasicGenericRect<T>::~BasicGenericRect()
 {}
 
 
+template <typename T>
 void
-GenericRect::performCleaning() const
+BasicGenericRect<T>::performCleaning() const
 {
-    Point2D t1 = p1_;
-    Point2D t2 = p2_;
+    Point t1 = p1_;
+    Point t2 = p2_;
 
     p1_ = min(t1, t2);
     p2_ = max(t1, t2);
@@ -43,43 +47,55 @@ GenericRect::performCleaning() const
     topRight_.x = p2_.x;
     topRight_.y = p1_.y;
 
-    lines_[0].p1p2(p1_, topRight_);
-    lines_[1].p1p2(topRight_, p2_);
-    lines_[2].p1p2(p2_, bottomLeft_);
-    lines_[3].p1p2(bottomLeft_, p1_);
+    edges_.corners(p1_, p2_);
 }
 
 
-MAKE_SETTER(GenericRect::p1(const Point2D& p), p1_, p)
+template <typename T>
+MAKE_SETTER(BasicGenericRect<T>::p1(const Point& p), p1_, p)
 
-MAKE_SETTER(GenericRect::p2(const Point2D& p), p2_, p)
+template <typename T>
+MAKE_SETTER(BasicGenericRect<T>::p2(const Point& p), p2_, p)
 
-MAKE_GETTER(const Point2D& GenericRect::p1() const, p1_)
+template <typename T>
+MAKE_GETTER(const BasicPoint2D<T>& BasicGenericRect<T>::p1() const, p1_)
 
-MAKE_GETTER(const Point2D& GenericRect::p2() const, p2_)
+template <typename T>
+MAKE_GETTER(const BasicPoint2D<T>& BasicGenericRect<T>::p2() const, p2_)
 
-MAKE_GETTER(const Point2D& GenericRect::extents() const, extents_)
+template <typename T>
+MAKE_GETTER(const BasicPoint2D<T>& BasicGenericRect<T>::extents() const,
+            extents_)
 
-MAKE_GETTER(const GenericLine* GenericRect::lines() const, lines_)
+template <typename T>
+const BasicGenericLine<T>*
+BasicGenericRect<T>::lines() const
+{
+    CLEAN_IF_DIRTY(this);
+    CLEAN_IF_DIRTY(&edges_);
+    return edges_.lines;
+}
 
 
+template <typename T>
 void
-GenericRect::moveBy(const Point2D& delta)
+BasicGenericRect<T>::moveBy(const Point& delta)
 {
     p1_ += delta;
     p2_ += delta;
-    dirty_ = true;
+    markDirty();
 }
 
 
+template <typename T>
 bool
-GenericRect::isIntersectedByRect(const GenericRect& other) const
+BasicGenericRect<T>::isIntersectedByRect(const BasicGenericRect& other) const
 {
     CLEAN_IF_DIRTY(this);
     CLEAN_IF_DIRTY(&other);
 
-    Point2D centerDist = (center_ - other.center_).abs();
-    Point2D dmax = (extents_ + other.extents_) / 2;
+    Point centerDist = (center_ - other.center_).abs();
+    Point dmax = (extents_ + other.extents_) / 2;
 
     // Is some part of this within other's horizontal range, or vice versa?
     bool withinHoriz = centerDist.x <= dmax.x;
@@ -90,7 +106,7 @@ GenericRect::isIntersectedByRect(const GenericRect& other) const
     return withinHoriz && withinVert;
 //    if (withinHoriz || withinVert)
 //    {
-//        Point2D dmin = (extents_ - other.extents_).abs() / 2;
+//        Point dmin = (extents_ - other.extents_).abs() / 2;
 //        bool isIntersectedByHoriz = (centerDist.y >= dmin.y) && withinHoriz;
 //        bool isIntersectedByVert = (centerDist.x >= dmin.x) && withinVert;
 //
@@ -101,24 +117,26 @@ GenericRect::isIntersectedByRect(const GenericRect& other) const
 }
 
 
+template <typename T>
 bool
-GenericRect::isIntersectedByRect(
-    const GenericRect& other, GenericRect& intersecRect) const
+BasicGenericRect<T>::isIntersectedByRect(
+    const BasicGenericRect& other, BasicGenericRect& intersecRect) const
 {
     bool bIntersects = false;
 
     if (isIntersectedByRect(other))
     {
         bIntersects = true;
-        intersecRect = GenericRect(max(p1_, other.p1_), min(p2_, other.p2_));
+        intersecRect = BasicGenericRect(max(p1_, other.p1_), min(p2_, other.p2_));
     }
 
     return bIntersects;
 }
 
 
+template <typename T>
 bool
-GenericRect::containsRect(const GenericRect& other) const
+BasicGenericRect<T>::containsRect(const BasicGenericRect& other) const
 {
     CLEAN_IF_DIRTY(this);
     CLEAN_IF_DIRTY(&other);
@@ -126,23 +144,65 @@ GenericRect::containsRect(const GenericRect& other) const
 }
 
 
+template <typename T>
 bool
-GenericRect::containsPoint(const Point2D& p) const
+BasicGenericRect<T>::containsPoint(const Point& p) const
 {
     CLEAN_IF_DIRTY(this);
     return ((p >= p1_) && (p <= p2_));
 }
 
 
+template <typename T>
+BasicGenericRect<T>::Edges::Edges()
+:   Dirtable(true)
+{}
+
+
+template <typename T>
+void
+BasicGenericRect<T>::Edges::corners(const Point& p1, const Point& p2)
+{
+    p1_ = p1;
+    p2_ = p2;
+    markDirty();
+}
+
+
+template <typename T>
+void
+BasicGenericRect<T>::Edges::performCleaning() const
+{
+    // p1_ is the minimum corner, p2_ the maximum one
+    const Point bottomLeft(p1_.x, p2_.y);
+    const Point topRight(p2_.x, p1_.y);
+
+    lines[0].p1p2(p1_, topRight);
+    lines[1].p1p2(topRight, p2_);
+    lines[2].p1p2(p2_, bottomLeft);
+    lines[3].p1p2(bottomLeft, p1_);
+}
+
+
+template <typename T>
 std::ostream&
-operator<<(std::ostream& out, const GenericRect& rect)
+operator<<(std::ostream& out, const BasicGenericRect<T>& rect)
 {
-    const Point2D& p1 = rect.p1_;
-    const Point2D& p2 = rect.p2_;
+    const BasicPoint2D<T>& p1 = rect.p1_;
+    const BasicPoint2D<T>& p2 = rect.p2_;
     out << "GenericRect (" << p1.x << ", " << p1.y << ") -- (" << p2.x << ", "
         << p2.y << ")";
     return out;
 }
 
 
+template class BasicGenericRect<float>;
+template class BasicGenericRect<double>;
+
+template std::ostream& operator<<(std::ostream&,
+                                  const BasicGenericRect<float>&);
+template std::ostream& operator<<(std::ostream&,
+                                  const BasicGenericRect<double>&);
+
+
 } // namespace geom
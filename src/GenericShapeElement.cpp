@@ -0,0 +1,18 @@
+#include "GenericShapeElement.h"
+
+#include <atomic>
+
+namespace geom
+{
+
+
+unsigned
+newShapeElementId()
+{
+    // 0 is left for points without a parent
+    static std::atomic<unsigned> lastId(0);
+    return ++lastId;
+}
+
+
+} // namespace geom
@@ -0,0 +1,266 @@
+#include "IntersectionEngine.h"
+
+#include <algorithm>
+
+#include "GeometryExceptions.h"
+#include "ShapeDispatch.h"
+
+namespace geom
+{
+
+
+namespace
+{
+
+    // Pairs per chunk; small enough to balance uneven pair costs, large
+    // enough to keep the queue overhead negligible
+    const size_t pairGrainSize = 256;
+
+    // Shapes per chunk for the all-pairs rows and the cleaning pre-pass
+    const size_t shapeGrainSize = 16;
+
+}
+
+
+template <typename T>
+BasicIntersectionEngine<T>::BasicIntersectionEngine(int numThreads)
+:   pool_(numThreads),
+    buffers_(pool_.numThreads()),
+    skipFailedPairs_(false),
+    numFailedPairs_(0)
+{}
+
+
+template <typename T>
+BasicIntersectionEngine<T>::~BasicIntersectionEngine()
+{}
+
+
+template <typename T>
+int
+BasicIntersectionEngine<T>::numThreads() const
+{
+    return pool_.numThreads();
+}
+
+
+template <typename T>
+void
+BasicIntersectionEngine<T>::skipFailedPairs(bool skip)
+{
+    skipFailedPairs_ = skip;
+}
+
+
+template <typename T>
+int
+BasicIntersectionEngine<T>::numFailedPairs() const
+{
+    return numFailedPairs_;
+}
+
+
+template <typename T>
+void
+BasicIntersectionEngine<T>::prepare(const std::vector<const Shape*>& shapes)
+{
+    // Each shape is cleaned by exactly one thread
+    pool_.parallelFor(shapes.size(), shapeGrainSize,
+        [&shapes](size_t begin, size_t end, int)
+        {
+            for (size_t i = begin; i != end; ++i)
+            {
+                shapes[i]->makeAllClean();
+            }
+        });
+}
+
+
+template <typename T>
+int
+BasicIntersectionEngine<T>::findIntersections(
+    const std::vector<const Shape*>& shapes,
+    const CandidatePairSource& source,
+    std::vector<ShapePair>& pairs,
+    SegmentPointVector& isecPoints)
+{
+    prepare(shapes);
+
+    candidates_.clear();
+    source.findPairs(candidates_);
+
+    clearBuffers();
+
+    pool_.parallelFor(candidates_.size(), pairGrainSize,
+        [this](size_t begin, size_t end, int thread)
+        {
+            // Each chunk is grouped by the types of its pairs, in place
+            ThreadBuffer& buffer = buffers_[thread];
+            beginSpan(buffer, begin / pairGrainSize);
+            BasicShapeDispatch<T>::findIntersections(
+                &candidates_[begin], end - begin, buffer.pairs, buffer.points,
+                skipFailedPairs_ ? &buffer.numFailed : 0);
+            endSpan(buffer);
+        });
+
+    return mergeBuffers(pairs, isecPoints);
+}
+
+
+template <typename T>
+int
+BasicIntersectionEngine<T>::findIntersections(
+    const std::vector<const Shape*>& shapes,
+    std::vector<ShapePair>& pairs,
+    SegmentPointVector& isecPoints)
+{
+    prepare(shapes);
+
+    clearBuffers();
+
+    // One row i per index; rows get shorter towards the end, which the work
+    // stealing evens out
+    pool_.parallelFor(shapes.size(), shapeGrainSize,
+        [this, &shapes](size_t begin, size_t end, int thread)
+        {
+            ThreadBuffer& buffer = buffers_[thread];
+            beginSpan(buffer, begin / shapeGrainSize);
+            for (size_t i = begin; i != end; ++i)
+            {
+                for (size_t j = i + 1; j < shapes.size(); ++j)
+                {
+                    testPair(shapes[i], shapes[j], buffer);
+                }
+            }
+            endSpan(buffer);
+        });
+
+    return mergeBuffers(pairs, isecPoints);
+}
+
+
+template <typename T>
+void
+BasicIntersectionEngine<T>::testPair(
+    const Shape* a, const Shape* b, ThreadBuffer& buffer) const
+{
+    const size_t numPoints = buffer.points.size();
+    int count = 0;
+    bool intersecting;
+
+    if (skipFailedPairs_)
+    {
+        try
+        {
+            intersecting = a->isIntersectedBy(b, buffer.points, count);
+        }
+        catch (const error::GeometryError&)
+        {
+            // Drop what the failed test may have added
+            buffer.points.erase(buffer.points.begin() + numPoints,
+                                buffer.points.end());
+            ++buffer.numFailed;
+            return;
+        }
+    }
+    else
+    {
+        intersecting = a->isIntersectedBy(b, buffer.points, count);
+    }
+
+    if (intersecting)
+    {
+        buffer.pairs.push_back(ShapePair(a, b));
+    }
+}
+
+
+template <typename T>
+void
+BasicIntersectionEngine<T>::beginSpan(ThreadBuffer& buffer, size_t chunk) const
+{
+    Span span;
+    span.chunk = chunk;
+    span.pairsBegin = span.pairsEnd = buffer.pairs.size();
+    span.pointsBegin = span.pointsEnd = buffer.points.size();
+    buffer.spans.push_back(span);
+}
+
+
+template <typename T>
+void
+BasicIntersectionEngine<T>::endSpan(ThreadBuffer& buffer) const
+{
+    Span& span = buffer.spans.back();
+    span.pairsEnd = buffer.pairs.size();
+    span.pointsEnd = buffer.points.size();
+}
+
+
+template <typename T>
+void
+BasicIntersectionEngine<T>::clearBuffers()
+{
+    // Keeps the capacity for the next query
+    for (size_t i = 0; i != buffers_.size(); ++i)
+    {
+        buffers_[i].pairs.clear();
+        buffers_[i].points.clear();
+        buffers_[i].spans.clear();
+        buffers_[i].numFailed = 0;
+    }
+}
+
+
+template <typename T>
+int
+BasicIntersectionEngine<T>::mergeBuffers(
+    std::vector<ShapePair>& pairs, SegmentPointVector& isecPoints)
+{
+    // (chunk, (buffer, span)) of every span; chunks are unique, so sorting
+    // orders by chunk
+    std::vector<std::pair<size_t, std::pair<size_t, size_t> > > order;
+    size_t numPairs = 0;
+    size_t numPoints = 0;
+    numFailedPairs_ = 0;
+
+    for (size_t b = 0; b != buffers_.size(); ++b)
+    {
+        const ThreadBuffer& buffer = buffers_[b];
+        for (size_t s = 0; s != buffer.spans.size(); ++s)
+        {
+            order.push_back(
+                std::make_pair(buffer.spans[s].chunk, std::make_pair(b, s)));
+        }
+        numPairs += buffer.pairs.size();
+        numPoints += buffer.points.size();
+        numFailedPairs_ += buffer.numFailed;
+    }
+
+    std::sort(order.begin(), order.end());
+
+    pairs.reserve(pairs.size() + numPairs);
+    isecPoints.reserve(isecPoints.size() + numPoints);
+
+    for (size_t i = 0; i != order.size(); ++i)
+    {
+        const ThreadBuffer& buffer = buffers_[order[i].second.first];
+        const Span& span = buffer.spans[order[i].second.second];
+
+        pairs.insert(pairs.end(),
+                     buffer.pairs.begin() + span.pairsBegin,
+                     buffer.pairs.begin() + span.pairsEnd);
+        isecPoints.insert(isecPoints.end(),
+                          buffer.points.begin() + span.pointsBegin,
+                          buffer.points.begin() + span.pointsEnd);
+    }
+
+    return (int)numPairs;
+}
+
+
+template class BasicIntersectionEngine<float>;
+template class BasicIntersectionEngine<double>;
+
+
+} // namespace geom
@@ -1,28 +1,29 @@
 #include "LineBasedShape.h"
-#include "Rectangle.h"
-#include "Triangle.h"
-#include "Ellipse.h"
 
 
 namespace geom
 {
 
 
-LineBasedShape::LineBasedShape(int numLines, ShapeType type)
-:   Shape(type),
-    lines_(new GenericLine[numLines]),
+template <typename T>
+BasicLineBasedShape<T>::BasicLineBasedShape(int numLines,
+                                            ShapeTypes::ShapeType type)
+:   BasicShape<T>(type),
+    lines_(new Line[numLines]),
     doCleanupLines_(true)
 {}
 
 
-LineBasedShape::LineBasedShape(ShapeType type)
-:   Shape(type),
+template <typename T>
+BasicLineBasedShape<T>::BasicLineBasedShape(ShapeTypes::ShapeType type)
+:   BasicShape<T>(type),
     lines_(0),
     doCleanupLines_(false)
 {}
 
 
-LineBasedShape::~LineBasedShape()
+template <typename T>
+BasicLineBasedShape<T>::~BasicLineBasedShape()
 {
     if (doCleanupLines_)
     {
@@ -31,54 +32,28 @@ LineBasedShape::~LineBasedShape()
 }
 
 
-bool
-LineBasedShape::isIntersectedByRectangle(
-    const Rectangle* r, SegmentPointVector& isecPoints, int& isecCount) const
+template <typename T>
+void
+BasicLineBasedShape<T>::makeElementsClean() const
 {
-    return isIntersectedByLineBasedShape(r, isecPoints, isecCount);
-}
-
+    // The lines are set up by the cleaning of the shape itself
+    this->makeClean();
 
-bool
-LineBasedShape::isIntersectedByTriangle(
-    const Triangle* t, SegmentPointVector& isecPoints, int& isecCount) const
-{
-    return isIntersectedByLineBasedShape(t, isecPoints, isecCount);
-}
-
-
-bool
-LineBasedShape::isIntersectedByEllipse(
-    const Ellipse* e, SegmentPointVector& isecPoints, int& isecCount) const
-{
-    if (!bb().isIntersectedByRect(e->bb()))
+    const int numLines = getNumLines();
+    for (int i = 0; i < numLines; ++i)
     {
-        isecCount = 0;
-        return false;
+        lines_[i].makeClean();
     }
-
-    return e->intersects(lines_, getNumLines(), isecPoints, isecCount);
 }
 
 
-MAKE_GETTER(const GenericLine* LineBasedShape::lines() const, lines_)
-
+template <typename T>
+MAKE_GETTER(const BasicGenericLine<T>* BasicLineBasedShape<T>::lines() const,
+            lines_)
 
-bool
-LineBasedShape::isIntersectedByLineBasedShape(
-    const LineBasedShape* s,
-    SegmentPointVector& isecPoints,
-    int& isecCount) const
-{
-    if (!bb().isIntersectedByRect(s->bb()))
-    {
-        isecCount = 0;
-        return false;
-    }
 
-    return GenericLine::areIntersectedBy(
-        lines_, getNumLines(), s->lines(), s->getNumLines(), isecPoints, isecCount);
-}
+template class BasicLineBasedShape<float>;
+template class BasicLineBasedShape<double>;
 
 
 } // namespace geom
@@ -0,0 +1,791 @@
+#include "PointBuffer.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define POINTBUFFER_SSE2
+#endif
+
+// The AVX2 kernels are compiled for that target per function, so the rest of
+// the library does not depend on it; they are only called if the CPU has it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define POINTBUFFER_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace geom
+{
+
+
+namespace
+{
+
+    struct KernelTable
+    {
+        void (*translate)(float* x, float* y, size_t n, float dx, float dy);
+
+        void (*scale)(float* x, float* y, size_t n, float sx, float sy);
+
+        void (*bounds)(const float* x, const float* y, size_t n, AABox& box);
+
+        void (*distancesTo)(const float* x, const float* y, size_t n,
+                            float px, float py, float* out);
+
+        void (*distances)(const float* ax, const float* ay,
+                          const float* bx, const float* by, size_t n,
+                          float* out);
+
+        void (*ellipseValues)(const float* x, const float* y, size_t n,
+                              float cx, float cy, float rx2, float ry2,
+                              float* out);
+
+        size_t (*countInEllipse)(const float* x, const float* y, size_t n,
+                                 float cx, float cy, float rx2, float ry2);
+    };
+
+
+    // The scalar kernels, also used for the remainder of the SIMD ones. They
+    // follow the Point2D operators exactly.
+
+    void
+    scalarTranslate(float* x, float* y, size_t n, float dx, float dy)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            x[i] += dx;
+            y[i] += dy;
+        }
+    }
+
+
+    void
+    scalarScale(float* x, float* y, size_t n, float sx, float sy)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            x[i] *= sx;
+            y[i] *= sy;
+        }
+    }
+
+
+    void
+    scalarBounds(const float* x, const float* y, size_t n, AABox& box)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            box.minX = x[i] < box.minX ? x[i] : box.minX;
+            box.minY = y[i] < box.minY ? y[i] : box.minY;
+            box.maxX = box.maxX < x[i] ? x[i] : box.maxX;
+            box.maxY = box.maxY < y[i] ? y[i] : box.maxY;
+        }
+    }
+
+
+    void
+    scalarDistancesTo(const float* x, const float* y, size_t n,
+                      float px, float py, float* out)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            float dx = px - x[i];
+            float dy = py - y[i];
+            out[i] = std::sqrt(dx * dx + dy * dy);
+        }
+    }
+
+
+    void
+    scalarDistances(const float* ax, const float* ay,
+                    const float* bx, const float* by, size_t n, float* out)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            float dx = bx[i] - ax[i];
+            float dy = by[i] - ay[i];
+            out[i] = std::sqrt(dx * dx + dy * dy);
+        }
+    }
+
+
+    void
+    scalarEllipseValues(const float* x, const float* y, size_t n,
+                        float cx, float cy, float rx2, float ry2, float* out)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            float dx = x[i] - cx;
+            float dy = y[i] - cy;
+            out[i] = (dx * dx) / rx2 + (dy * dy) / ry2;
+        }
+    }
+
+
+    size_t
+    scalarCountInEllipse(const float* x, const float* y, size_t n,
+                         float cx, float cy, float rx2, float ry2)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i != n; ++i)
+        {
+            float dx = x[i] - cx;
+            float dy = y[i] - cy;
+            if ((dx * dx) / rx2 + (dy * dy) / ry2 <= 1.f)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+
+    const KernelTable scalarKernels =
+    {
+        scalarTranslate,
+        scalarScale,
+        scalarBounds,
+        scalarDistancesTo,
+        scalarDistances,
+        scalarEllipseValues,
+        scalarCountInEllipse
+    };
+
+
+#ifdef POINTBUFFER_SSE2
+
+    void
+    sse2Translate(float* x, float* y, size_t n, float dx, float dy)
+    {
+        const __m128 vdx = _mm_set1_ps(dx);
+        const __m128 vdy = _mm_set1_ps(dy);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), vdx));
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), vdy));
+        }
+        scalarTranslate(x + i, y + i, n - i, dx, dy);
+    }
+
+
+    void
+    sse2Scale(float* x, float* y, size_t n, float sx, float sy)
+    {
+        const __m128 vsx = _mm_set1_ps(sx);
+        const __m128 vsy = _mm_set1_ps(sy);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), vsx));
+            _mm_storeu_ps(y + i, _mm_mul_ps(_mm_loadu_ps(y + i), vsy));
+        }
+        scalarScale(x + i, y + i, n - i, sx, sy);
+    }
+
+
+    float
+    sse2HorizontalMin(__m128 v)
+    {
+        float f[4];
+        _mm_storeu_ps(f, v);
+        float m = f[0];
+        for (int k = 1; k != 4; ++k)
+        {
+            m = f[k] < m ? f[k] : m;
+        }
+        return m;
+    }
+
+
+    float
+    sse2HorizontalMax(__m128 v)
+    {
+        float f[4];
+        _mm_storeu_ps(f, v);
+        float m = f[0];
+        for (int k = 1; k != 4; ++k)
+        {
+            m = m < f[k] ? f[k] : m;
+        }
+        return m;
+    }
+
+
+    void
+    sse2Bounds(const float* x, const float* y, size_t n, AABox& box)
+    {
+        __m128 minX = _mm_set1_ps(box.minX);
+        __m128 minY = _mm_set1_ps(box.minY);
+        __m128 maxX = _mm_set1_ps(box.maxX);
+        __m128 maxY = _mm_set1_ps(box.maxY);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 vy = _mm_loadu_ps(y + i);
+            minX = _mm_min_ps(minX, vx);
+            minY = _mm_min_ps(minY, vy);
+            maxX = _mm_max_ps(maxX, vx);
+            maxY = _mm_max_ps(maxY, vy);
+        }
+        box.minX = sse2HorizontalMin(minX);
+        box.minY = sse2HorizontalMin(minY);
+        box.maxX = sse2HorizontalMax(maxX);
+        box.maxY = sse2HorizontalMax(maxY);
+        scalarBounds(x + i, y + i, n - i, box);
+    }
+
+
+    void
+    sse2DistancesTo(const float* x, const float* y, size_t n,
+                    float px, float py, float* out)
+    {
+        const __m128 vpx = _mm_set1_ps(px);
+        const __m128 vpy = _mm_set1_ps(py);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 dx = _mm_sub_ps(vpx, _mm_loadu_ps(x + i));
+            __m128 dy = _mm_sub_ps(vpy, _mm_loadu_ps(y + i));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            _mm_storeu_ps(out + i, _mm_sqrt_ps(d2));
+        }
+        scalarDistancesTo(x + i, y + i, n - i, px, py, out + i);
+    }
+
+
+    void
+    sse2Distances(const float* ax, const float* ay,
+                  const float* bx, const float* by, size_t n, float* out)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(bx + i), _mm_loadu_ps(ax + i));
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(by + i), _mm_loadu_ps(ay + i));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            _mm_storeu_ps(out + i, _mm_sqrt_ps(d2));
+        }
+        scalarDistances(ax + i, ay + i, bx + i, by + i, n - i, out + i);
+    }
+
+
+    __m128
+    sse2EllipseValue(const float* x, const float* y, __m128 cx, __m128 cy,
+                     __m128 rx2, __m128 ry2)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y), cy);
+        return _mm_add_ps(_mm_div_ps(_mm_mul_ps(dx, dx), rx2),
+                          _mm_div_ps(_mm_mul_ps(dy, dy), ry2));
+    }
+
+
+    void
+    sse2EllipseValues(const float* x, const float* y, size_t n,
+                      float cx, float cy, float rx2, float ry2, float* out)
+    {
+        const __m128 vcx = _mm_set1_ps(cx);
+        const __m128 vcy = _mm_set1_ps(cy);
+        const __m128 vrx2 = _mm_set1_ps(rx2);
+        const __m128 vry2 = _mm_set1_ps(ry2);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(out + i,
+                sse2EllipseValue(x + i, y + i, vcx, vcy, vrx2, vry2));
+        }
+        scalarEllipseValues(x + i, y + i, n - i, cx, cy, rx2, ry2, out + i);
+    }
+
+
+    size_t
+    sse2CountInEllipse(const float* x, const float* y, size_t n,
+                       float cx, float cy, float rx2, float ry2)
+    {
+        const __m128 vcx = _mm_set1_ps(cx);
+        const __m128 vcy = _mm_set1_ps(cy);
+        const __m128 vrx2 = _mm_set1_ps(rx2);
+        const __m128 vry2 = _mm_set1_ps(ry2);
+        const __m128 one = _mm_set1_ps(1.f);
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 v = sse2EllipseValue(x + i, y + i, vcx, vcy, vrx2, vry2);
+            count += __builtin_popcount(_mm_movemask_ps(_mm_cmple_ps(v, one)));
+        }
+        return count + scalarCountInEllipse(x + i, y + i, n - i,
+                                            cx, cy, rx2, ry2);
+    }
+
+
+    const KernelTable sse2Kernels =
+    {
+        sse2Translate,
+        sse2Scale,
+        sse2Bounds,
+        sse2DistancesTo,
+        sse2Distances,
+        sse2EllipseValues,
+        sse2CountInEllipse
+    };
+
+#endif // POINTBUFFER_SSE2
+
+
+#ifdef POINTBUFFER_AVX2
+
+    AVX2_TARGET void
+    avx2Translate(float* x, float* y, size_t n, float dx, float dy)
+    {
+        const __m256 vdx = _mm256_set1_ps(dx);
+        const __m256 vdy = _mm256_set1_ps(dy);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), vdx));
+            _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), vdy));
+        }
+        scalarTranslate(x + i, y + i, n - i, dx, dy);
+    }
+
+
+    AVX2_TARGET void
+    avx2Scale(float* x, float* y, size_t n, float sx, float sy)
+    {
+        const __m256 vsx = _mm256_set1_ps(sx);
+        const __m256 vsy = _mm256_set1_ps(sy);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), vsx));
+            _mm256_storeu_ps(y + i, _mm256_mul_ps(_mm256_loadu_ps(y + i), vsy));
+        }
+        scalarScale(x + i, y + i, n - i, sx, sy);
+    }
+
+
+    AVX2_TARGET void
+    avx2Bounds(const float* x, const float* y, size_t n, AABox& box)
+    {
+        __m256 minX = _mm256_set1_ps(box.minX);
+        __m256 minY = _mm256_set1_ps(box.minY);
+        __m256 maxX = _mm256_set1_ps(box.maxX);
+        __m256 maxY = _mm256_set1_ps(box.maxY);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 vx = _mm256_loadu_ps(x + i);
+            __m256 vy = _mm256_loadu_ps(y + i);
+            minX = _mm256_min_ps(minX, vx);
+            minY = _mm256_min_ps(minY, vy);
+            maxX = _mm256_max_ps(maxX, vx);
+            maxY = _mm256_max_ps(maxY, vy);
+        }
+
+        float f[4][8];
+        _mm256_storeu_ps(f[0], minX);
+        _mm256_storeu_ps(f[1], minY);
+        _mm256_storeu_ps(f[2], maxX);
+        _mm256_storeu_ps(f[3], maxY);
+        for (int k = 0; k != 8; ++k)
+        {
+            box.minX = f[0][k] < box.minX ? f[0][k] : box.minX;
+            box.minY = f[1][k] < box.minY ? f[1][k] : box.minY;
+            box.maxX = box.maxX < f[2][k] ? f[2][k] : box.maxX;
+            box.maxY = box.maxY < f[3][k] ? f[3][k] : box.maxY;
+        }
+        scalarBounds(x + i, y + i, n - i, box);
+    }
+
+
+    AVX2_TARGET void
+    avx2DistancesTo(const float* x, const float* y, size_t n,
+                    float px, float py, float* out)
+    {
+        const __m256 vpx = _mm256_set1_ps(px);
+        const __m256 vpy = _mm256_set1_ps(py);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 dx = _mm256_sub_ps(vpx, _mm256_loadu_ps(x + i));
+            __m256 dy = _mm256_sub_ps(vpy, _mm256_loadu_ps(y + i));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                      _mm256_mul_ps(dy, dy));
+            _mm256_storeu_ps(out + i, _mm256_sqrt_ps(d2));
+        }
+        scalarDistancesTo(x + i, y + i, n - i, px, py, out + i);
+    }
+
+
+    AVX2_TARGET void
+    avx2Distances(const float* ax, const float* ay,
+                  const float* bx, const float* by, size_t n, float* out)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(bx + i),
+                                      _mm256_loadu_ps(ax + i));
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(by + i),
+                                      _mm256_loadu_ps(ay + i));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                      _mm256_mul_ps(dy, dy));
+            _mm256_storeu_ps(out + i, _mm256_sqrt_ps(d2));
+        }
+        scalarDistances(ax + i, ay + i, bx + i, by + i, n - i, out + i);
+    }
+
+
+    AVX2_TARGET __m256
+    avx2EllipseValue(const float* x, const float* y, __m256 cx, __m256 cy,
+                     __m256 rx2, __m256 ry2)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y), cy);
+        return _mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(dx, dx), rx2),
+                             _mm256_div_ps(_mm256_mul_ps(dy, dy), ry2));
+    }
+
+
+    AVX2_TARGET void
+    avx2EllipseValues(const float* x, const float* y, size_t n,
+                      float cx, float cy, float rx2, float ry2, float* out)
+    {
+        const __m256 vcx = _mm256_set1_ps(cx);
+        const __m256 vcy = _mm256_set1_ps(cy);
+        const __m256 vrx2 = _mm256_set1_ps(rx2);
+        const __m256 vry2 = _mm256_set1_ps(ry2);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(out + i,
+                avx2EllipseValue(x + i, y + i, vcx, vcy, vrx2, vry2));
+        }
+        scalarEllipseValues(x + i, y + i, n - i, cx, cy, rx2, ry2, out + i);
+    }
+
+
+    AVX2_TARGET size_t
+    avx2CountInEllipse(const float* x, const float* y, size_t n,
+                       float cx, float cy, float rx2, float ry2)
+    {
+        const __m256 vcx = _mm256_set1_ps(cx);
+        const __m256 vcy = _mm256_set1_ps(cy);
+        const __m256 vrx2 = _mm256_set1_ps(rx2);
+        const __m256 vry2 = _mm256_set1_ps(ry2);
+        const __m256 one = _mm256_set1_ps(1.f);
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 v = avx2EllipseValue(x + i, y + i, vcx, vcy, vrx2, vry2);
+            count += __builtin_popcount(
+                _mm256_movemask_ps(_mm256_cmp_ps(v, one, _CMP_LE_OQ)));
+        }
+        return count + scalarCountInEllipse(x + i, y + i, n - i,
+                                            cx, cy, rx2, ry2);
+    }
+
+
+    const KernelTable avx2Kernels =
+    {
+        avx2Translate,
+        avx2Scale,
+        avx2Bounds,
+        avx2DistancesTo,
+        avx2Distances,
+        avx2EllipseValues,
+        avx2CountInEllipse
+    };
+
+#endif // POINTBUFFER_AVX2
+
+
+    const KernelTable*
+    kernelTable(PointBuffer::Kernel k)
+    {
+        switch (k)
+        {
+#ifdef POINTBUFFER_AVX2
+        case PointBuffer::AVX2Kernel:
+            return __builtin_cpu_supports("avx2") ? &avx2Kernels : 0;
+#endif
+#ifdef POINTBUFFER_SSE2
+        case PointBuffer::SSE2Kernel:
+            return &sse2Kernels;
+#endif
+        case PointBuffer::ScalarKernel:
+            return &scalarKernels;
+        default:
+            return 0;
+        }
+    }
+
+
+    PointBuffer::Kernel
+    bestKernel()
+    {
+        if (kernelTable(PointBuffer::AVX2Kernel))
+        {
+            return PointBuffer::AVX2Kernel;
+        }
+        if (kernelTable(PointBuffer::SSE2Kernel))
+        {
+            return PointBuffer::SSE2Kernel;
+        }
+        return PointBuffer::ScalarKernel;
+    }
+
+
+    struct ActiveKernel
+    {
+        ActiveKernel()
+        :   kernel(bestKernel()),
+            table(kernelTable(kernel))
+        {}
+
+        PointBuffer::Kernel kernel;
+
+        const KernelTable* table;
+    };
+
+
+    // Initialised on first use, which is thread-safe
+    ActiveKernel&
+    active()
+    {
+        static ActiveKernel a;
+        return a;
+    }
+
+
+    const KernelTable&
+    kernels()
+    {
+        return *active().table;
+    }
+
+}
+
+
+PointBuffer::PointBuffer()
+{}
+
+
+PointBuffer::PointBuffer(size_t n)
+:   x_(n, 0.f),
+    y_(n, 0.f)
+{}
+
+
+PointBuffer::PointBuffer(const Point2D* points, size_t n)
+:   x_(n),
+    y_(n)
+{
+    for (size_t i = 0; i != n; ++i)
+    {
+        x_[i] = points[i].x;
+        y_[i] = points[i].y;
+    }
+}
+
+
+PointBuffer::~PointBuffer()
+{}
+
+
+size_t
+PointBuffer::size() const
+{
+    return x_.size();
+}
+
+
+bool
+PointBuffer::empty() const
+{
+    return x_.empty();
+}
+
+
+void
+PointBuffer::resize(size_t n)
+{
+    x_.resize(n, 0.f);
+    y_.resize(n, 0.f);
+}
+
+
+void
+PointBuffer::reserve(size_t n)
+{
+    x_.reserve(n);
+    y_.reserve(n);
+}
+
+
+void
+PointBuffer::clear()
+{
+    x_.clear();
+    y_.clear();
+}
+
+
+void
+PointBuffer::push_back(const Point2D& p)
+{
+    x_.push_back(p.x);
+    y_.push_back(p.y);
+}
+
+
+Point2D
+PointBuffer::operator[](size_t i) const
+{
+    return Point2D(x_[i], y_[i]);
+}
+
+
+void
+PointBuffer::set(size_t i, const Point2D& p)
+{
+    x_[i] = p.x;
+    y_[i] = p.y;
+}
+
+
+float*
+PointBuffer::x()
+{
+    return x_.data();
+}
+
+
+float*
+PointBuffer::y()
+{
+    return y_.data();
+}
+
+
+const float*
+PointBuffer::x() const
+{
+    return x_.data();
+}
+
+
+const float*
+PointBuffer::y() const
+{
+    return y_.data();
+}
+
+
+void
+PointBuffer::translate(const Point2D& delta)
+{
+    kernels().translate(x_.data(), y_.data(), size(), delta.x, delta.y);
+}
+
+
+void
+PointBuffer::scale(const Point2D& factor)
+{
+    kernels().scale(x_.data(), y_.data(), size(), factor.x, factor.y);
+}
+
+
+AABox
+PointBuffer::bounds() const
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    AABox box = { inf, inf, -inf, -inf };
+    kernels().bounds(x_.data(), y_.data(), size(), box);
+    return box;
+}
+
+
+void
+PointBuffer::distances(const Point2D& p, float* out) const
+{
+    kernels().distancesTo(x_.data(), y_.data(), size(), p.x, p.y, out);
+}
+
+
+void
+PointBuffer::distances(const PointBuffer& other, float* out) const
+{
+    kernels().distances(x_.data(), y_.data(), other.x_.data(),
+                        other.y_.data(), size(), out);
+}
+
+
+void
+PointBuffer::ellipseValues(
+    const Point2D& center, const Point2D& radius, float* out) const
+{
+    kernels().ellipseValues(x_.data(), y_.data(), size(), center.x, center.y,
+                            radius.x * radius.x, radius.y * radius.y, out);
+}
+
+
+size_t
+PointBuffer::countInEllipse(const Point2D& center, const Point2D& radius) const
+{
+    return kernels().countInEllipse(x_.data(), y_.data(), size(),
+                                    center.x, center.y,
+                                    radius.x * radius.x, radius.y * radius.y);
+}
+
+
+PointBuffer::Kernel
+PointBuffer::kernel()
+{
+    return active().kernel;
+}
+
+
+bool
+PointBuffer::setKernel(Kernel k)
+{
+    const KernelTable* table = kernelTable(k);
+    if (!table)
+    {
+        return false;
+    }
+    active().kernel = k;
+    active().table = table;
+    return true;
+}
+
+
+bool
+PointBuffer::isSupported(Kernel k)
+{
+    return kernelTable(k) != 0;
+}
+
+
+const char*
+PointBuffer::kernelName(Kernel k)
+{
+    switch (k)
+    {
+    case AVX2Kernel:
+        return "avx2";
+    case SSE2Kernel:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+
+} // namespace geom
@@ -0,0 +1,192 @@
+#include "Predicates.h"
+
+#include <cmath>
+
+namespace geom
+{
+
+
+namespace
+{
+
+    // Expansion arithmetic after Shewchuk. An expansion is a sum of doubles
+    // ordered by increasing magnitude whose nonzero components do not
+    // overlap; its sign is that of its last (largest) component. Without
+    // FMA hardware, products are split after Dekker, which needs every
+    // multiplication and addition to be rounded separately (no contraction).
+
+    inline void
+    twoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        double bVirt = x - a;
+        double aVirt = x - bVirt;
+        y = (a - aVirt) + (b - bVirt);
+    }
+
+
+    inline void
+    fastTwoSum(double a, double b, double& x, double& y)
+    {
+        // Requires |a| >= |b|
+        x = a + b;
+        y = b - (x - a);
+    }
+
+
+    inline void
+    twoDiff(double a, double b, double& x, double& y)
+    {
+        x = a - b;
+        double bVirt = a - x;
+        double aVirt = x + bVirt;
+        y = (a - aVirt) + (bVirt - b);
+    }
+
+
+    inline void
+    twoProduct(double a, double b, double& x, double& y)
+    {
+        x = a * b;
+#ifdef FP_FAST_FMA
+        y = std::fma(a, b, -x);
+#else
+        // 2^27 + 1
+        const double splitter = 134217729.;
+
+        double c = splitter * a;
+        double aHi = c - (c - a);
+        double aLo = a - aHi;
+        c = splitter * b;
+        double bHi = c - (c - b);
+        double bLo = b - bHi;
+
+        double err = x - aHi * bHi;
+        err -= aLo * bHi;
+        err -= aHi * bLo;
+        y = aLo * bLo - err;
+#endif
+    }
+
+
+    /// h = e * b; h must hold 2 * eLen components. Returns the length of h.
+    int
+    scaleExpansion(int eLen, const double* e, double b, double* h)
+    {
+        int hLen = 0;
+        double q, hh;
+        twoProduct(e[0], b, q, hh);
+        if (hh != 0.)
+        {
+            h[hLen++] = hh;
+        }
+
+        for (int i = 1; i < eLen; ++i)
+        {
+            double product1, product0, sum;
+            twoProduct(e[i], b, product1, product0);
+            twoSum(q, product0, sum, hh);
+            if (hh != 0.)
+            {
+                h[hLen++] = hh;
+            }
+            fastTwoSum(product1, sum, q, hh);
+            if (hh != 0.)
+            {
+                h[hLen++] = hh;
+            }
+        }
+
+        if (q != 0. || hLen == 0)
+        {
+            h[hLen++] = q;
+        }
+        return hLen;
+    }
+
+
+    /// h = e + b; h must hold eLen + 1 components and may be e. Returns
+    /// the length of h.
+    int
+    growExpansion(int eLen, const double* e, double b, double* h)
+    {
+        int hLen = 0;
+        double q = b;
+        for (int i = 0; i < eLen; ++i)
+        {
+            double sum, hh;
+            twoSum(q, e[i], sum, hh);
+            q = sum;
+            if (hh != 0.)
+            {
+                h[hLen++] = hh;
+            }
+        }
+        if (q != 0. || hLen == 0)
+        {
+            h[hLen++] = q;
+        }
+        return hLen;
+    }
+
+
+    /// h = e + f, by adding the components of f one by one; h must hold
+    /// eLen + fLen components. Returns the length of h.
+    int
+    sumExpansions(int eLen, const double* e, int fLen, const double* f,
+                  double* h)
+    {
+        for (int i = 0; i < eLen; ++i)
+        {
+            h[i] = e[i];
+        }
+        int hLen = eLen;
+        for (int j = 0; j < fLen; ++j)
+        {
+            hLen = growExpansion(hLen, h, f[j], h);
+        }
+        return hLen;
+    }
+
+
+    /// h = a * b for two expansions of two components; h must hold 8
+    int
+    multiplyTwoByTwo(const double* a, const double* b, double* h)
+    {
+        double p0[4], p1[4];
+        int len0 = scaleExpansion(2, a, b[0], p0);
+        int len1 = scaleExpansion(2, a, b[1], p1);
+        return sumExpansions(len0, p0, len1, p1, h);
+    }
+
+}
+
+
+double
+orient2dExact(double ax, double ay,
+              double bx, double by,
+              double cx, double cy)
+{
+    // (ax - cx) * (by - cy) - (ay - cy) * (bx - cx), each difference as an
+    // expansion of two components (low first)
+    double acx[2], acy[2], bcx[2], bcy[2];
+    twoDiff(ax, cx, acx[1], acx[0]);
+    twoDiff(ay, cy, acy[1], acy[0]);
+    twoDiff(bx, cx, bcx[1], bcx[0]);
+    twoDiff(by, cy, bcy[1], bcy[0]);
+
+    double left[8], right[8];
+    int leftLen = multiplyTwoByTwo(acx, bcy, left);
+    int rightLen = multiplyTwoByTwo(acy, bcx, right);
+    for (int i = 0; i != rightLen; ++i)
+    {
+        right[i] = -right[i];
+    }
+
+    double det[16];
+    int detLen = sumExpansions(leftLen, left, rightLen, right, det);
+    return det[detLen - 1];
+}
+
+
+} // namespace geom
@@ -1,93 +1,104 @@
 #include "Rectangle.h"
 
 #include "SegmentedShape.h"
-#include "LineSegment.h"
 
 namespace geom
 {
 
-Rectangle::Rectangle()
-:   LineBasedShape(TRectangle)
+template <typename T>
+BasicRectangle<T>::BasicRectangle()
+:   BasicLineBasedShape<T>(ShapeTypes::TRectangle)
 {
-    lines_ = r_.lines_;
+    this->lines_ = r_.edges_.lines;
 }
 
 
-Rectangle::Rectangle(const Point2D& p1, const Point2D& p2)
-:   LineBasedShape(TRectangle),
-    r_(GenericRect(p1, p2))
+template <typename T>
+BasicRectangle<T>::BasicRectangle(const Point& p1, const Point& p2)
+:   BasicLineBasedShape<T>(ShapeTypes::TRectangle),
+    r_(BasicGenericRect<T>(p1, p2))
 {
-    lines_ = r_.lines_;
+    this->lines_ = r_.edges_.lines;
 }
 
 
-Rectangle::~Rectangle()
+template <typename T>
+BasicRectangle<T>::~BasicRectangle()
 {}
 
 
+template <typename T>
 void
-Rectangle::p1p2(const Point2D& p1, const Point2D& p2)
+BasicRectangle<T>::p1p2(const Point& p1, const Point& p2)
 {
     r_.p1(p1);
     r_.p2(p2);
-    dirty_ = true;
+    this->markDirty();
 }
 
 
+template <typename T>
 void
-Rectangle::performCleaning() const
+BasicRectangle<T>::performShapeCleaning() const
 {
-    r_.makeClean();
+    // Sets up the edge lines as well, they are used directly as lines_
+    r_.lines();
 }
 
 
+template <typename T>
 void
-Rectangle::calculateBoundingBox(GenericRect& bb) const
+BasicRectangle<T>::calculateBoundingBox(BasicAABox<T>& bb) const
 {
-    bb = r_;
+    bb = BasicAABox<T>::fromCorners(r_.p1(), r_.p2());
 }
 
 
+template <typename T>
 void
-Rectangle::moveBy(const Point2D& delta)
+BasicRectangle<T>::moveBy(const Point& delta)
 {
     r_.moveBy(delta);
-    dirty_ = true;
+    this->markDirty();
 }
 
 
-SegmentedShape*
-Rectangle::toSegmentedShape() const
+template <typename T>
+BasicSegmentedShape<T>*
+BasicRectangle<T>::toSegmentedShape(Arena* arena) const
 {
     CLEAN_IF_DIRTY(this);
 
+    typedef BasicSegmentPoint<T> SegmentPoint;
+    const BasicGenericLine<T>* lines = this->lines_;
     SegmentPoint sp[] =
     {
-        SegmentPoint(r_.p1_, 0.f, &lines_[0]),
-        SegmentPoint(r_.topRight_, 0.f, &lines_[1]),
-        SegmentPoint(r_.p2_, 0.f, &lines_[2]),
-        SegmentPoint(r_.bottomLeft_, 0.f, &lines_[3])
+        SegmentPoint(r_.p1_, 0, &lines[0]),
+        SegmentPoint(r_.topRight_, 0, &lines[1]),
+        SegmentPoint(r_.p2_, 0, &lines[2]),
+        SegmentPoint(r_.bottomLeft_, 0, &lines[3])
     };
 
-    LineSegment* end = new LineSegment(sp[3], Segment::Positive);
-    LineSegment* middle2 = new LineSegment(sp[2], end, Segment::Positive);
-    LineSegment* middle1 = new LineSegment(sp[1], middle2, Segment::Positive);
-    LineSegment* start = new LineSegment(sp[0], middle1, Segment::Positive);
-    end->next(start);
-
-    return new SegmentedShape(this, start);
+    BasicSegmentedShape<T>* shape = new BasicSegmentedShape<T>(this, arena);
+    for (int i = 0; i != 4; ++i)
+    {
+        shape->addSegment(sp[i], BasicSegment<T>::LineElement);
+    }
+    return shape;
 }
 
 
+template <typename T>
 int
-Rectangle::getNumLines() const
+BasicRectangle<T>::getNumLines() const
 {
-    return 4;
+    return NumLines;
 }
 
 
+template <typename T>
 bool
-Rectangle::containsPoint(const Point2D& p) const
+BasicRectangle<T>::containsPoint(const Point& p) const
 {
     CLEAN_IF_DIRTY(this);
 
@@ -95,4 +106,8 @@ Rectangle::containsPoint(const Point2D& p) const
 }
 
 
+template class BasicRectangle<float>;
+template class BasicRectangle<double>;
+
+
 } // namespace geom
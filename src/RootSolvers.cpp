@@ -48,6 +48,201 @@ namespace
     }
 
 
+    // A polynomial of degree <= 4, highest order coefficient first
+    struct Polynomial
+    {
+        double c[5];
+        int degree; // -1 for the zero polynomial
+    };
+
+
+    // Drops leading coefficients that vanish relative to the largest one and
+    // scales the rest to a maximum magnitude of 1 (signs stay untouched)
+    void
+    normalise(Polynomial& p)
+    {
+        double maxAbs = 0.;
+        for (int i = 0; i <= p.degree; ++i)
+        {
+            maxAbs = std::max(maxAbs, std::abs(p.c[i]));
+        }
+
+        if (maxAbs == 0.)
+        {
+            p.degree = -1;
+            return;
+        }
+
+        int lead = 0;
+        while (lead < p.degree && std::abs(p.c[lead]) <= 1e-10 * maxAbs)
+        {
+            ++lead;
+        }
+
+        p.degree -= lead;
+        for (int i = 0; i <= p.degree; ++i)
+        {
+            p.c[i] = p.c[i + lead] / maxAbs;
+        }
+    }
+
+
+    double
+    evaluate(const Polynomial& p, double x)
+    {
+        double y = 0.;
+        for (int i = 0; i <= p.degree; ++i)
+        {
+            y = y * x + p.c[i];
+        }
+        return y;
+    }
+
+
+    // r = -(a mod b), as required for the next element of a Sturm sequence
+    void
+    negatedRemainder(const Polynomial& a, const Polynomial& b, Polynomial& r)
+    {
+        double rem[5];
+        for (int i = 0; i <= a.degree; ++i)
+        {
+            rem[i] = a.c[i];
+        }
+
+        for (int i = 0; i <= a.degree - b.degree; ++i)
+        {
+            double f = rem[i] / b.c[0];
+            for (int j = 0; j <= b.degree; ++j)
+            {
+                rem[i + j] -= f * b.c[j];
+            }
+        }
+
+        r.degree = b.degree - 1;
+        for (int i = 0; i <= r.degree; ++i)
+        {
+            r.c[i] = -rem[a.degree - r.degree + i];
+        }
+        normalise(r);
+    }
+
+
+    int
+    signChanges(const Polynomial seq[], int length, double x)
+    {
+        int changes = 0;
+        int lastSign = 0;
+        for (int i = 0; i != length; ++i)
+        {
+            int s = sign(evaluate(seq[i], x));
+            if (s != 0)
+            {
+                if (lastSign != 0 && s != lastSign)
+                {
+                    ++changes;
+                }
+                lastSign = s;
+            }
+        }
+        return changes;
+    }
+
+
+    // Sets up the Sturm sequence of the polynomial coeffs[0]*x^degree + ...:
+    // p0 = p, p1 = p', p(k+1) = -(p(k-1) mod p(k)). Returns its length, 0 if
+    // p is constant.
+    int
+    sturmSequence(const double coeffs[], int degree, Polynomial seq[5])
+    {
+        seq[0].degree = degree;
+        for (int i = 0; i <= degree; ++i)
+        {
+            seq[0].c[i] = coeffs[i];
+        }
+        normalise(seq[0]);
+
+        if (seq[0].degree < 1)
+        {
+            return 0;
+        }
+
+        seq[1].degree = seq[0].degree - 1;
+        for (int i = 0; i <= seq[1].degree; ++i)
+        {
+            seq[1].c[i] = seq[0].c[i] * (seq[0].degree - i);
+        }
+        normalise(seq[1]);
+
+        int length = 2;
+        while (seq[length - 1].degree > 0)
+        {
+            negatedRemainder(seq[length - 2], seq[length - 1], seq[length]);
+            if (seq[length].degree < 0)
+            {
+                // Remainder vanished: p has multiple roots, the last element
+                // is their gcd, which doesn't affect the count of distinct
+                // roots
+                break;
+            }
+            ++length;
+        }
+        return length;
+    }
+
+
+    // Narrows (lo, hi], holding exactly one distinct root of seq[0], down to
+    // the precision of double and returns the root. A root of odd
+    // multiplicity changes the sign of the polynomial, so plain bisection
+    // finds it; one of even multiplicity (a tangency) does not, so the
+    // bisection goes by the Sturm counts instead.
+    double
+    refineRoot(const Polynomial seq[], int length, double lo, double hi)
+    {
+        int signLo = sign(evaluate(seq[0], lo));
+        int signHi = sign(evaluate(seq[0], hi));
+        if (signHi == 0)
+        {
+            return hi;
+        }
+        bool bySign = signLo != 0 && signLo != signHi;
+        int changesHi = signChanges(seq, length, hi);
+
+        for (int i = 0; i != 200; ++i)
+        {
+            double mid = 0.5 * (lo + hi);
+            if (mid <= lo || mid >= hi)
+            {
+                break;
+            }
+
+            bool inLower;
+            if (bySign)
+            {
+                int signMid = sign(evaluate(seq[0], mid));
+                if (signMid == 0)
+                {
+                    return mid;
+                }
+                inLower = signMid != signLo;
+            }
+            else
+            {
+                inLower = signChanges(seq, length, mid) != changesHi;
+            }
+
+            if (inLower)
+            {
+                hi = mid;
+            }
+            else
+            {
+                lo = mid;
+            }
+        }
+        return 0.5 * (lo + hi);
+    }
+
+
     // 4x^3 + 3alpha*x^2 + 2beta*x + gamma = y
     struct DerivedQuarticFunc : geom::Func {
         double alpha, beta, gamma;
@@ -285,6 +480,89 @@ findQuarticRoots(
 }
 
 
+int
+countRealRoots(const double coeffs[], int degree, double lo, double hi)
+{
+    // The number of distinct roots in (lo, hi] is the difference of the
+    // numbers of sign changes along the Sturm sequence at lo and hi
+    Polynomial seq[5];
+    int length = sturmSequence(coeffs, degree, seq);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    return signChanges(seq, length, lo) - signChanges(seq, length, hi);
+}
+
+
+int
+findRealRoots(const double coeffs[],
+              int degree,
+              double lo,
+              double hi,
+              double roots[])
+{
+    Polynomial seq[5];
+    int length = sturmSequence(coeffs, degree, seq);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    // Splits the range until each part holds a single root; the parts still
+    // to look at are kept on a stack, upper halves first, so the roots come
+    // out in ascending order
+    struct Range
+    {
+        double lo, hi;
+        int changesLo, changesHi;
+    };
+
+    Range stack[64];
+    int top = 0;
+    Range all = { lo, hi, signChanges(seq, length, lo),
+                  signChanges(seq, length, hi) };
+    stack[top++] = all;
+
+    int numRoots = 0;
+    while (top != 0)
+    {
+        Range range = stack[--top];
+        int count = range.changesLo - range.changesHi;
+        if (count <= 0)
+        {
+            continue;
+        }
+
+        if (count == 1)
+        {
+            roots[numRoots++] = refineRoot(seq, length, range.lo, range.hi);
+            continue;
+        }
+
+        double mid = 0.5 * (range.lo + range.hi);
+        if (mid <= range.lo || mid >= range.hi || top + 2 > 64)
+        {
+            // Roots closer than double can tell apart
+            for (int i = 0; i != count; ++i)
+            {
+                roots[numRoots++] = mid;
+            }
+            continue;
+        }
+
+        int changesMid = signChanges(seq, length, mid);
+        Range upper = { mid, range.hi, changesMid, range.changesHi };
+        Range lower = { range.lo, mid, range.changesLo, changesMid };
+        stack[top++] = upper;
+        stack[top++] = lower;
+    }
+
+    return numRoots;
+}
+
+
 bool newtonRoot(
     const Func& func,
     const Func& derivedFunc,
@@ -0,0 +1,461 @@
+#include "SegmentBuffer.h"
+
+#include <cmath>
+
+#include "Limits.h"
+#include "GenericLine.h"
+#include "PointBuffer.h"
+#include "SegmentPointVector.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SEGMENTBUFFER_SSE2
+#endif
+
+// See PointBuffer.cpp
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SEGMENTBUFFER_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace geom
+{
+
+
+namespace
+{
+
+    // Pairs whose cross product r x s is not larger than its own rounding
+    // error are treated as parallel
+    const float parallelTolerance = Tolerance<float>::relative();
+
+
+    /// A segment p + t * r of the first buffer, to be tested against a row
+    /// of segments q + t2 * s of the second one
+    struct Row
+    {
+        int i;
+
+        float px, py;
+
+        float rx, ry;
+    };
+
+
+    struct Sink
+    {
+        Sink(const SegmentBuffer& a,
+             const SegmentBuffer& b,
+             std::vector<SegmentHit>* hits)
+        :   a(a),
+            b(b),
+            hits(hits),
+            count(0)
+        {}
+
+        void hit(int i, int j, float t, float t2)
+        {
+            if (hits)
+            {
+                SegmentHit h = { i, j, t, t2 };
+                hits->push_back(h);
+            }
+            ++count;
+        }
+
+        const SegmentBuffer& a;
+
+        const SegmentBuffer& b;
+
+        // Null if only counting
+        std::vector<SegmentHit>* hits;
+
+        size_t count;
+
+        // For degeneratePair()
+        SegmentPointVector points;
+    };
+
+
+    /// Parallel, collinear and zero-length cases, as done by GenericLine
+    void
+    degeneratePair(int i, int j, Sink& sink)
+    {
+        GenericLine a(sink.a.p1(i), sink.a.p2(i));
+        GenericLine b(sink.b.p1(j), sink.b.p2(j));
+
+        if (!sink.hits)
+        {
+            sink.count += a.countIntersections(b);
+            return;
+        }
+
+        int n = 0;
+        sink.points.clear();
+        a.isIntersectedBy(b, sink.points, n);
+        for (size_t k = 0; k != sink.points.size(); ++k)
+        {
+            sink.hit(i, j, sink.points[k].t, sink.points[k].t2);
+        }
+    }
+
+
+    // The scalar kernel, also used for the remainder of the SIMD ones. With
+    // w = q - p, the segments meet at t = (w x s) / (r x s) and
+    // t2 = (w x r) / (r x s); both must lie in [0, 1]. After flipping the
+    // signs so that r x s > 0, this is decided without dividing.
+
+    inline void
+    scalarPair(const Row& row, float qx, float qy, float q2x, float q2y,
+               int j, Sink& sink)
+    {
+        float sx = q2x - qx;
+        float sy = q2y - qy;
+
+        float a = row.rx * sy;
+        float b = row.ry * sx;
+        float denom = a - b;
+        if (std::abs(denom) <= parallelTolerance * (std::abs(a) + std::abs(b)))
+        {
+            degeneratePair(row.i, j, sink);
+            return;
+        }
+
+        float wx = qx - row.px;
+        float wy = qy - row.py;
+        float tn = wx * sy - wy * sx;
+        float un = wx * row.ry - wy * row.rx;
+        if (denom < 0.f)
+        {
+            denom = -denom;
+            tn = -tn;
+            un = -un;
+        }
+
+        if (tn >= 0.f && tn <= denom && un >= 0.f && un <= denom)
+        {
+            sink.hit(row.i, j, tn / denom, un / denom);
+        }
+    }
+
+
+    void
+    scalarRow(const Row& row, const float* x1, const float* y1,
+              const float* x2, const float* y2, size_t begin, size_t end,
+              Sink& sink)
+    {
+        for (size_t j = begin; j != end; ++j)
+        {
+            scalarPair(row, x1[j], y1[j], x2[j], y2[j], (int)j, sink);
+        }
+    }
+
+
+    /// Reports the lanes of a SIMD step: hits with their parameters, and the
+    /// degenerate pairs via GenericLine, in the order of j
+    inline void
+    reportLanes(const Row& row, size_t j, int mask, int hitMask,
+                const float* t, const float* t2, Sink& sink)
+    {
+        while (mask)
+        {
+            int k = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            if (hitMask & (1 << k))
+            {
+                sink.hit(row.i, (int)j + k, t[k], t2[k]);
+            }
+            else
+            {
+                degeneratePair(row.i, (int)j + k, sink);
+            }
+        }
+    }
+
+
+#ifdef SEGMENTBUFFER_SSE2
+
+    void
+    sse2Row(const Row& row, const float* x1, const float* y1,
+            const float* x2, const float* y2, size_t begin, size_t end,
+            Sink& sink)
+    {
+        const __m128 px = _mm_set1_ps(row.px);
+        const __m128 py = _mm_set1_ps(row.py);
+        const __m128 rx = _mm_set1_ps(row.rx);
+        const __m128 ry = _mm_set1_ps(row.ry);
+        const __m128 tol = _mm_set1_ps(parallelTolerance);
+        const __m128 signBit = _mm_set1_ps(-0.f);
+        const __m128 zero = _mm_setzero_ps();
+
+        size_t j = begin;
+        for (; j + 4 <= end; j += 4)
+        {
+            __m128 qx = _mm_loadu_ps(x1 + j);
+            __m128 qy = _mm_loadu_ps(y1 + j);
+            __m128 sx = _mm_sub_ps(_mm_loadu_ps(x2 + j), qx);
+            __m128 sy = _mm_sub_ps(_mm_loadu_ps(y2 + j), qy);
+
+            __m128 a = _mm_mul_ps(rx, sy);
+            __m128 b = _mm_mul_ps(ry, sx);
+            __m128 denom = _mm_sub_ps(a, b);
+            __m128 bound = _mm_mul_ps(tol, _mm_add_ps(_mm_andnot_ps(signBit, a),
+                                                      _mm_andnot_ps(signBit, b)));
+            __m128 degenerate =
+                _mm_cmple_ps(_mm_andnot_ps(signBit, denom), bound);
+
+            __m128 wx = _mm_sub_ps(qx, px);
+            __m128 wy = _mm_sub_ps(qy, py);
+            __m128 tn = _mm_sub_ps(_mm_mul_ps(wx, sy), _mm_mul_ps(wy, sx));
+            __m128 un = _mm_sub_ps(_mm_mul_ps(wx, ry), _mm_mul_ps(wy, rx));
+
+            __m128 sign = _mm_and_ps(denom, signBit);
+            denom = _mm_xor_ps(denom, sign);
+            tn = _mm_xor_ps(tn, sign);
+            un = _mm_xor_ps(un, sign);
+
+            __m128 hit = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(tn, zero), _mm_cmple_ps(tn, denom)),
+                _mm_and_ps(_mm_cmpge_ps(un, zero), _mm_cmple_ps(un, denom)));
+            hit = _mm_andnot_ps(degenerate, hit);
+
+            int mask = _mm_movemask_ps(_mm_or_ps(hit, degenerate));
+            if (mask)
+            {
+                float t[4], t2[4];
+                _mm_storeu_ps(t, _mm_div_ps(tn, denom));
+                _mm_storeu_ps(t2, _mm_div_ps(un, denom));
+                reportLanes(row, j, mask, _mm_movemask_ps(hit), t, t2, sink);
+            }
+        }
+
+        scalarRow(row, x1, y1, x2, y2, j, end, sink);
+    }
+
+#endif // SEGMENTBUFFER_SSE2
+
+
+#ifdef SEGMENTBUFFER_AVX2
+
+    AVX2_TARGET void
+    avx2Row(const Row& row, const float* x1, const float* y1,
+            const float* x2, const float* y2, size_t begin, size_t end,
+            Sink& sink)
+    {
+        const __m256 px = _mm256_set1_ps(row.px);
+        const __m256 py = _mm256_set1_ps(row.py);
+        const __m256 rx = _mm256_set1_ps(row.rx);
+        const __m256 ry = _mm256_set1_ps(row.ry);
+        const __m256 tol = _mm256_set1_ps(parallelTolerance);
+        const __m256 signBit = _mm256_set1_ps(-0.f);
+        const __m256 zero = _mm256_setzero_ps();
+
+        size_t j = begin;
+        for (; j + 8 <= end; j += 8)
+        {
+            __m256 qx = _mm256_loadu_ps(x1 + j);
+            __m256 qy = _mm256_loadu_ps(y1 + j);
+            __m256 sx = _mm256_sub_ps(_mm256_loadu_ps(x2 + j), qx);
+            __m256 sy = _mm256_sub_ps(_mm256_loadu_ps(y2 + j), qy);
+
+            __m256 a = _mm256_mul_ps(rx, sy);
+            __m256 b = _mm256_mul_ps(ry, sx);
+            __m256 denom = _mm256_sub_ps(a, b);
+            __m256 bound = _mm256_mul_ps(
+                tol, _mm256_add_ps(_mm256_andnot_ps(signBit, a),
+                                   _mm256_andnot_ps(signBit, b)));
+            __m256 degenerate = _mm256_cmp_ps(
+                _mm256_andnot_ps(signBit, denom), bound, _CMP_LE_OQ);
+
+            __m256 wx = _mm256_sub_ps(qx, px);
+            __m256 wy = _mm256_sub_ps(qy, py);
+            __m256 tn = _mm256_sub_ps(_mm256_mul_ps(wx, sy),
+                                      _mm256_mul_ps(wy, sx));
+            __m256 un = _mm256_sub_ps(_mm256_mul_ps(wx, ry),
+                                      _mm256_mul_ps(wy, rx));
+
+            __m256 sign = _mm256_and_ps(denom, signBit);
+            denom = _mm256_xor_ps(denom, sign);
+            tn = _mm256_xor_ps(tn, sign);
+            un = _mm256_xor_ps(un, sign);
+
+            __m256 hit = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(tn, zero, _CMP_GE_OQ),
+                              _mm256_cmp_ps(tn, denom, _CMP_LE_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(un, zero, _CMP_GE_OQ),
+                              _mm256_cmp_ps(un, denom, _CMP_LE_OQ)));
+            hit = _mm256_andnot_ps(degenerate, hit);
+
+            int mask = _mm256_movemask_ps(_mm256_or_ps(hit, degenerate));
+            if (mask)
+            {
+                float t[8], t2[8];
+                _mm256_storeu_ps(t, _mm256_div_ps(tn, denom));
+                _mm256_storeu_ps(t2, _mm256_div_ps(un, denom));
+                reportLanes(row, j, mask, _mm256_movemask_ps(hit), t, t2,
+                            sink);
+            }
+        }
+
+        scalarRow(row, x1, y1, x2, y2, j, end, sink);
+    }
+
+#endif // SEGMENTBUFFER_AVX2
+
+
+    typedef void (*RowKernel)(const Row& row, const float* x1,
+                              const float* y1, const float* x2,
+                              const float* y2, size_t begin, size_t end,
+                              Sink& sink);
+
+
+    RowKernel
+    rowKernel()
+    {
+        switch (PointBuffer::kernel())
+        {
+#ifdef SEGMENTBUFFER_AVX2
+        case PointBuffer::AVX2Kernel:
+            return avx2Row;
+#endif
+#ifdef SEGMENTBUFFER_SSE2
+        case PointBuffer::SSE2Kernel:
+            return sse2Row;
+#endif
+        default:
+            return scalarRow;
+        }
+    }
+
+
+    void
+    intersectAll(const SegmentBuffer& a,
+                 const SegmentBuffer& b,
+                 const float* x1, const float* y1,
+                 const float* x2, const float* y2,
+                 Sink& sink)
+    {
+        const RowKernel kernel = rowKernel();
+
+        for (size_t i = 0; i != a.size(); ++i)
+        {
+            Point2D p1 = a.p1(i);
+            Point2D p2 = a.p2(i);
+            Row row = { (int)i, p1.x, p1.y, p2.x - p1.x, p2.y - p1.y };
+            kernel(row, x1, y1, x2, y2, 0, b.size(), sink);
+        }
+    }
+
+}
+
+
+SegmentBuffer::SegmentBuffer()
+{}
+
+
+SegmentBuffer::~SegmentBuffer()
+{}
+
+
+size_t
+SegmentBuffer::size() const
+{
+    return x1_.size();
+}
+
+
+bool
+SegmentBuffer::empty() const
+{
+    return x1_.empty();
+}
+
+
+void
+SegmentBuffer::reserve(size_t n)
+{
+    x1_.reserve(n);
+    y1_.reserve(n);
+    x2_.reserve(n);
+    y2_.reserve(n);
+}
+
+
+void
+SegmentBuffer::clear()
+{
+    x1_.clear();
+    y1_.clear();
+    x2_.clear();
+    y2_.clear();
+}
+
+
+void
+SegmentBuffer::push_back(const Point2D& p1, const Point2D& p2)
+{
+    x1_.push_back(p1.x);
+    y1_.push_back(p1.y);
+    x2_.push_back(p2.x);
+    y2_.push_back(p2.y);
+}
+
+
+void
+SegmentBuffer::appendPolyline(const Point2D* points, size_t n, bool closed)
+{
+    if (n < 2)
+    {
+        return;
+    }
+
+    reserve(size() + n);
+    for (size_t k = 0; k + 1 != n; ++k)
+    {
+        push_back(points[k], points[k + 1]);
+    }
+    if (closed)
+    {
+        push_back(points[n - 1], points[0]);
+    }
+}
+
+
+Point2D
+SegmentBuffer::p1(size_t i) const
+{
+    return Point2D(x1_[i], y1_[i]);
+}
+
+
+Point2D
+SegmentBuffer::p2(size_t i) const
+{
+    return Point2D(x2_[i], y2_[i]);
+}
+
+
+size_t
+SegmentBuffer::intersect(
+    const SegmentBuffer& other, std::vector<SegmentHit>& hits) const
+{
+    Sink sink(*this, other, &hits);
+    intersectAll(*this, other, other.x1_.data(), other.y1_.data(),
+                 other.x2_.data(), other.y2_.data(), sink);
+    return sink.count;
+}
+
+
+size_t
+SegmentBuffer::countIntersections(const SegmentBuffer& other) const
+{
+    Sink sink(*this, other, 0);
+    intersectAll(*this, other, other.x1_.data(), other.y1_.data(),
+                 other.x2_.data(), other.y2_.data(), sink);
+    return sink.count;
+}
+
+
+} // namespace geom
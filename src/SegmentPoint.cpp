@@ -1,55 +1,58 @@
 #include "SegmentPoint.h"
-//#include <iostream>
 
 namespace geom
 {
 
 
-SegmentPoint::SegmentPoint(float x, float y, float t, const GenericShapeElement* parent)
-:   Point2D(x, y),
+template <typename T>
+BasicSegmentPoint<T>::BasicSegmentPoint(
+    T x, T y, T t, const Element* parent)
+:   p(x, y),
     t(t),
+    t2(0),
     parent(parent),
-    t2(0.f),
     parent2(0)
 {}
 
 
-SegmentPoint::SegmentPoint(const Point2D& p, float t, const GenericShapeElement* parent)
-:   Point2D(p),
+template <typename T>
+BasicSegmentPoint<T>::BasicSegmentPoint(
+    const Point& p, T t, const Element* parent)
+:   p(p),
     t(t),
+    t2(0),
     parent(parent),
-    t2(0.f),
     parent2(0)
 {}
 
 
-SegmentPoint::SegmentPoint(
-    const Point2D& p,
-    float t,
-    const GenericShapeElement* parent,
-    float t2,
-    const GenericShapeElement* parent2)
-:   Point2D(p),
+template <typename T>
+BasicSegmentPoint<T>::BasicSegmentPoint(
+    const Point& p,
+    T t,
+    const Element* parent,
+    T t2,
+    const Element* parent2)
+:   p(p),
     t(t),
-    parent(parent),
     t2(t2),
+    parent(parent),
     parent2(parent2)
 {}
 
 
-SegmentPoint::SegmentPoint(const SegmentPoint* other)
-:   Point2D(*other),
+template <typename T>
+BasicSegmentPoint<T>::BasicSegmentPoint(const BasicSegmentPoint* other)
+:   p(other->p),
     t(other->t),
-    parent(other->parent),
     t2(other->t2),
+    parent(other->parent),
     parent2(other->parent2)
 {}
 
 
-SegmentPoint::~SegmentPoint()
-{
-    //std::cout << *this << " Destructor" << std::endl;
-}
+template class BasicSegmentPoint<float>;
+template class BasicSegmentPoint<double>;
 
 
 } // namespace geom
@@ -1,97 +1,432 @@
 #include "SegmentPointVector.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 namespace geom
 {
 
 
-struct lessOp
+namespace
 {
-    bool operator()(const SegmentPoint* p1, const SegmentPoint* p2) const
+
+    // sort() orders the points by (parent id, t) with an LSD radix sort on
+    // both keys, one byte per pass: the bytes of t first, those of the id
+    // last. Passes in which all keys share the byte are skipped, which is
+    // most of the id passes. Short vectors are sorted in place by comparing
+    // the same keys, which is faster for them.
+
+    const size_t MinRadixSortSize = 512;
+
+
+    template <typename T>
+    inline unsigned
+    parentId(const BasicGenericShapeElement<T>* parent)
+    {
+        return parent ? parent->id() : 0u;
+    }
+
+
+    /// The bits of t as an unsigned integer ordered like t (negative values
+    /// have all bits flipped, others the sign bit)
+    template <typename T>
+    struct TBits
+    {
+        typedef typename std::conditional<sizeof(T) == 4, std::uint32_t,
+                                          std::uint64_t>::type Type;
+
+        static Type
+        of(T t)
+        {
+            Type bits;
+            std::memcpy(&bits, &t, sizeof(bits));
+            const Type sign = Type(1) << (8 * sizeof(Type) - 1);
+            return (bits & sign) ? ~bits : (bits | sign);
+        }
+    };
+
+
+    template <typename T>
+    struct SortRecord
+    {
+        typename TBits<T>::Type t;
+
+        std::uint32_t id;
+
+        std::uint32_t idx;
+
+        unsigned
+        byte(size_t i) const
+        {
+            return i < sizeof(t) ? unsigned(t >> (8 * i)) & 0xffu
+                                 : (id >> (8 * (i - sizeof(t)))) & 0xffu;
+        }
+
+    };
+
+
+    template <typename T>
+    struct keyLessOp
     {
-        if (p1->parent == p2->parent)
+        bool operator()(const BasicSegmentPoint<T>& p1,
+                        const BasicSegmentPoint<T>& p2) const
         {
-            return p1->t < p2->t;
+            unsigned id1 = parentId(p1.parent);
+            unsigned id2 = parentId(p2.parent);
+            if (id1 != id2)
+            {
+                return id1 < id2;
+            }
+            return TBits<T>::of(p1.t) < TBits<T>::of(p2.t);
+        }
+    };
+
+
+    /// Sorts the records by (id, t)
+    template <typename T>
+    void
+    radixSort(std::vector<SortRecord<T> >& records)
+    {
+        const size_t numBytes = sizeof(typename TBits<T>::Type) + 4;
+        const size_t n = records.size();
+
+        std::vector<size_t> counts(numBytes * 256, 0);
+        for (size_t i = 0; i != n; ++i)
+        {
+            for (size_t b = 0; b != numBytes; ++b)
+            {
+                ++counts[b * 256 + records[i].byte(b)];
+            }
+        }
+
+        std::vector<SortRecord<T> > buffer(n);
+        for (size_t b = 0; b != numBytes; ++b)
+        {
+            size_t* count = &counts[b * 256];
+            if (count[records[0].byte(b)] == n)
+            {
+                continue;
+            }
+
+            // Counts to start offsets
+            size_t offset = 0;
+            for (size_t d = 0; d != 256; ++d)
+            {
+                size_t c = count[d];
+                count[d] = offset;
+                offset += c;
+            }
+
+            for (size_t i = 0; i != n; ++i)
+            {
+                buffer[count[records[i].byte(b)]++] = records[i];
+            }
+            records.swap(buffer);
         }
-        else
+    }
+
+
+    /// Orders points before a parent, for searching a sorted vector
+    template <typename T>
+    struct parentLessOp
+    {
+        bool operator()(const BasicSegmentPoint<T>& p,
+                        const BasicGenericShapeElement<T>* parent) const
         {
-            return p1->parent < p2->parent;
+            return parentId(p.parent) < parentId(parent);
         }
+    };
+
+}
+
+
+template <typename T>
+const size_t BasicSegmentPointVector<T>::InlineCapacity;
+
+
+template <typename T>
+BasicSegmentPointVector<T>::BasicSegmentPointVector()
+:   arena_(0),
+    data_(reinterpret_cast<SegPoint*>(inline_)),
+    size_(0),
+    capacity_(InlineCapacity)
+{}
+
+
+template <typename T>
+BasicSegmentPointVector<T>::BasicSegmentPointVector(Arena* arena)
+:   arena_(arena),
+    data_(reinterpret_cast<SegPoint*>(inline_)),
+    size_(0),
+    capacity_(InlineCapacity)
+{}
+
+
+template <typename T>
+BasicSegmentPointVector<T>::BasicSegmentPointVector(
+    const BasicSegmentPointVector& other)
+:   arena_(other.arena_),
+    data_(reinterpret_cast<SegPoint*>(inline_)),
+    size_(0),
+    capacity_(InlineCapacity)
+{
+    insert(end(), other.begin(), other.end());
+}
+
+
+template <typename T>
+BasicSegmentPointVector<T>::BasicSegmentPointVector(
+    BasicSegmentPointVector&& other) noexcept
+:   arena_(other.arena_),
+    data_(reinterpret_cast<SegPoint*>(inline_)),
+    size_(0),
+    capacity_(InlineCapacity)
+{
+    moveFrom(other);
+}
+
+
+template <typename T>
+BasicSegmentPointVector<T>::~BasicSegmentPointVector()
+{
+    release();
+}
+
+
+template <typename T>
+BasicSegmentPointVector<T>&
+BasicSegmentPointVector<T>::operator=(const BasicSegmentPointVector& other)
+{
+    if (this != &other)
+    {
+        clear();
+        insert(end(), other.begin(), other.end());
     }
-};
+    return *this;
+}
+
 
+template <typename T>
+BasicSegmentPointVector<T>&
+BasicSegmentPointVector<T>::operator=(BasicSegmentPointVector&& other)
+    noexcept
+{
+    if (this != &other)
+    {
+        release();
+        moveFrom(other);
+    }
+    return *this;
+}
 
+
+template <typename T>
 void
-SegmentPointVector::sort()
+BasicSegmentPointVector<T>::reserve(size_t n)
 {
-    std::sort(begin(), end(), lessOp());
+    if (n > capacity_)
+    {
+        grow(n);
+    }
 }
 
 
-bool
-SegmentPointVector::hasPoint(const Point2D& p) const
+template <typename T>
+typename BasicSegmentPointVector<T>::iterator
+BasicSegmentPointVector<T>::insert(
+    iterator pos, const_iterator first, const_iterator last)
 {
-    for (const_iterator i = begin(); i != end(); ++i)
+    size_t idx = pos - data_;
+    size_t n = last - first;
+    if (size_ + n > capacity_)
     {
-        if (**i == p)
-        {
-            return true;
-        }
+        grow(std::max(size_ + n, 2 * capacity_));
     }
-    return false;
+
+    std::memmove(data_ + idx + n, data_ + idx,
+                 (size_ - idx) * sizeof(SegPoint));
+    std::memcpy(data_ + idx, first, n * sizeof(SegPoint));
+    size_ += n;
+    return data_ + idx;
+}
+
+
+template <typename T>
+typename BasicSegmentPointVector<T>::iterator
+BasicSegmentPointVector<T>::erase(iterator first, iterator last)
+{
+    std::memmove(first, last, (end() - last) * sizeof(SegPoint));
+    size_ -= last - first;
+    return first;
+}
+
+
+template <typename T>
+typename BasicSegmentPointVector<T>::iterator
+BasicSegmentPointVector<T>::erase(iterator pos)
+{
+    return erase(pos, pos + 1);
 }
 
 
+template <typename T>
 void
-SegmentPointVector::deleteReferencedObjectsAndClear()
+BasicSegmentPointVector<T>::swap(BasicSegmentPointVector& other)
 {
-    for (const_iterator i = begin(); i != end(); ++i)
+    BasicSegmentPointVector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+}
+
+
+template <typename T>
+void
+BasicSegmentPointVector<T>::grow(size_t n)
+{
+    size_t bytes = n * sizeof(SegPoint);
+    SegPoint* data = static_cast<SegPoint*>(
+        arena_ ? arena_->allocate(bytes, alignof(SegPoint))
+               : ::operator new(bytes));
+    std::memcpy(data, data_, size_ * sizeof(SegPoint));
+    release();
+    data_ = data;
+    capacity_ = n;
+}
+
+
+template <typename T>
+void
+BasicSegmentPointVector<T>::pushBackGrow(const SegPoint& p)
+{
+    // p may be in the buffer about to be freed
+    SegPoint copy(p);
+    grow(2 * capacity_);
+    new (data_ + size_) SegPoint(copy);
+    ++size_;
+}
+
+
+template <typename T>
+void
+BasicSegmentPointVector<T>::moveFrom(BasicSegmentPointVector& other)
+{
+    if (other.isInline())
+    {
+        data_ = reinterpret_cast<SegPoint*>(inline_);
+        capacity_ = InlineCapacity;
+        std::memcpy(data_, other.data_, other.size_ * sizeof(SegPoint));
+    }
+    else
     {
-        delete *i;
+        // The buffer comes with the arena it is from
+        arena_ = other.arena_;
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+        other.data_ = reinterpret_cast<SegPoint*>(other.inline_);
+        other.capacity_ = InlineCapacity;
     }
-    clear();
+    size_ = other.size_;
+    other.size_ = 0;
 }
 
 
-SegmentPointVector::RangeIterator::RangeIterator(
-    const SegmentPointVector& v, const GenericShapeElement* commonParent)
-:   v_(v),
-    commonParent_(commonParent),
-    idx_(0)
+template <typename T>
+void
+BasicSegmentPointVector<T>::release()
 {
-    // TODO brute force! -> search for first element in a more efficient way
-    for (unsigned int i = 0; i != v_.size(); ++i)
+    // Arena buffers are released with the arena
+    if (!isInline() && !arena_)
+    {
+        ::operator delete(data_);
+    }
+}
+
+
+template <typename T>
+void
+BasicSegmentPointVector<T>::sort()
+{
+    if (size_ < MinRadixSortSize)
+    {
+        std::sort(data_, data_ + size_, keyLessOp<T>());
+        return;
+    }
+
+    std::vector<SortRecord<T> > records(size_);
+    for (size_t i = 0; i != size_; ++i)
+    {
+        records[i].t = TBits<T>::of(data_[i].t);
+        records[i].id = parentId(data_[i].parent);
+        records[i].idx = (std::uint32_t)i;
+    }
+
+    radixSort(records);
+
+    std::vector<SegPoint> sorted;
+    sorted.reserve(size_);
+    for (size_t i = 0; i != size_; ++i)
     {
-        if (v_[i]->parent == commonParent_)
+        sorted.push_back(data_[records[i].idx]);
+    }
+    std::memcpy(data_, &sorted[0], size_ * sizeof(SegPoint));
+}
+
+
+template <typename T>
+bool
+BasicSegmentPointVector<T>::hasPoint(const BasicPoint2D<T>& p) const
+{
+    for (size_t i = 0; i != this->size(); ++i)
+    {
+        if ((*this)[i].p == p)
         {
-            idx_ = i;
-            break;
+            return true;
         }
     }
+    return false;
 }
 
 
+template <typename T>
+BasicSegmentPointVector<T>::RangeIterator::RangeIterator(
+    const BasicSegmentPointVector& v, const Element* commonParent)
+:   v_(v),
+    commonParent_(commonParent),
+    // The points of a parent are consecutive in the sorted vector
+    idx_(std::lower_bound(v.begin(), v.end(), commonParent,
+                          parentLessOp<T>()) - v.begin())
+{}
+
+
+template <typename T>
 bool
-SegmentPointVector::RangeIterator::endReached() const
+BasicSegmentPointVector<T>::RangeIterator::endReached() const
 {
-    return (idx_ >= v_.size()) || (v_[idx_]->parent != commonParent_);
+    return (idx_ >= v_.size()) || (v_[idx_].parent != commonParent_);
 }
 
 
+template <typename T>
 void
-SegmentPointVector::RangeIterator::operator++()
+BasicSegmentPointVector<T>::RangeIterator::operator++()
 {
     ++idx_;
 }
 
 
-SegmentPoint*
-SegmentPointVector::RangeIterator::operator*() const
+template <typename T>
+const BasicSegmentPoint<T>&
+BasicSegmentPointVector<T>::RangeIterator::operator*() const
 {
     return v_[idx_];
 }
 
 
-} // namespace geom
+template class BasicSegmentPointVector<float>;
+template class BasicSegmentPointVector<double>;
 
+
+} // namespace geom
@@ -0,0 +1,667 @@
+#include "SegmentSweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+#include "Limits.h"
+#include "Predicates.h"
+
+namespace geom
+{
+
+
+namespace
+{
+
+    typedef unsigned long long PairKey;
+
+    enum EventKind { InsertEvent, CrossEvent, RemoveEvent };
+
+
+    /// A line oriented from its lexicographically smaller end point (lo) to
+    /// the larger one (hi), i.e., left to right and bottom to top if vertical
+    struct Segment
+    {
+        const GenericLine* line;
+
+        // Of the second array, if there are two
+        bool other;
+
+        double loX, loY;
+
+        double hiX, hiY;
+    };
+
+
+    struct Event
+    {
+        double x, y;
+
+        EventKind kind;
+
+        int a;
+
+        // Second segment of a CrossEvent
+        int b;
+    };
+
+
+    /// For the priority queue, which pops its largest element first
+    struct EventLater
+    {
+        bool operator()(const Event& e1, const Event& e2) const
+        {
+            if (e1.x != e2.x)
+            {
+                return e1.x > e2.x;
+            }
+            if (e1.y != e2.y)
+            {
+                return e1.y > e2.y;
+            }
+            return e1.kind > e2.kind;
+        }
+    };
+
+
+    /// Points closer than this to the sweep position are taken to be on it,
+    /// for segments with coordinates up to scale: the crossings are rounded
+    /// to float, so they are off by some units in the last place of the
+    /// largest coordinate. A fixed limit such as Tolerance<float>::absolute()
+    /// would merge distinct crossings of small segments, which breaks the
+    /// order of the segments through them.
+    inline double
+    tolerance(double scale)
+    {
+        return 16. * Tolerance<float>::relative() * scale
+            + std::numeric_limits<float>::min();
+    }
+
+
+    /// Lexicographic order of points, the order of the events
+    inline bool
+    before(double x1, double y1, double x2, double y2)
+    {
+        return x1 < x2 || (x1 == x2 && y1 < y2);
+    }
+
+
+    /// Moves e onto an end point of seg if it is within the tolerance of
+    /// it; returns whether it did
+    inline bool
+    snapToEnd(const Segment& seg, double tol, Event& e)
+    {
+        double ends[2][2] = { { seg.loX, seg.loY }, { seg.hiX, seg.hiY } };
+        for (int i = 0; i != 2; ++i)
+        {
+            double dx = e.x - ends[i][0];
+            double dy = e.y - ends[i][1];
+            if (dx * dx + dy * dy <= tol * tol)
+            {
+                e.x = ends[i][0];
+                e.y = ends[i][1];
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    class Sweep;
+
+
+    /// Orders the status by y at the sweep position
+    struct StatusLess
+    {
+        const Sweep* sweep;
+
+        bool operator()(int s1, int s2) const;
+    };
+
+
+    class Sweep
+    {
+
+    public:
+
+        typedef std::set<int, StatusLess> Status;
+
+        Sweep(bool twoSets, SegmentPointVector& isecPoints);
+
+        void add(const GenericLine lines[], int numLines, bool other);
+
+        int run();
+
+        bool less(int s1, int s2) const;
+
+    private:
+
+        /// y of segment s at the sweep position
+        double yAt(int s) const;
+
+        /// Whether the sweep position is above segment s (1), below it (-1)
+        /// or neither (0), decided exactly
+        int sideOfSweep(int s) const;
+
+        /// Whether segment s was removed at an earlier point
+        bool hasEnded(int s) const;
+
+        /// Whether segment s passes through the sweep position, i.e., is
+        /// within the tolerance of it (measured normal to the segment, so
+        /// that steep segments are not at a disadvantage); always true for
+        /// the probe (-1) and the segments of the current point, even if
+        /// their crossing was moved there
+        bool passesSweep(int s) const;
+
+        void insert(int s);
+
+        void erase(int s);
+
+        /// Tests s1 and s2 unless done before, reports their intersections
+        /// and schedules their crossing
+        void test(int s1, int s2);
+
+        void testNeighbours(int s);
+
+        /// Processes all events at the front of the queue that share its
+        /// position
+        void processPoint();
+
+        void addToBundle(int s);
+
+    private:
+
+        Sweep(const Sweep&);
+
+        Sweep& operator=(const Sweep&);
+
+    private:
+
+        const bool twoSets_;
+
+        SegmentPointVector& isecPoints_;
+
+        int isecCount_;
+
+        std::vector<Segment> segments_;
+
+        std::priority_queue<Event, std::vector<Event>, EventLater> events_;
+
+        Status status_;
+
+        std::vector<Status::iterator> handles_;
+
+        std::vector<char> inStatus_;
+
+        std::unordered_set<PairKey> tested_;
+
+        double sweepX_, sweepY_;
+
+        // Largest magnitude of a coordinate
+        double scale_;
+
+        // tolerance() for it, and its square
+        double tol_, tol2_;
+
+        // Number of the event point being processed
+        int point_;
+
+        // Segments through the current point
+        std::vector<int> bundle_;
+
+        // Point numbers: if equal to point_, the segment is in bundle_ or
+        // ends at the current point, respectively
+        std::vector<int> inBundle_;
+
+        std::vector<int> ending_;
+
+        SegmentPointVector points_;
+
+    };
+
+
+    bool
+    StatusLess::operator()(int s1, int s2) const
+    {
+        return sweep->less(s1, s2);
+    }
+
+
+    Sweep::Sweep(bool twoSets, SegmentPointVector& isecPoints)
+    :   twoSets_(twoSets),
+        isecPoints_(isecPoints),
+        isecCount_(0),
+        status_(StatusLess{ this }),
+        sweepX_(0.),
+        sweepY_(0.),
+        scale_(0.),
+        tol_(0.),
+        tol2_(0.),
+        point_(0)
+    {}
+
+
+    void
+    Sweep::add(const GenericLine lines[], int numLines, bool other)
+    {
+        for (int i = 0; i != numLines; ++i)
+        {
+            Point2D lo = lines[i].p1();
+            Point2D hi = lines[i].p2();
+            if (before(hi.x, hi.y, lo.x, lo.y))
+            {
+                std::swap(lo, hi);
+            }
+
+            int s = (int)segments_.size();
+            Segment seg = { &lines[i], other, lo.x, lo.y, hi.x, hi.y };
+            segments_.push_back(seg);
+            scale_ = std::max(scale_, std::max(std::abs(seg.loX),
+                                               std::abs(seg.loY)));
+            scale_ = std::max(scale_, std::max(std::abs(seg.hiX),
+                                               std::abs(seg.hiY)));
+
+            Event insert = { lo.x, lo.y, InsertEvent, s, -1 };
+            Event remove = { hi.x, hi.y, RemoveEvent, s, -1 };
+            events_.push(insert);
+            events_.push(remove);
+        }
+    }
+
+
+    double
+    Sweep::yAt(int s) const
+    {
+        const Segment& seg = segments_[s];
+        if (seg.loX == seg.hiX)
+        {
+            // Vertical: cut at the sweep position
+            return std::min(std::max(sweepY_, seg.loY), seg.hiY);
+        }
+        if (sweepX_ <= seg.loX)
+        {
+            return seg.loY;
+        }
+        if (sweepX_ >= seg.hiX)
+        {
+            return seg.hiY;
+        }
+        return seg.loY
+            + (sweepX_ - seg.loX) * (seg.hiY - seg.loY) / (seg.hiX - seg.loX);
+    }
+
+
+    int
+    Sweep::sideOfSweep(int s) const
+    {
+        const Segment& seg = segments_[s];
+        if (seg.loX == seg.hiX)
+        {
+            // Vertical, through the sweep x or it would not be in the status
+            return seg.hiY < sweepY_ ? 1 : (seg.loY > sweepY_ ? -1 : 0);
+        }
+
+        // lo -> hi goes to the right, so left of it is above
+        double o = orient2d(seg.loX, seg.loY, seg.hiX, seg.hiY,
+                            sweepX_, sweepY_);
+        return o > 0. ? 1 : (o < 0. ? -1 : 0);
+    }
+
+
+    bool
+    Sweep::hasEnded(int s) const
+    {
+        return ending_[s] != 0 && ending_[s] != point_;
+    }
+
+
+    bool
+    Sweep::passesSweep(int s) const
+    {
+        if (s < 0 || inBundle_[s] == point_)
+        {
+            return true;
+        }
+
+        // Distance of the sweep position to the closest point of s
+        const Segment& seg = segments_[s];
+        double dx = seg.hiX - seg.loX;
+        double dy = seg.hiY - seg.loY;
+        double wx = sweepX_ - seg.loX;
+        double wy = sweepY_ - seg.loY;
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0. ? (wx * dx + wy * dy) / len2 : 0.;
+        t = std::min(std::max(t, 0.), 1.);
+        wx -= t * dx;
+        wy -= t * dy;
+        return wx * wx + wy * wy <= tol2_;
+    }
+
+
+    bool
+    Sweep::less(int s1, int s2) const
+    {
+        if (s1 == s2)
+        {
+            return false;
+        }
+
+        // Segments through the sweep position are cut right there. The set
+        // only ever compares the probe or a segment of the current point with
+        // another one, so the order of one segment off the sweep position
+        // against such a one is that of the sweep position against it,
+        // which is exact.
+        bool on1 = passesSweep(s1);
+        bool on2 = passesSweep(s2);
+        if (on1 != on2)
+        {
+            int side = on1 ? -sideOfSweep(s2) : sideOfSweep(s1);
+            if (side != 0)
+            {
+                return side > 0;
+            }
+        }
+        if (!on1 || !on2)
+        {
+            // Not through the sweep position either way; only by the y of
+            // each there
+            double y1 = on1 ? sweepY_ : yAt(s1);
+            double y2 = on2 ? sweepY_ : yAt(s2);
+            if (y1 != y2)
+            {
+                return y1 < y2;
+            }
+        }
+
+        // Both pass the sweep position: the probe goes first, then the order
+        // just right of it, i.e., by slope (vertical ones last)
+        if (s1 < 0 || s2 < 0)
+        {
+            return s1 < 0;
+        }
+
+        const Segment& g1 = segments_[s1];
+        const Segment& g2 = segments_[s2];
+        double c = orient2d(g1.hiX - g1.loX, g1.hiY - g1.loY,
+                            g2.hiX - g2.loX, g2.hiY - g2.loY, 0., 0.);
+        if (c != 0.)
+        {
+            return c > 0.;
+        }
+
+        // Collinear
+        return s1 < s2;
+    }
+
+
+    void
+    Sweep::insert(int s)
+    {
+        handles_[s] = status_.insert(s).first;
+        inStatus_[s] = true;
+    }
+
+
+    void
+    Sweep::erase(int s)
+    {
+        Status::iterator next = status_.erase(handles_[s]);
+        inStatus_[s] = false;
+
+        // The segments on both sides become neighbours
+        if (next != status_.begin() && next != status_.end())
+        {
+            Status::iterator prev = next;
+            --prev;
+            test(*prev, *next);
+        }
+    }
+
+
+    void
+    Sweep::test(int s1, int s2)
+    {
+        if (s2 < s1)
+        {
+            std::swap(s1, s2);
+        }
+        if (!tested_.insert(((PairKey)s1 << 32) | (PairKey)s2).second)
+        {
+            return;
+        }
+
+        const Segment& g1 = segments_[s1];
+        const Segment& g2 = segments_[s2];
+
+        // Lines of the first array are queried against the second, as by
+        // GenericLine::areIntersectedBy(); both arrays come in order, so the
+        // lower index is of the first one
+        int n = 0;
+        points_.clear();
+        g1.line->isIntersectedBy(*g2.line, points_, n);
+        if (!n)
+        {
+            return;
+        }
+
+        if (!twoSets_ || g1.other != g2.other)
+        {
+            isecPoints_.insert(isecPoints_.end(), points_.begin(),
+                               points_.end());
+            isecCount_ += n;
+        }
+
+        // A crossing inside both segments swaps their order; touching end
+        // points and overlaps are handled at the end point events
+        const SegmentPoint& sp = points_[0];
+        if (n == 1 && sp.t > 0.f && sp.t < 1.f && sp.t2 > 0.f && sp.t2 < 1.f)
+        {
+            Event e = { sp.p.x, sp.p.y, CrossEvent, s1, s2 };
+
+            // A crossing through an end point, moved off it by rounding, is
+            // one at the end point, processed together with its event. If
+            // that is the current point and both segments pass it, they are
+            // in order already.
+            if ((snapToEnd(g1, tol_, e) || snapToEnd(g2, tol_, e))
+                && e.x == sweepX_ && e.y == sweepY_
+                && inBundle_[s1] == point_ && inBundle_[s2] == point_)
+            {
+                return;
+            }
+
+            // Rounding may move the point off a vertical segment, beyond the
+            // end of either one or behind the sweep line; the events of both
+            // segments have to stay in order
+            if (g1.loX == g1.hiX)
+            {
+                e.x = g1.loX;
+            }
+            else if (g2.loX == g2.hiX)
+            {
+                e.x = g2.loX;
+            }
+            if (before(g1.hiX, g1.hiY, e.x, e.y))
+            {
+                e.x = g1.hiX;
+                e.y = g1.hiY;
+            }
+            if (before(g2.hiX, g2.hiY, e.x, e.y))
+            {
+                e.x = g2.hiX;
+                e.y = g2.hiY;
+            }
+            if (before(e.x, e.y, sweepX_, sweepY_))
+            {
+                e.x = sweepX_;
+                e.y = sweepY_;
+            }
+            events_.push(e);
+        }
+    }
+
+
+    void
+    Sweep::testNeighbours(int s)
+    {
+        Status::iterator it = handles_[s];
+        if (it != status_.begin())
+        {
+            Status::iterator prev = it;
+            --prev;
+            test(*prev, s);
+        }
+        if (++it != status_.end())
+        {
+            test(s, *it);
+        }
+    }
+
+
+    void
+    Sweep::processPoint()
+    {
+        sweepX_ = events_.top().x;
+        sweepY_ = events_.top().y;
+        ++point_;
+
+        // As in the textbook version, all segments through this point are
+        // taken out and the ones that go on are put back in the order right
+        // of it; this sorts out crossings, including those of more than two
+        // segments and those not found as crossings due to rounding.
+        // Starting segments are added to them, ending ones are not put back.
+        bundle_.clear();
+        for (Status::iterator it = status_.lower_bound(-1);
+             it != status_.end() && passesSweep(*it); ++it)
+        {
+            addToBundle(*it);
+        }
+
+        while (!events_.empty()
+               && events_.top().x == sweepX_ && events_.top().y == sweepY_)
+        {
+            const Event e = events_.top();
+            events_.pop();
+
+            switch (e.kind)
+            {
+            case InsertEvent:
+                addToBundle(e.a);
+                break;
+            case CrossEvent:
+                // Not necessarily through this point if it was moved; a
+                // segment that has ended meanwhile must not come back
+                if (!hasEnded(e.a) && !hasEnded(e.b))
+                {
+                    addToBundle(e.a);
+                    addToBundle(e.b);
+                }
+                break;
+            case RemoveEvent:
+                addToBundle(e.a);
+                ending_[e.a] = point_;
+                break;
+            }
+        }
+
+        // The segments through this point need not be neighbours, neither
+        // before nor after it, so test them all against each other
+        for (size_t i = 0; i != bundle_.size(); ++i)
+        {
+            for (size_t j = i + 1; j != bundle_.size(); ++j)
+            {
+                test(bundle_[i], bundle_[j]);
+            }
+        }
+
+        for (size_t i = 0; i != bundle_.size(); ++i)
+        {
+            if (inStatus_[bundle_[i]])
+            {
+                erase(bundle_[i]);
+            }
+        }
+
+        for (size_t i = 0; i != bundle_.size(); ++i)
+        {
+            if (ending_[bundle_[i]] != point_)
+            {
+                insert(bundle_[i]);
+            }
+        }
+
+        for (size_t i = 0; i != bundle_.size(); ++i)
+        {
+            if (ending_[bundle_[i]] != point_)
+            {
+                testNeighbours(bundle_[i]);
+            }
+        }
+    }
+
+
+    void
+    Sweep::addToBundle(int s)
+    {
+        if (inBundle_[s] != point_)
+        {
+            inBundle_[s] = point_;
+            bundle_.push_back(s);
+        }
+    }
+
+
+    int
+    Sweep::run()
+    {
+        handles_.resize(segments_.size());
+        inStatus_.assign(segments_.size(), false);
+        inBundle_.assign(segments_.size(), 0);
+        ending_.assign(segments_.size(), 0);
+        tested_.reserve(4 * segments_.size());
+        tol_ = tolerance(scale_);
+        tol2_ = tol_ * tol_;
+
+        while (!events_.empty())
+        {
+            processPoint();
+        }
+
+        return isecCount_;
+    }
+
+}
+
+
+int
+SegmentSweep::findIntersections(
+    const GenericLine lines[],
+    int numLines,
+    SegmentPointVector& isecPoints)
+{
+    Sweep sweep(false, isecPoints);
+    sweep.add(lines, numLines, false);
+    return sweep.run();
+}
+
+
+int
+SegmentSweep::findIntersections(
+    const GenericLine lines[],
+    int numLines,
+    const GenericLine otherLines[],
+    int numOtherLines,
+    SegmentPointVector& isecPoints)
+{
+    Sweep sweep(true, isecPoints);
+    sweep.add(lines, numLines, false);
+    sweep.add(otherLines, numOtherLines, true);
+    return sweep.run();
+}
+
+
+} // namespace geom
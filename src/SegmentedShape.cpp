@@ -1,83 +1,253 @@
 #include "SegmentedShape.h"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+
 
 namespace geom
 {
 
 
-SegmentedShape::SegmentedShape(const Shape* shape, Segment* start)
+namespace
+{
+
+    template <typename T>
+    inline unsigned
+    parentId(const BasicGenericShapeElement<T>* parent)
+    {
+        return parent ? parent->id() : 0u;
+    }
+
+
+    /// Orders points before a parent id, as SegmentPointVector::sort() does
+    template <typename T>
+    struct IdLess
+    {
+        bool operator()(const BasicSegmentPoint<T>& p, unsigned id) const
+        {
+            return parentId(p.parent) < id;
+        }
+    };
+
+}
+
+
+template <typename T>
+BasicSegmentedShape<T>::BasicSegmentedShape(const BasicShape<T>* shape,
+                                            Arena* arena)
 :   shape_(shape),
-    start_(start)
+    ownArena_(1024),
+    arena_(arena ? *arena : ownArena_),
+    segments_(0),
+    numSegments_(0),
+    capacity_(0)
 {}
 
 
-SegmentedShape::~SegmentedShape()
+template <typename T>
+BasicSegmentedShape<T>::~BasicSegmentedShape()
+{
+    // The segments need no destruction and are released with the arena
+}
+
+
+template <typename T>
+void
+BasicSegmentedShape<T>::addSegment(const SegmentPoint& start,
+                                   typename Segment::ElementKind kind)
 {
-    for (Segment::Iterator segmIt(start_); !segmIt.endReached(); ++segmIt)
+    if (numSegments_ == capacity_)
     {
-        delete *segmIt;
+        reserve(capacity_ ? 2 * capacity_ : 8);
     }
+
+    int s = (int)numSegments_++;
+    Segment segm = { start, 0, Segment::Positive, kind };
+    new (segments_ + s) Segment(segm);
+    if (s > 0)
+    {
+        segments_[s - 1].next = s;
+    }
+}
+
+
+template <typename T>
+size_t
+BasicSegmentedShape<T>::numSegments() const
+{
+    return numSegments_;
+}
+
+
+template <typename T>
+const BasicSegment<T>&
+BasicSegmentedShape<T>::segment(size_t i) const
+{
+    return segments_[i];
 }
 
 
+template <typename T>
 void
-SegmentedShape::addIntersections(SegmentPointVector& pv)
+BasicSegmentedShape<T>::reserve(size_t n)
 {
-    if (start_ == 0)
+    if (n <= capacity_)
     {
         return;
     }
 
-    // RangeIterator requires sorted vector!
-    pv.sort();
+    // The old array stays in the arena until it is reset
+    Segment* segments = static_cast<Segment*>(
+        arena_.allocate(n * sizeof(Segment), alignof(Segment)));
+    if (numSegments_)
+    {
+        std::memcpy(segments, segments_, numSegments_ * sizeof(Segment));
+    }
+    segments_ = segments;
+    capacity_ = n;
+}
 
-    for (Segment::Iterator segmIt(start_); !segmIt.endReached(); ++segmIt)
+
+template <typename T>
+void
+BasicSegmentedShape<T>::addIntersections(SegmentPointVector& pv)
+{
+    if (numSegments_ == 0 || pv.empty())
     {
-        SegmentPointVector::RangeIterator pointIt(pv, (*segmIt)->parent());
+        return;
+    }
+
+    // The merge needs the points of each parent together, ordered by t
+    pv.sort();
+    const SegmentPoint* points = pv.data();
+    const size_t numPoints = pv.size();
 
-        while (!pointIt.endReached())
+    // The split ring is written to a new array in ring order, so that it is
+    // walked sequentially from then on; the old one stays in the arena
+    size_t capacity = numSegments_ + numPoints;
+    Segment* out = static_cast<Segment*>(
+        arena_.allocate(capacity * sizeof(Segment), alignof(Segment)));
+    size_t numOut = 0;
+
+    // The points of the current parent not placed yet, and where to look for
+    // those of the next parent first
+    const BasicGenericShapeElement<T>* parent = 0;
+    size_t pointIdx = 0;
+    size_t pointEnd = 0;
+    size_t cursor = 0;
+
+    int s = 0;
+    do
+    {
+        const Segment& segm = segments_[s];
+        if (segm.start.parent != parent)
         {
-            // Make sure we're not on the last segment of the current Line or Arc
-            if ((*pointIt)->parent == (*segmIt)->next()->parent())
+            // Parents mostly follow each other along the ring in the order of
+            // their ids, so their points start where the last ones ended
+            parent = segm.start.parent;
+            pointIdx = cursor;
+            if (pointIdx == numPoints || points[pointIdx].parent != parent)
             {
-                // Check if current point-to-insert lies within current segment
-                if ((*pointIt)->t < (*segmIt)->end().t)
-                {
-                    (*segmIt)->insertNewSegment(**pointIt, Segment::Negative);
-                    ++pointIt;
-                }
-                else
-                {
-                    // Skip to next segment (which has the same parent)
-                    ++segmIt;
-                }
+                pointIdx = std::lower_bound(points, points + numPoints,
+                                            parentId(parent), IdLess<T>())
+                    - points;
             }
-            else
+            pointEnd = pointIdx;
+            while (pointEnd != numPoints && points[pointEnd].parent == parent)
             {
-                // Next segment has different parent, insert remaining points
-                while (!pointIt.endReached())
-                {
-                    (*segmIt)->insertNewSegment(**pointIt, Segment::Negative);
-                    ++pointIt;
-                    ++segmIt;
-                }
+                ++pointEnd;
             }
+            cursor = pointEnd;
+        }
 
+        new (out + numOut++) Segment(segm);
+
+        // The points before the next segment of the same parent, or all
+        // remaining ones if this is its last segment
+        int next = segm.next;
+        bool lastOfParent = next == 0 || segments_[next].start.parent != parent;
+        while (pointIdx != pointEnd
+               && (lastOfParent
+                   || points[pointIdx].t < segments_[next].start.t))
+        {
+            Segment split =
+                { points[pointIdx], 0, Segment::Negative, segm.kind };
+            new (out + numOut++) Segment(split);
+            ++pointIdx;
         }
+
+        s = next;
     }
+    while (s != 0);
+
+    for (size_t i = 0; i != numOut; ++i)
+    {
+        out[i].next = i + 1 != numOut ? (int)i + 1 : 0;
+    }
+
+    segments_ = out;
+    numSegments_ = numOut;
+    capacity_ = capacity;
+}
+
+
+template <typename T>
+BasicSegmentedShape<T>::Iterator::Iterator(const BasicSegmentedShape& shape)
+:   shape_(shape),
+    current_(0),
+    startPassed_(false)
+{}
+
+
+template <typename T>
+bool
+BasicSegmentedShape<T>::Iterator::endReached() const
+{
+    return startPassed_ && current_ == 0;
+}
+
+
+template <typename T>
+void
+BasicSegmentedShape<T>::Iterator::operator++()
+{
+    current_ = shape_.segments_[current_].next;
+    startPassed_ = true;
 }
 
+
+template <typename T>
+int
+BasicSegmentedShape<T>::Iterator::operator*() const
+{
+    return current_;
+}
+
+template <typename T>
 std::ostream&
-operator<<(std::ostream& out, const SegmentedShape& s)
+operator<<(std::ostream& out, const BasicSegmentedShape<T>& s)
 {
-    for (Segment::Iterator segmIt(s.start_); !segmIt.endReached(); ++segmIt)
+    typedef BasicSegment<T> Segment;
+    for (typename BasicSegmentedShape<T>::Iterator segmIt(s);
+         !segmIt.endReached(); ++segmIt)
     {
-        const SegmentPoint& p = (*segmIt)->start();
+        const Segment& segm = s.segments_[*segmIt];
+        const BasicPoint2D<T>& p = segm.start.p;
         out << "[(" << p.x << ", " << p.y << ") "
-            << ((*segmIt)->type == Segment::Positive ? "Pos" : "Neg" ) << "] ";
+            << (segm.type == Segment::Positive ? "Pos" : "Neg" ) << "] ";
     }
     return out;
 }
 
 
+template class BasicSegmentedShape<float>;
+template class BasicSegmentedShape<double>;
+
+template std::ostream& operator<<(std::ostream&,
+                                  const BasicSegmentedShape<float>&);
+template std::ostream& operator<<(std::ostream&,
+                                  const BasicSegmentedShape<double>&);
+
+
 } // namespace geom
@@ -1,65 +1,101 @@
 #include "Shape.h"
 
-#include "GeometryExceptions.h"
+#include "ShapeDispatch.h"
 
 namespace geom
 {
 
-Shape::Shape(ShapeType type)
+template <typename T>
+BasicShape<T>::BasicShape(ShapeType type)
 :   Dirtable(true),
     type_(type)
 {}
 
 
-Shape::~Shape()
+template <typename T>
+BasicShape<T>::~BasicShape()
 {}
 
 
+template <typename T>
 void
-Shape::makeClean() const
+BasicShape<T>::performCleaning() const
 {
-    if (dirty_)
-    {
-        Dirtable::makeClean();
-        calculateBoundingBox(bb_);
-    }
+    // Both happen under the same cleaning, so concurrent readers never see
+    // an updated shape with an outdated bounding box
+    performShapeCleaning();
+    calculateBoundingBox(bb_);
 }
 
 
-const GenericRect&
-Shape::bb() const
+template <typename T>
+void
+BasicShape<T>::performShapeCleaning() const
+{}
+
+
+template <typename T>
+void
+BasicShape<T>::makeAllClean() const
+{
+    makeElementsClean();
+    makeClean();
+}
+
+
+template <typename T>
+void
+BasicShape<T>::makeElementsClean() const
+{}
+
+
+template <typename T>
+const BasicAABox<T>&
+BasicShape<T>::bb() const
 {
     CLEAN_IF_DIRTY(this);
     return bb_;
 }
 
 
+template <typename T>
+ShapeTypes::ShapeType
+BasicShape<T>::type() const
+{
+    return type_;
+}
+
+
+template <typename T>
 bool
-Shape::isIntersectedBy(
-    const Shape* s,
-    SegmentPointVector& isecPoints,
+BasicShape<T>::isIntersectedBy(
+    const BasicShape* s,
+    PointVector& isecPoints,
     int& isecCount) const
 {
-    switch (s->type_)
-    {
-    case TRectangle:
-        return isIntersectedByRectangle(
-            reinterpret_cast<const Rectangle*>(s), isecPoints, isecCount);
-
-    case TTriangle:
-        return isIntersectedByTriangle(
-            reinterpret_cast<const Triangle*>(s), isecPoints, isecCount);
-
-    case TEllipse:
-        return isIntersectedByEllipse(
-            reinterpret_cast<const Ellipse*>(s), isecPoints, isecCount);
-
-    default:
-        // Shouldn't happen
-        throw error::GeometryError(
-            "Shape must be one of TRectangle, TTriangle, TEllipse");
-    }
+    return BasicShapeDispatch<T>::intersectFunc(type_, s->type_)(
+        this, s, isecPoints, isecCount);
+}
+
+
+template <typename T>
+bool
+BasicShape<T>::intersects(const BasicShape* s) const
+{
+    return BasicShapeDispatch<T>::countFunc(type_, s->type_)(this, s, true);
 }
 
 
+template <typename T>
+int
+BasicShape<T>::countIntersections(const BasicShape* s) const
+{
+    return BasicShapeDispatch<T>::countFunc(type_, s->type_)(this, s, false);
+}
+
+
+template class BasicShape<float>;
+template class BasicShape<double>;
+
+
 } // namespace geom
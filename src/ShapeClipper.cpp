@@ -0,0 +1,462 @@
+#include "ShapeClipper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "Ellipse.h"
+#include "GenericArc.h"
+#include "Helpers.h"
+#include "LineBasedShape.h"
+#include "Predicates.h"
+
+
+namespace geom
+{
+
+
+namespace
+{
+
+    /// Orders points by x, then y, exactly; unlike Point2D::operator<, this
+    /// is a strict weak ordering
+    template <typename T>
+    inline bool
+    pointLess(const BasicPoint2D<T>& p1, const BasicPoint2D<T>& p2)
+    {
+        return p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y);
+    }
+
+
+    template <typename T>
+    inline bool
+    samePoint(const BasicPoint2D<T>& p1, const BasicPoint2D<T>& p2)
+    {
+        return p1.x == p2.x && p1.y == p2.y;
+    }
+
+
+    /// 1 if the outline runs counterclockwise, -1 if clockwise; arcs count as
+    /// their chords, which keeps the sign
+    template <typename T>
+    double
+    senseOf(const BasicSegmentedShape<T>& outline)
+    {
+        const BasicPoint2D<T>& origin = outline.segment(0).start.p;
+        double area = 0.;
+        for (size_t i = 0; i != outline.numSegments(); ++i)
+        {
+            const BasicSegment<T>& segm = outline.segment(i);
+            BasicPoint2D<T> p = segm.start.p - origin;
+            BasicPoint2D<T> q = outline.segment(segm.next).start.p - origin;
+            area += (double)p.x * q.y - (double)p.y * q.x;
+        }
+        return area < 0. ? -1. : 1.;
+    }
+
+
+    /// Moves the points that are within the tolerance of a vertex of either
+    /// outline (see Point2D::isNear()) onto it. Intersections with arcs are
+    /// computed rather than decided exactly, so one at a vertex, e.g. where a
+    /// corner touches an ellipse, comes out a little off it and would leave a
+    /// sliver between the outlines. The outlines of the library have 4
+    /// vertices at most.
+    template <typename T>
+    void
+    snapToVertices(BasicSegmentPointVector<T>& points,
+                   const BasicSegmentedShape<T>& outline,
+                   const BasicSegmentedShape<T>& other)
+    {
+        for (size_t i = 0; i != points.size(); ++i)
+        {
+            BasicPoint2D<T>& p = points[i].p;
+            for (size_t s = 0; s != outline.numSegments(); ++s)
+            {
+                if (p.isNear(outline.segment(s).start.p))
+                {
+                    p = outline.segment(s).start.p;
+                }
+            }
+            for (size_t s = 0; s != other.numSegments(); ++s)
+            {
+                if (p.isNear(other.segment(s).start.p))
+                {
+                    p = other.segment(s).start.p;
+                }
+            }
+        }
+    }
+
+
+    /// A point on the piece between from and to, in double so that even a
+    /// tiny piece gets a point strictly between its ends. For an arc, the
+    /// middle of the chord is pushed out to the ellipse from its center.
+    template <typename T>
+    void
+    midpoint(const BasicGenericShapeElement<T>* parent,
+             typename BasicSegment<T>::ElementKind kind,
+             const BasicPoint2D<T>& from, const BasicPoint2D<T>& to,
+             double& x, double& y)
+    {
+        x = 0.5 * ((double)from.x + to.x);
+        y = 0.5 * ((double)from.y + to.y);
+        if (kind == BasicSegment<T>::ArcElement)
+        {
+            const BasicGenericEllipse<T>* e =
+                static_cast<const BasicGenericArc<T>*>(parent)->ellipse();
+            const BasicPoint2D<T>& c = e->center();
+            const BasicPoint2D<T>& r = e->radius();
+            double dx = x - c.x;
+            double dy = y - c.y;
+            double scale = 1. / std::sqrt(dx * dx / ((double)r.x * r.x)
+                                          + dy * dy / ((double)r.y * r.y));
+            x = c.x + dx * scale;
+            y = c.y + dy * scale;
+        }
+    }
+
+
+    /// Whether (x, y), not on the outline of s, is inside s. Instead of
+    /// Shape::containsPoint(), which is in T: for lines, the crossings
+    /// of a ray to the right are counted by the exact orient2d(), so only
+    /// the rounding of (x, y) counts; an ellipse is tested in double.
+    template <typename T>
+    bool
+    containsPoint(const BasicShape<T>* s, double x, double y)
+    {
+        if (s->type() == ShapeTypes::TEllipse)
+        {
+            const BasicEllipse<T>* e = static_cast<const BasicEllipse<T>*>(s);
+            double dx = (x - e->center().x) / e->radius().x;
+            double dy = (y - e->center().y) / e->radius().y;
+            return dx * dx + dy * dy < 1.;
+        }
+
+        const BasicLineBasedShape<T>* ls =
+            static_cast<const BasicLineBasedShape<T>*>(s);
+        const BasicGenericLine<T>* lines = ls->lines();
+        bool inside = false;
+        for (int i = 0; i != ls->getNumLines(); ++i)
+        {
+            const BasicPoint2D<T>& a = lines[i].p1();
+            const BasicPoint2D<T>& b = lines[i].p2();
+            if ((a.y > y) != (b.y > y))
+            {
+                // The line crosses the ray if (x, y) is on its left going
+                // up, or on its right going down
+                double o = orient2d(a.x, a.y, b.x, b.y, x, y);
+                if ((o > 0.) == (b.y > a.y))
+                {
+                    inside = !inside;
+                }
+            }
+        }
+        return inside;
+    }
+
+}
+
+
+template <typename T>
+BasicShapeClipper<T>::BasicShapeClipper()
+{}
+
+
+template <typename T>
+BasicShapeClipper<T>::~BasicShapeClipper()
+{}
+
+
+template <typename T>
+const BasicPoint2D<T>&
+BasicShapeClipper<T>::Piece::head() const
+{
+    return reversed ? to : from;
+}
+
+
+template <typename T>
+const BasicPoint2D<T>&
+BasicShapeClipper<T>::Piece::tail() const
+{
+    return reversed ? from : to;
+}
+
+
+template <typename T>
+size_t
+BasicShapeClipper<T>::clip(const Shape* a, const Shape* b, Operation op,
+                           ClipResult& result)
+{
+    result.clear();
+
+    // Shapes apart have nothing in common
+    bool disjoint = !a->bb().overlaps(b->bb());
+    if (disjoint && op == Intersection)
+    {
+        return 0;
+    }
+
+    // The outlines of the last operation are released with the arena; the
+    // outlines themselves are owned here, as the intersection may throw
+    arena_.reset();
+    std::unique_ptr<SegmentedShape> outlineA(a->toSegmentedShape(&arena_));
+    std::unique_ptr<SegmentedShape> outlineB(b->toSegmentedShape(&arena_));
+
+    if (!disjoint)
+    {
+        // The points are on elements of a, then of b; b gets them the other
+        // way round
+        points_.clear();
+        int isecCount = 0;
+        a->isIntersectedBy(b, points_, isecCount);
+        if (a->type() == ShapeTypes::TEllipse
+            || b->type() == ShapeTypes::TEllipse)
+        {
+            snapToVertices(points_, *outlineA, *outlineB);
+        }
+
+        otherPoints_.clear();
+        for (size_t i = 0; i != points_.size(); ++i)
+        {
+            const BasicSegmentPoint<T>& p = points_[i];
+            otherPoints_.push_back(
+                BasicSegmentPoint<T>(p.p, p.t2, p.parent2, p.t, p.parent));
+        }
+
+        outlineA->addIntersections(points_);
+        outlineB->addIntersections(otherPoints_);
+    }
+
+    double senseA = senseOf(*outlineA);
+    double senseB = senseOf(*outlineB);
+
+    pieces_.clear();
+    addPieces(*outlineA, senseA, 0, b, senseB, disjoint, op);
+    addPieces(*outlineB, senseB, 1, a, senseA, disjoint, op);
+
+    buildRings(result);
+    return result.numRings();
+}
+
+
+template <typename T>
+int
+BasicShapeClipper<T>::keepDirection(Operation op, int shape, Location location)
+{
+    switch (op)
+    {
+    case Intersection:
+        return location == Inside || (location == SameOutline && shape == 0);
+
+    case Union:
+        return location == Outside || (location == SameOutline && shape == 0);
+
+    case Difference:
+        if (shape == 0)
+        {
+            return location == Outside || location == OppositeOutline;
+        }
+        return location == Inside ? -1 : 0;
+
+    case Xor:
+        return location == Outside ? 1 : (location == Inside ? -1 : 0);
+    }
+    return 0;
+}
+
+
+template <typename T>
+void
+BasicShapeClipper<T>::addPieces(const SegmentedShape& outline,
+                                double sense,
+                                int shape,
+                                const Shape* other,
+                                double otherSense,
+                                bool disjoint,
+                                Operation op)
+{
+    for (size_t i = 0; i != outline.numSegments(); ++i)
+    {
+        const Segment& segm = outline.segment(i);
+        const Segment& next = outline.segment(segm.next);
+
+        // Intersections at the end points of elements split off nothing
+        if (samePoint(segm.start.p, next.start.p))
+        {
+            continue;
+        }
+
+        Piece piece;
+        piece.from = segm.start.p;
+        piece.to = next.start.p;
+        piece.tFrom = segm.start.t;
+        piece.tTo = next.start.parent == segm.start.parent ? next.start.t : 1;
+        piece.parent = segm.start.parent;
+        piece.kind = segm.kind;
+        piece.shape = shape;
+        piece.used = false;
+
+        Location location =
+            locate(piece, sense, other, otherSense, disjoint);
+        int direction = keepDirection(op, shape, location);
+        if (direction == 0)
+        {
+            continue;
+        }
+
+        // Kept along the outline means counterclockwise
+        piece.reversed = direction * sense < 0.;
+        pieces_.push_back(piece);
+    }
+}
+
+
+template <typename T>
+typename BasicShapeClipper<T>::Location
+BasicShapeClipper<T>::locate(const Piece& piece,
+                             double sense,
+                             const Shape* other,
+                             double otherSense,
+                             bool disjoint) const
+{
+    if (disjoint)
+    {
+        return Outside;
+    }
+
+    if (piece.kind == Segment::LineElement
+        && other->type() != ShapeTypes::TEllipse)
+    {
+        // Decided exactly: the end points of an overlapping stretch are
+        // those of the lines, not computed ones
+        const BasicLineBasedShape<T>* s =
+            static_cast<const BasicLineBasedShape<T>*>(other);
+        const BasicGenericLine<T>* lines = s->lines();
+        for (int i = 0; i != s->getNumLines(); ++i)
+        {
+            const Point& p1 = lines[i].p1();
+            const Point& p2 = lines[i].p2();
+            if (orientation(p1, p2, piece.from) == 0
+                && orientation(p1, p2, piece.to) == 0
+                && withinCollinear(p1, p2, piece.from)
+                && withinCollinear(p1, p2, piece.to))
+            {
+                double along = dot(piece.to - piece.from, p2 - p1)
+                    * sense * otherSense;
+                return along > 0. ? SameOutline : OppositeOutline;
+            }
+        }
+    }
+    else if (piece.kind == Segment::ArcElement
+             && other->type() == ShapeTypes::TEllipse)
+    {
+        // Both outlines run clockwise, see Ellipse::toSegmentedShape()
+        const BasicGenericEllipse<T>* e =
+            static_cast<const BasicGenericArc<T>*>(piece.parent)->ellipse();
+        const BasicEllipse<T>* o = static_cast<const BasicEllipse<T>*>(other);
+        if (e->center() == o->center() && e->radius() == o->radius())
+        {
+            return SameOutline;
+        }
+    }
+
+    double x, y;
+    midpoint(piece.parent, piece.kind, piece.from, piece.to, x, y);
+    const BasicAABox<T>& bb = other->bb();
+    if (x < bb.minX || x > bb.maxX || y < bb.minY || y > bb.maxY)
+    {
+        return Outside;
+    }
+    return containsPoint(other, x, y) ? Inside : Outside;
+}
+
+
+template <typename T>
+int
+BasicShapeClipper<T>::successor(const Piece& piece) const
+{
+    const Point& tail = piece.tail();
+    std::vector<int>::const_iterator it = std::lower_bound(
+        byHead_.begin(), byHead_.end(), tail,
+        [this](int i, const Point& p)
+        {
+            return pointLess(pieces_[i].head(), p);
+        });
+
+    // Crossing outlines leave one piece to go on with; touching ones leave
+    // two, and going on along the same outline keeps the rings apart
+    int found = -1;
+    for (; it != byHead_.end() && samePoint(pieces_[*it].head(), tail); ++it)
+    {
+        const Piece& candidate = pieces_[*it];
+        if (candidate.used)
+        {
+            continue;
+        }
+        if (candidate.shape == piece.shape)
+        {
+            return *it;
+        }
+        if (found < 0)
+        {
+            found = *it;
+        }
+    }
+    return found;
+}
+
+
+template <typename T>
+void
+BasicShapeClipper<T>::buildRings(ClipResult& result)
+{
+    byHead_.resize(pieces_.size());
+    for (size_t i = 0; i != pieces_.size(); ++i)
+    {
+        byHead_[i] = (int)i;
+    }
+    std::sort(byHead_.begin(), byHead_.end(),
+              [this](int i, int j)
+              {
+                  return pointLess(pieces_[i].head(), pieces_[j].head());
+              });
+
+    for (size_t first = 0; first != pieces_.size(); ++first)
+    {
+        if (pieces_[first].used)
+        {
+            continue;
+        }
+
+        // A chain that does not come back to its start, due to rounding, is
+        // closed all the same
+        int p = (int)first;
+        while (p >= 0 && !pieces_[p].used)
+        {
+            Piece& piece = pieces_[p];
+            piece.used = true;
+
+            Segment segm =
+            {
+                BasicSegmentPoint<T>(piece.head(),
+                                     piece.reversed ? piece.tTo : piece.tFrom,
+                                     piece.parent),
+                0,
+                piece.reversed ? Segment::Negative : Segment::Positive,
+                piece.kind
+            };
+            result.addSegment(segm);
+
+            p = successor(piece);
+        }
+        result.endRing();
+    }
+}
+
+
+template class BasicShapeClipper<float>;
+template class BasicShapeClipper<double>;
+
+
+} // namespace geom
@@ -0,0 +1,430 @@
+#include "ShapeDispatch.h"
+
+#include <algorithm>
+
+#include "Ellipse.h"
+#include "GenericLine.h"
+#include "GeometryExceptions.h"
+#include "Rectangle.h"
+#include "Triangle.h"
+
+
+namespace geom
+{
+
+
+namespace
+{
+
+    const int numTypes = ShapeTypes::NumShapeTypes;
+
+    const int numCombinations = numTypes * numTypes;
+
+
+    /// The class of each shape type, in T
+    template <int ShapeType, typename T>
+    struct ShapeClass;
+
+    template <typename T>
+    struct ShapeClass<ShapeTypes::TRectangle, T>
+    {
+        typedef BasicRectangle<T> Type;
+    };
+
+    template <typename T>
+    struct ShapeClass<ShapeTypes::TTriangle, T>
+    {
+        typedef BasicTriangle<T> Type;
+    };
+
+    template <typename T>
+    struct ShapeClass<ShapeTypes::TEllipse, T>
+    {
+        typedef BasicEllipse<T> Type;
+    };
+
+
+    // The kernels, by overloading on the concrete classes: the generic one is
+    // for two line-based shapes, the more specialised ones for ellipses. The
+    // order of the arguments is kept, so parent is always on the first shape
+    // and parent2 on the second.
+
+    template <typename T, typename A, typename B>
+    inline bool
+    intersectPair(const A* a,
+                  const B* b,
+                  BasicSegmentPointVector<T>& isecPoints,
+                  int& isecCount)
+    {
+        if (!a->bb().overlaps(b->bb()))
+        {
+            isecCount = 0;
+            return false;
+        }
+
+        return BasicGenericLine<T>::areIntersectedBy(
+            a->lines(), A::NumLines, b->lines(), B::NumLines,
+            isecPoints, isecCount);
+    }
+
+
+    template <typename T, typename A>
+    inline bool
+    intersectPair(const A* a,
+                  const BasicEllipse<T>* e,
+                  BasicSegmentPointVector<T>& isecPoints,
+                  int& isecCount)
+    {
+        if (!a->bb().overlaps(e->bb()))
+        {
+            isecCount = 0;
+            return false;
+        }
+
+        return e->intersects(a->lines(), A::NumLines, isecPoints, isecCount);
+    }
+
+
+    template <typename T, typename B>
+    inline bool
+    intersectPair(const BasicEllipse<T>* e,
+                  const B* b,
+                  BasicSegmentPointVector<T>& isecPoints,
+                  int& isecCount)
+    {
+        // Cleans the shape part of e as well, which the ellipse part relies
+        // on (see Ellipse::markDirty())
+        if (!e->bb().overlaps(b->bb()))
+        {
+            isecCount = 0;
+            return false;
+        }
+
+        return e->BasicGenericEllipse<T>::isIntersectedBy(
+            b->lines(), B::NumLines, isecPoints, isecCount);
+    }
+
+
+    template <typename T>
+    inline bool
+    intersectPair(const BasicEllipse<T>* e,
+                  const BasicEllipse<T>* f,
+                  BasicSegmentPointVector<T>& isecPoints,
+                  int& isecCount)
+    {
+        return e->BasicGenericEllipse<T>::isIntersectedBy(f, isecPoints,
+                                                          isecCount);
+    }
+
+
+    // T is given explicitly, as the counting kernels have no argument in it
+
+    template <typename T, typename A, typename B>
+    inline int
+    countPair(const A* a, const B* b, bool stopAtFirst)
+    {
+        if (!a->bb().overlaps(b->bb()))
+        {
+            return 0;
+        }
+
+        typedef BasicGenericLine<T> Line;
+        if (stopAtFirst)
+        {
+            return Line::areIntersectedBy(a->lines(), A::NumLines,
+                                          b->lines(), B::NumLines);
+        }
+        return Line::countIntersections(a->lines(), A::NumLines,
+                                        b->lines(), B::NumLines);
+    }
+
+
+    template <typename T, typename A>
+    inline int
+    countPair(const A* a, const BasicEllipse<T>* e, bool stopAtFirst)
+    {
+        if (!a->bb().overlaps(e->bb()))
+        {
+            return 0;
+        }
+
+        typedef BasicGenericEllipse<T> GenericEllipse;
+        if (stopAtFirst)
+        {
+            return e->GenericEllipse::isIntersectedBy(a->lines(), A::NumLines);
+        }
+        return e->GenericEllipse::countIntersections(a->lines(), A::NumLines);
+    }
+
+
+    template <typename T, typename B>
+    inline int
+    countPair(const BasicEllipse<T>* e, const B* b, bool stopAtFirst)
+    {
+        if (!e->bb().overlaps(b->bb()))
+        {
+            return 0;
+        }
+
+        typedef BasicGenericEllipse<T> GenericEllipse;
+        if (stopAtFirst)
+        {
+            return e->GenericEllipse::isIntersectedBy(b->lines(), B::NumLines);
+        }
+        return e->GenericEllipse::countIntersections(b->lines(), B::NumLines);
+    }
+
+
+    template <typename T>
+    inline int
+    countPair(const BasicEllipse<T>* e,
+              const BasicEllipse<T>* f,
+              bool stopAtFirst)
+    {
+        typedef BasicGenericEllipse<T> GenericEllipse;
+        if (stopAtFirst)
+        {
+            return e->GenericEllipse::isIntersectedBy(f);
+        }
+        return e->GenericEllipse::countIntersections(f);
+    }
+
+
+    // The table entries: the kernels behind the common signatures
+
+    template <typename T, int TypeA, int TypeB>
+    bool
+    intersectAs(const BasicShape<T>* a,
+                const BasicShape<T>* b,
+                BasicSegmentPointVector<T>& isecPoints,
+                int& isecCount)
+    {
+        typedef typename ShapeClass<TypeA, T>::Type A;
+        typedef typename ShapeClass<TypeB, T>::Type B;
+        return intersectPair(static_cast<const A*>(a),
+                             static_cast<const B*>(b),
+                             isecPoints, isecCount);
+    }
+
+
+    template <typename T, int TypeA, int TypeB>
+    int
+    countAs(const BasicShape<T>* a, const BasicShape<T>* b, bool stopAtFirst)
+    {
+        typedef typename ShapeClass<TypeA, T>::Type A;
+        typedef typename ShapeClass<TypeB, T>::Type B;
+        return countPair<T>(static_cast<const A*>(a),
+                            static_cast<const B*>(b),
+                            stopAtFirst);
+    }
+
+
+    /// Runs pairs of shapes of types TypeA and TypeB through their kernel,
+    /// see ShapeDispatch::findIntersections()
+    template <typename T, int TypeA, int TypeB>
+    int
+    findAs(const BasicShapePair<T>* pairs,
+           size_t numPairs,
+           std::vector<BasicShapePair<T> >& intersecting,
+           BasicSegmentPointVector<T>& isecPoints,
+           int* numFailed)
+    {
+        typedef typename ShapeClass<TypeA, T>::Type A;
+        typedef typename ShapeClass<TypeB, T>::Type B;
+        int found = 0;
+        for (size_t i = 0; i != numPairs; ++i)
+        {
+            const size_t numPoints = isecPoints.size();
+            int isecCount = 0;
+            bool intersects;
+            try
+            {
+                intersects =
+                    intersectPair(static_cast<const A*>(pairs[i].first),
+                                  static_cast<const B*>(pairs[i].second),
+                                  isecPoints, isecCount);
+            }
+            catch (const error::GeometryError&)
+            {
+                if (!numFailed)
+                {
+                    throw;
+                }
+                isecPoints.erase(isecPoints.begin() + numPoints,
+                                 isecPoints.end());
+                ++*numFailed;
+                continue;
+            }
+
+            if (intersects)
+            {
+                intersecting.push_back(pairs[i]);
+                ++found;
+            }
+        }
+        return found;
+    }
+
+
+    /// The sequence of integers Is
+    template <int... Is>
+    struct Indices
+    {};
+
+    /// Indices<0, ..., N - 1>, as Type
+    template <int N, int... Is>
+    struct MakeIndices : MakeIndices<N - 1, N - 1, Is...>
+    {};
+
+    template <int... Is>
+    struct MakeIndices<0, Is...>
+    {
+        typedef Indices<Is...> Type;
+    };
+
+
+    /// The functions of all combinations of types, for shapes in T; entry
+    /// a * numTypes + b is the one for a first shape of type a and a second
+    /// one of type b
+    template <typename T, typename Combinations>
+    struct Tables;
+
+    template <typename T, int... Is>
+    struct Tables<T, Indices<Is...> >
+    {
+        typedef BasicShapeDispatch<T> Dispatch;
+
+        typedef int (*FindFunc)(const BasicShapePair<T>* pairs,
+                                size_t numPairs,
+                                std::vector<BasicShapePair<T> >& intersecting,
+                                BasicSegmentPointVector<T>& isecPoints,
+                                int* numFailed);
+
+        static const typename Dispatch::IntersectFunc
+            intersect[sizeof...(Is)];
+
+        static const typename Dispatch::CountFunc count[sizeof...(Is)];
+
+        static const FindFunc find[sizeof...(Is)];
+    };
+
+    template <typename T, int... Is>
+    const typename BasicShapeDispatch<T>::IntersectFunc
+    Tables<T, Indices<Is...> >::intersect[sizeof...(Is)] =
+        { &intersectAs<T, Is / numTypes, Is % numTypes>... };
+
+    template <typename T, int... Is>
+    const typename BasicShapeDispatch<T>::CountFunc
+    Tables<T, Indices<Is...> >::count[sizeof...(Is)] =
+        { &countAs<T, Is / numTypes, Is % numTypes>... };
+
+    template <typename T, int... Is>
+    const typename Tables<T, Indices<Is...> >::FindFunc
+    Tables<T, Indices<Is...> >::find[sizeof...(Is)] =
+        { &findAs<T, Is / numTypes, Is % numTypes>... };
+
+
+    /// The tables for shapes in T
+    template <typename T>
+    struct PairTables : Tables<T, MakeIndices<numCombinations>::Type>
+    {};
+
+
+    template <typename T>
+    inline int
+    combinationOf(const BasicShapePair<T>& pair)
+    {
+        return pair.first->type() * numTypes + pair.second->type();
+    }
+
+
+    /// Groups pairs in place by a counting sort on the combination of types,
+    /// moving each pair along the cycle of the places it displaces; ends[c]
+    /// is set past the last pair of combination c
+    template <typename T>
+    void
+    groupPairs(BasicShapePair<T>* pairs, size_t numPairs, size_t ends[])
+    {
+        size_t next[numCombinations];
+        std::fill(ends, ends + numCombinations, 0);
+        for (size_t i = 0; i != numPairs; ++i)
+        {
+            ++ends[combinationOf(pairs[i])];
+        }
+        size_t begin = 0;
+        for (int c = 0; c != numCombinations; ++c)
+        {
+            next[c] = begin;
+            begin += ends[c];
+            ends[c] = begin;
+        }
+
+        for (int c = 0; c != numCombinations; ++c)
+        {
+            while (next[c] != ends[c])
+            {
+                BasicShapePair<T> pair = pairs[next[c]];
+                int combination = combinationOf(pair);
+                while (combination != c)
+                {
+                    std::swap(pair, pairs[next[combination]++]);
+                    combination = combinationOf(pair);
+                }
+                pairs[next[c]++] = pair;
+            }
+        }
+    }
+
+}
+
+
+template <typename T>
+const typename BasicShapeDispatch<T>::IntersectFunc* const
+BasicShapeDispatch<T>::intersectTable_ = PairTables<T>::intersect;
+
+template <typename T>
+const typename BasicShapeDispatch<T>::CountFunc* const
+BasicShapeDispatch<T>::countTable_ = PairTables<T>::count;
+
+
+template <typename T>
+void
+BasicShapeDispatch<T>::groupByTypes(ShapePair* pairs, size_t numPairs)
+{
+    size_t ends[numCombinations];
+    groupPairs(pairs, numPairs, ends);
+}
+
+
+template <typename T>
+int
+BasicShapeDispatch<T>::findIntersections(ShapePair* pairs,
+                                         size_t numPairs,
+                                         std::vector<ShapePair>& intersecting,
+                                         PointVector& isecPoints,
+                                         int* numFailed)
+{
+    size_t ends[numCombinations];
+    groupPairs(pairs, numPairs, ends);
+
+    int found = 0;
+    size_t begin = 0;
+    for (int c = 0; c != numCombinations; ++c)
+    {
+        if (ends[c] != begin)
+        {
+            found += PairTables<T>::find[c](pairs + begin, ends[c] - begin,
+                                            intersecting, isecPoints,
+                                            numFailed);
+        }
+        begin = ends[c];
+    }
+    return found;
+}
+
+
+template class BasicShapeDispatch<float>;
+template class BasicShapeDispatch<double>;
+
+
+} // namespace geom
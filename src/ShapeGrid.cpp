@@ -0,0 +1,377 @@
+#include "ShapeGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GeometryExceptions.h"
+
+namespace geom
+{
+
+
+namespace
+{
+
+    const size_t minBuckets = 64;
+
+}
+
+
+template <typename T>
+BasicShapeGrid<T>::BasicShapeGrid(T cellSize)
+:   Dirtable(true),
+    requestedCellSize_(cellSize),
+    cellSize_(cellSize),
+    invCellSize_(cellSize > 0 ? 1 / cellSize : 0),
+    count_(0)
+{}
+
+
+template <typename T>
+BasicShapeGrid<T>::~BasicShapeGrid()
+{}
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::performCleaning() const
+{
+    if (requestedCellSize_ > 0)
+    {
+        cellSize_ = requestedCellSize_;
+    }
+    else
+    {
+        // Twice the mean of the larger box extent, so a shape of average size
+        // covers at most 2x2 cells and a larger one rarely more than 3x3
+        double extentSum = 0.;
+        for (size_t i = 0; i != entries_.size(); ++i)
+        {
+            if (entries_[i].inUse)
+            {
+                const AABox& b = entries_[i].box;
+                extentSum += std::max(b.maxX - b.minX, b.maxY - b.minY);
+            }
+        }
+
+        cellSize_ = (count_ && extentSum > 0.)
+            ? (T)(2. * extentSum / count_) : 1;
+    }
+    invCellSize_ = 1 / cellSize_;
+
+    // About two buckets per shape, as a power of two for cheap hashing
+    size_t numBuckets = minBuckets;
+    while (numBuckets < 2 * (size_t)count_)
+    {
+        numBuckets *= 2;
+    }
+
+    // Keep the bucket vectors (and their capacity) if the size fits
+    if (buckets_.size() != numBuckets)
+    {
+        buckets_.assign(numBuckets, std::vector<int>());
+    }
+    else
+    {
+        for (size_t i = 0; i != buckets_.size(); ++i)
+        {
+            buckets_[i].clear();
+        }
+    }
+
+    for (size_t i = 0; i != entries_.size(); ++i)
+    {
+        if (entries_[i].inUse)
+        {
+            cellRange(entries_[i].box, entries_[i].cells);
+            addToBuckets((int)i);
+        }
+    }
+}
+
+
+template <typename T>
+int
+BasicShapeGrid<T>::insert(const Shape* shape)
+{
+    int handle;
+    if (!freeHandles_.empty())
+    {
+        handle = freeHandles_.back();
+        freeHandles_.pop_back();
+    }
+    else
+    {
+        handle = (int)entries_.size();
+        entries_.push_back(Entry());
+    }
+
+    Entry& e = entries_[handle];
+    e.shape = shape;
+    e.inUse = true;
+    e.generation = shape->generation();
+    e.box = shape->bb();
+    ++count_;
+
+    if (2 * (size_t)count_ > buckets_.size())
+    {
+        // Table too small, re-bin everything on the next query
+        markDirty();
+    }
+    else if (!isDirty())
+    {
+        cellRange(e.box, e.cells);
+        addToBuckets(handle);
+    }
+
+    return handle;
+}
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::remove(int handle)
+{
+    if (handle < 0 || handle >= (int)entries_.size() || !entries_[handle].inUse)
+    {
+        throw error::GeometryError("ShapeGrid::remove: invalid handle");
+    }
+
+    if (!isDirty())
+    {
+        removeFromBuckets(handle);
+    }
+
+    entries_[handle].inUse = false;
+    entries_[handle].shape = 0;
+    freeHandles_.push_back(handle);
+    --count_;
+}
+
+
+template <typename T>
+bool
+BasicShapeGrid<T>::update(int handle)
+{
+    Entry& e = entries_[handle];
+
+    const unsigned long generation = e.shape->generation();
+    if (generation == e.generation)
+    {
+        return false;
+    }
+    e.generation = generation;
+    e.box = e.shape->bb();
+
+    if (isDirty())
+    {
+        // Will be binned from scratch anyway
+        return false;
+    }
+
+    CellRange cells;
+    cellRange(e.box, cells);
+
+    if (cells.minX == e.cells.minX && cells.minY == e.cells.minY
+        && cells.maxX == e.cells.maxX && cells.maxY == e.cells.maxY)
+    {
+        return false;
+    }
+
+    removeFromBuckets(handle);
+    e.cells = cells;
+    addToBuckets(handle);
+
+    return true;
+}
+
+
+template <typename T>
+int
+BasicShapeGrid<T>::update()
+{
+    int moved = 0;
+
+    for (size_t i = 0; i != entries_.size(); ++i)
+    {
+        if (entries_[i].inUse && update((int)i))
+        {
+            ++moved;
+        }
+    }
+
+    return moved;
+}
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::rebuild(T cellSize)
+{
+    requestedCellSize_ = cellSize;
+    markDirty();
+}
+
+
+template <typename T>
+const BasicShape<T>*
+BasicShapeGrid<T>::shape(int handle) const
+{
+    return entries_[handle].shape;
+}
+
+
+template <typename T>
+int
+BasicShapeGrid<T>::size() const
+{
+    return count_;
+}
+
+
+template <typename T>
+MAKE_GETTER(T BasicShapeGrid<T>::cellSize() const, cellSize_)
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::findPairs(std::vector<ShapePair>& pairs) const
+{
+    CLEAN_IF_DIRTY(this);
+
+    for (size_t b = 0; b != buckets_.size(); ++b)
+    {
+        const std::vector<int>& handles = buckets_[b];
+
+        for (size_t i = 0; i < handles.size(); ++i)
+        {
+            const Entry& e1 = entries_[handles[i]];
+
+            for (size_t j = i + 1; j < handles.size(); ++j)
+            {
+                const Entry& e2 = entries_[handles[j]];
+
+                if (!e1.box.overlaps(e2.box))
+                {
+                    continue;
+                }
+
+                // Two overlapping shapes share all cells covered by the
+                // lower left corner of their overlap; only report the pair in
+                // the bucket of that cell so it is found exactly once
+                int cx = std::max(e1.cells.minX, e2.cells.minX);
+                int cy = std::max(e1.cells.minY, e2.cells.minY);
+                if (bucket(cx, cy) == b)
+                {
+                    pairs.push_back(ShapePair(e1.shape, e2.shape));
+                }
+            }
+        }
+    }
+}
+
+
+template <typename T>
+int
+BasicShapeGrid<T>::findIntersections(
+    std::vector<ShapePair>& pairs, SegmentPointVector& isecPoints) const
+{
+    std::vector<ShapePair> candidates;
+    findPairs(candidates);
+
+    int numIntersecting = 0;
+    for (size_t i = 0; i != candidates.size(); ++i)
+    {
+        int count = 0;
+        if (candidates[i].first->isIntersectedBy(
+                candidates[i].second, isecPoints, count))
+        {
+            pairs.push_back(candidates[i]);
+            ++numIntersecting;
+        }
+    }
+
+    return numIntersecting;
+}
+
+
+
+
+template <typename T>
+int
+BasicShapeGrid<T>::cellCoord(T v) const
+{
+    return (int)std::floor(v * invCellSize_);
+}
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::cellRange(const AABox& box, CellRange& range) const
+{
+    range.minX = cellCoord(box.minX);
+    range.minY = cellCoord(box.minY);
+    range.maxX = cellCoord(box.maxX);
+    range.maxY = cellCoord(box.maxY);
+}
+
+
+template <typename T>
+size_t
+BasicShapeGrid<T>::bucket(int cx, int cy) const
+{
+    unsigned int h = ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+    return h & (buckets_.size() - 1);
+}
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::addToBuckets(int handle) const
+{
+    const CellRange& r = entries_[handle].cells;
+
+    for (int cy = r.minY; cy <= r.maxY; ++cy)
+    {
+        for (int cx = r.minX; cx <= r.maxX; ++cx)
+        {
+            // Several cells of one shape may hash to the same bucket; keep a
+            // single entry there so pairs are not reported twice
+            std::vector<int>& handles = buckets_[bucket(cx, cy)];
+            if (std::find(handles.begin(), handles.end(), handle) == handles.end())
+            {
+                handles.push_back(handle);
+            }
+        }
+    }
+}
+
+
+template <typename T>
+void
+BasicShapeGrid<T>::removeFromBuckets(int handle) const
+{
+    const CellRange& r = entries_[handle].cells;
+
+    for (int cy = r.minY; cy <= r.maxY; ++cy)
+    {
+        for (int cx = r.minX; cx <= r.maxX; ++cx)
+        {
+            std::vector<int>& handles = buckets_[bucket(cx, cy)];
+            std::vector<int>::iterator it =
+                std::find(handles.begin(), handles.end(), handle);
+            if (it != handles.end())
+            {
+                *it = handles.back();
+                handles.pop_back();
+            }
+        }
+    }
+}
+
+
+template class BasicShapeGrid<float>;
+template class BasicShapeGrid<double>;
+
+
+} // namespace geom
@@ -0,0 +1,483 @@
+#include "SweepAndPrune.h"
+
+#include <algorithm>
+
+#include "GeometryExceptions.h"
+
+namespace geom
+{
+
+
+namespace
+{
+
+    // Axis 0 is x, axis 1 is y
+    template <typename T>
+    inline T
+    lower(const BasicAABox<T>& box, int axis)
+    {
+        return axis ? box.minY : box.minX;
+    }
+
+
+    template <typename T>
+    inline T
+    upper(const BasicAABox<T>& box, int axis)
+    {
+        return axis ? box.maxY : box.maxX;
+    }
+
+}
+
+
+template <typename T>
+bool
+BasicSweepAndPrune<T>::EndPoint::operator<(const EndPoint& other) const
+{
+    if (value != other.value)
+    {
+        return value < other.value;
+    }
+    return isMin && !other.isMin;
+}
+
+
+template <typename T>
+bool
+BasicSweepAndPrune<T>::PairEvent::operator<(const PairEvent& other) const
+{
+    if (key != other.key)
+    {
+        return key < other.key;
+    }
+    if (pair.first != other.pair.first)
+    {
+        return pair.first < other.pair.first;
+    }
+    return pair.second < other.pair.second;
+}
+
+
+template <typename T>
+BasicSweepAndPrune<T>::BasicSweepAndPrune()
+:   Dirtable(false),
+    count_(0)
+{}
+
+
+template <typename T>
+BasicSweepAndPrune<T>::~BasicSweepAndPrune()
+{}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::performCleaning() const
+{
+    if (pending_.empty())
+    {
+        return;
+    }
+
+    // Sort the new end points and merge them into the sorted lists
+    for (int axis = 0; axis != 2; ++axis)
+    {
+        std::vector<EndPoint> added;
+        added.reserve(2 * pending_.size());
+        for (size_t i = 0; i != pending_.size(); ++i)
+        {
+            const AABox& b = proxies_[pending_[i]].box;
+            EndPoint e = { lower(b, axis), pending_[i], true };
+            added.push_back(e);
+            e.value = upper(b, axis);
+            e.isMin = false;
+            added.push_back(e);
+        }
+        std::sort(added.begin(), added.end());
+
+        std::vector<EndPoint> merged(endPoints_[axis].size() + added.size());
+        std::merge(endPoints_[axis].begin(), endPoints_[axis].end(),
+                   added.begin(), added.end(), merged.begin());
+        endPoints_[axis].swap(merged);
+    }
+
+    // Sweep along x; the boxes in the active lists overlap the current one in
+    // x. Pairs of two already merged proxies are known, so those are skipped.
+    std::vector<bool> isNew(proxies_.size(), false);
+    for (size_t i = 0; i != pending_.size(); ++i)
+    {
+        isNew[pending_[i]] = true;
+    }
+
+    std::vector<int> active[2]; // old, new
+    std::vector<int> activePos(proxies_.size());
+
+    const std::vector<EndPoint>& ep = endPoints_[0];
+    for (size_t i = 0; i != ep.size(); ++i)
+    {
+        const int h = ep[i].handle;
+        std::vector<int>& own = active[isNew[h]];
+
+        if (ep[i].isMin)
+        {
+            for (int a = (isNew[h] ? 0 : 1); a != 2; ++a)
+            {
+                for (size_t k = 0; k != active[a].size(); ++k)
+                {
+                    if (overlaps(h, active[a][k]))
+                    {
+                        addPair(h, active[a][k]);
+                    }
+                }
+            }
+            activePos[h] = (int)own.size();
+            own.push_back(h);
+        }
+        else
+        {
+            int last = own.back();
+            own[activePos[h]] = last;
+            activePos[last] = activePos[h];
+            own.pop_back();
+        }
+    }
+
+    pending_.clear();
+}
+
+
+template <typename T>
+int
+BasicSweepAndPrune<T>::insert(const Shape* shape)
+{
+    int handle;
+    if (!freeHandles_.empty())
+    {
+        handle = freeHandles_.back();
+        freeHandles_.pop_back();
+    }
+    else
+    {
+        handle = (int)proxies_.size();
+        proxies_.push_back(Proxy());
+    }
+
+    Proxy& p = proxies_[handle];
+    p.shape = shape;
+    p.inUse = true;
+    p.generation = shape->generation();
+    p.box = shape->bb();
+    ++count_;
+
+    pending_.push_back(handle);
+    markDirty();
+
+    return handle;
+}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::remove(int handle)
+{
+    if (handle < 0 || handle >= (int)proxies_.size() || !proxies_[handle].inUse)
+    {
+        throw error::GeometryError("SweepAndPrune::remove: invalid handle");
+    }
+
+    std::vector<int>::iterator pendingIt =
+        std::find(pending_.begin(), pending_.end(), handle);
+    if (pendingIt != pending_.end())
+    {
+        // Not merged yet, so there are neither end points nor pairs
+        pending_.erase(pendingIt);
+        proxies_[handle].inUse = false;
+        proxies_[handle].shape = 0;
+        freeHandles_.push_back(handle);
+        --count_;
+        return;
+    }
+
+    for (int axis = 0; axis != 2; ++axis)
+    {
+        std::vector<EndPoint>& ep = endPoints_[axis];
+        size_t j = 0;
+        for (size_t i = 0; i != ep.size(); ++i)
+        {
+            if (ep[i].handle != handle)
+            {
+                ep[j++] = ep[i];
+            }
+        }
+        ep.resize(j);
+    }
+
+    // Collect first, removePair() modifies the set
+    std::vector<PairKey> keys;
+    for (std::set<PairKey>::const_iterator i = pairs_.begin(); i != pairs_.end(); ++i)
+    {
+        if ((int)(*i >> 32) == handle || (int)(*i & 0xFFFFFFFFu) == handle)
+        {
+            keys.push_back(*i);
+        }
+    }
+    for (size_t i = 0; i != keys.size(); ++i)
+    {
+        removePair((int)(keys[i] >> 32), (int)(keys[i] & 0xFFFFFFFFu));
+    }
+
+    proxies_[handle].inUse = false;
+    proxies_[handle].shape = 0;
+    freeHandles_.push_back(handle);
+    --count_;
+}
+
+
+template <typename T>
+int
+BasicSweepAndPrune<T>::update()
+{
+    // Only shapes changed since the last update need their box fetched; if
+    // none did, the end points are still sorted
+    int numChanged = 0;
+    for (size_t i = 0; i != proxies_.size(); ++i)
+    {
+        Proxy& p = proxies_[i];
+        if (p.inUse && p.shape->generation() != p.generation)
+        {
+            p.generation = p.shape->generation();
+            p.box = p.shape->bb();
+            ++numChanged;
+        }
+    }
+
+    for (int axis = 0; numChanged && axis != 2; ++axis)
+    {
+        std::vector<EndPoint>& ep = endPoints_[axis];
+        for (size_t i = 0; i != ep.size(); ++i)
+        {
+            const AABox& b = proxies_[ep[i].handle].box;
+            ep[i].value = ep[i].isMin ? lower(b, axis) : upper(b, axis);
+        }
+        sortAxis(axis);
+    }
+
+    // New shapes are merged with their current boxes
+    CLEAN_IF_DIRTY(this);
+
+    reportEvents();
+
+    return (int)(added_.size() + removed_.size());
+}
+
+
+template <typename T>
+const BasicShape<T>*
+BasicSweepAndPrune<T>::shape(int handle) const
+{
+    return proxies_[handle].shape;
+}
+
+
+template <typename T>
+int
+BasicSweepAndPrune<T>::size() const
+{
+    return count_;
+}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::findPairs(std::vector<ShapePair>& pairs) const
+{
+    CLEAN_IF_DIRTY(this);
+
+    for (std::set<PairKey>::const_iterator i = pairs_.begin(); i != pairs_.end(); ++i)
+    {
+        pairs.push_back(ShapePair(proxies_[*i >> 32].shape,
+                                  proxies_[*i & 0xFFFFFFFFu].shape));
+    }
+}
+
+
+template <typename T>
+const std::vector<BasicShapePair<T> >&
+BasicSweepAndPrune<T>::addedPairs() const
+{
+    return added_;
+}
+
+
+template <typename T>
+const std::vector<BasicShapePair<T> >&
+BasicSweepAndPrune<T>::removedPairs() const
+{
+    return removed_;
+}
+
+
+template <typename T>
+int
+BasicSweepAndPrune<T>::findIntersections(
+    std::vector<ShapePair>& pairs, SegmentPointVector& isecPoints) const
+{
+    std::vector<ShapePair> candidates;
+    findPairs(candidates);
+
+    int numIntersecting = 0;
+    for (size_t i = 0; i != candidates.size(); ++i)
+    {
+        int count = 0;
+        if (candidates[i].first->isIntersectedBy(
+                candidates[i].second, isecPoints, count))
+        {
+            pairs.push_back(candidates[i]);
+            ++numIntersecting;
+        }
+    }
+
+    return numIntersecting;
+}
+
+
+
+template <typename T>
+typename BasicSweepAndPrune<T>::PairKey
+BasicSweepAndPrune<T>::pairKey(int h1, int h2)
+{
+    if (h1 > h2)
+    {
+        std::swap(h1, h2);
+    }
+    return ((PairKey)h1 << 32) | (PairKey)(unsigned int)h2;
+}
+
+
+template <typename T>
+bool
+BasicSweepAndPrune<T>::overlaps(int h1, int h2) const
+{
+    return proxies_[h1].box.overlaps(proxies_[h2].box);
+}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::sortAxis(int axis)
+{
+    std::vector<EndPoint>& ep = endPoints_[axis];
+
+    for (size_t i = 1; i < ep.size(); ++i)
+    {
+        EndPoint e = ep[i];
+        size_t j = i;
+
+        while (j > 0 && e < ep[j - 1])
+        {
+            const EndPoint& prev = ep[j - 1];
+
+            if (e.isMin && !prev.isMin)
+            {
+                // e's box now starts before prev's box ends
+                if (overlaps(e.handle, prev.handle))
+                {
+                    addPair(e.handle, prev.handle);
+                }
+            }
+            else if (!e.isMin && prev.isMin)
+            {
+                // e's box now ends before prev's box starts
+                removePair(e.handle, prev.handle);
+            }
+
+            ep[j] = prev;
+            --j;
+        }
+
+        ep[j] = e;
+    }
+}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::addPair(int h1, int h2) const
+{
+    if (h1 == h2)
+    {
+        return;
+    }
+
+    PairKey key = pairKey(h1, h2);
+    if (pairs_.insert(key).second)
+    {
+        PairEvent ev = { key, ShapePair(proxies_[key >> 32].shape,
+                                        proxies_[key & 0xFFFFFFFFu].shape), 1 };
+        events_.push_back(ev);
+    }
+}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::removePair(int h1, int h2) const
+{
+    if (h1 == h2)
+    {
+        return;
+    }
+
+    PairKey key = pairKey(h1, h2);
+    if (pairs_.erase(key))
+    {
+        PairEvent ev = { key, ShapePair(proxies_[key >> 32].shape,
+                                        proxies_[key & 0xFFFFFFFFu].shape), -1 };
+        events_.push_back(ev);
+    }
+}
+
+
+template <typename T>
+void
+BasicSweepAndPrune<T>::reportEvents()
+{
+    added_.clear();
+    removed_.clear();
+
+    // A pair may have been added and removed again (or vice versa) since the
+    // last update; only the net change is reported
+    std::stable_sort(events_.begin(), events_.end());
+
+    size_t i = 0;
+    while (i != events_.size())
+    {
+        int delta = 0;
+        size_t j = i;
+        while (j != events_.size() && !(events_[i] < events_[j]))
+        {
+            delta += events_[j].delta;
+            ++j;
+        }
+
+        if (delta > 0)
+        {
+            added_.push_back(events_[i].pair);
+        }
+        else if (delta < 0)
+        {
+            removed_.push_back(events_[i].pair);
+        }
+
+        i = j;
+    }
+
+    events_.clear();
+}
+
+
+template class BasicSweepAndPrune<float>;
+template class BasicSweepAndPrune<double>;
+
+
+} // namespace geom
@@ -0,0 +1,217 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace geom
+{
+
+
+ThreadPool::ThreadPool(int numThreads)
+:   generation_(0),
+    busyThreads_(0),
+    stop_(false),
+    body_(0),
+    count_(0),
+    grainSize_(1),
+    errorChunk_(0)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i != numThreads; ++i)
+    {
+        queues_.push_back(new Queue);
+    }
+
+    // Thread 0 is the one calling parallelFor()
+    for (int i = 1; i != numThreads; ++i)
+    {
+        threads_.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+
+    for (size_t i = 0; i != threads_.size(); ++i)
+    {
+        threads_[i].join();
+    }
+
+    for (size_t i = 0; i != queues_.size(); ++i)
+    {
+        delete queues_[i];
+    }
+}
+
+
+int
+ThreadPool::numThreads() const
+{
+    return (int)queues_.size();
+}
+
+
+void
+ThreadPool::parallelFor(std::size_t count, std::size_t grainSize, const Body& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, (std::size_t)1);
+    const std::size_t numChunks = (count + grainSize - 1) / grainSize;
+    const std::size_t numQueues = queues_.size();
+
+    // Contiguous blocks keep neighbouring chunks on the same thread
+    for (std::size_t q = 0; q != numQueues; ++q)
+    {
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        queues_[q]->chunks.clear();
+        for (std::size_t c = q * numChunks / numQueues;
+             c != (q + 1) * numChunks / numQueues; ++c)
+        {
+            queues_[q]->chunks.push_back(c);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        grainSize_ = grainSize;
+        error_ = std::exception_ptr();
+        busyThreads_ = (int)threads_.size();
+        ++generation_;
+    }
+    wakeUp_.notify_all();
+
+    runChunks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (busyThreads_ != 0)
+        {
+            done_.wait(lock);
+        }
+        body_ = 0;
+        std::swap(error, error_);
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+
+void
+ThreadPool::workerLoop(int thread)
+{
+    unsigned long seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_ && generation_ == seen)
+            {
+                wakeUp_.wait(lock);
+            }
+            if (stop_)
+            {
+                return;
+            }
+            seen = generation_;
+        }
+
+        runChunks(thread);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busyThreads_ == 0)
+        {
+            done_.notify_one();
+        }
+    }
+}
+
+
+void
+ThreadPool::runChunks(int thread)
+{
+    std::size_t chunk;
+
+    // No chunks are added while a loop runs, so once all queues are empty
+    // this thread is done
+    while (popChunk(thread, chunk) || stealChunk(thread, chunk))
+    {
+        const std::size_t begin = chunk * grainSize_;
+        const std::size_t end = std::min(begin + grainSize_, count_);
+
+        try
+        {
+            (*body_)(begin, end, thread);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_ || chunk < errorChunk_)
+            {
+                error_ = std::current_exception();
+                errorChunk_ = chunk;
+            }
+        }
+    }
+}
+
+
+bool
+ThreadPool::popChunk(int thread, std::size_t& chunk)
+{
+    Queue& q = *queues_[thread];
+    std::lock_guard<std::mutex> lock(q.mutex);
+
+    if (q.chunks.empty())
+    {
+        return false;
+    }
+
+    chunk = q.chunks.front();
+    q.chunks.pop_front();
+    return true;
+}
+
+
+bool
+ThreadPool::stealChunk(int thread, std::size_t& chunk)
+{
+    const int numQueues = (int)queues_.size();
+
+    for (int i = 1; i != numQueues; ++i)
+    {
+        Queue& q = *queues_[(thread + i) % numQueues];
+        std::lock_guard<std::mutex> lock(q.mutex);
+
+        if (!q.chunks.empty())
+        {
+            chunk = q.chunks.back();
+            q.chunks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+} // namespace geom